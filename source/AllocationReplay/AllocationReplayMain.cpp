@@ -0,0 +1,178 @@
+#include "Memory/AllocationTrace.h"
+#include "Memory/MemoryPage.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Replays allocation traces against every MemoryPage selection method
+// Usage: DBZ_AllocationReplay [trace files...], synthetic traces are used when no file is given
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	constexpr uint32_t locSyntheticPageSize = 64u << 20;
+	constexpr uint32_t locSyntheticLiveBytes = 48u << 20;
+	constexpr uint32_t locSyntheticEventCount = 200000u;
+	constexpr uint32_t locThroughputRunCount = 5u;
+
+	struct SelectionMethodInfo
+	{
+		dbz::MemoryPage::SelectionMethod mySelectionMethod;
+		const char* myName;
+	};
+
+	const SelectionMethodInfo locSelectionMethods[] =
+	{
+		{ dbz::MemoryPage::SelectionMethod::FIRST_FIT, "FIRST_FIT" },
+		{ dbz::MemoryPage::SelectionMethod::BEST_FIT, "BEST_FIT" },
+		{ dbz::MemoryPage::SelectionMethod::TLSF, "TLSF" },
+		{ dbz::MemoryPage::SelectionMethod::BUDDY, "BUDDY" }
+	};
+
+	struct ReplayResult
+	{
+		double myCallsPerSecond = 0.0;
+		double myMedianLatency = 0.0;
+		double myP99Latency = 0.0;
+		// 1 - largest free block / free bytes, 0 when all free memory is in one block.
+		// The largest free block is the TLSF class lower bound for the non buddy pages, so a few percent is rounding
+		double myPeakFragmentation = 0.0;
+		uint64_t myFailedAllocationCount = 0u;
+	};
+
+	// Replays the trace on a new page, calling anAfterCallFn(page) after every Allocate and Free
+	template <typename AFTER_CALL_FN>
+	void Replay(const dbz::AllocationTrace& aTrace, dbz::MemoryPage::SelectionMethod aSelectionMethod, AFTER_CALL_FN anAfterCallFn)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(aTrace.GetPageSize(), aSelectionMethod);
+
+		// Offsets returned by the replayed allocations, the traced ones are meaningless for other allocators
+		std::vector<uint32_t> offsets(aTrace.GetAllocationCount(), UINT32_MAX);
+		for (const dbz::AllocationTrace::Event& event : aTrace.GetEvents())
+		{
+			if (event.myType == dbz::AllocationTrace::Event::Type::ALLOCATE)
+			{
+				offsets[event.myAllocationIndex] = page.Allocate(event.mySize, event.myAlignment);
+				anAfterCallFn(page);
+			}
+			else if (event.myAllocationIndex != UINT32_MAX && offsets[event.myAllocationIndex] != UINT32_MAX)
+			{
+				// Frees of allocations that failed in this replay are skipped
+				page.Free(offsets[event.myAllocationIndex]);
+				offsets[event.myAllocationIndex] = UINT32_MAX;
+				anAfterCallFn(page);
+			}
+		}
+
+		dbz::MemoryPage::Destroy(page);
+	}
+
+	ReplayResult Replay(const dbz::AllocationTrace& aTrace, dbz::MemoryPage::SelectionMethod aSelectionMethod)
+	{
+		ReplayResult result;
+
+		// Throughput without any measuring in between calls, best of a few runs
+		for (uint32_t run = 0u; run < locThroughputRunCount; ++run)
+		{
+			uint64_t callCount = 0u;
+			Clock::time_point start = Clock::now();
+			Replay(aTrace, aSelectionMethod, [&callCount](const dbz::MemoryPage&) { ++callCount; });
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			result.myCallsPerSecond = std::max(result.myCallsPerSecond, callCount / seconds);
+		}
+
+		// Latency and fragmentation are measured on a separate run, timing each call is not free
+		std::vector<double> latencies;
+		latencies.reserve(aTrace.GetEvents().size());
+		dbz::MemoryPage page = dbz::MemoryPage::Create(aTrace.GetPageSize(), aSelectionMethod);
+		std::vector<uint32_t> offsets(aTrace.GetAllocationCount(), UINT32_MAX);
+		for (const dbz::AllocationTrace::Event& event : aTrace.GetEvents())
+		{
+			Clock::time_point start;
+			if (event.myType == dbz::AllocationTrace::Event::Type::ALLOCATE)
+			{
+				start = Clock::now();
+				offsets[event.myAllocationIndex] = page.Allocate(event.mySize, event.myAlignment);
+			}
+			else if (event.myAllocationIndex != UINT32_MAX && offsets[event.myAllocationIndex] != UINT32_MAX)
+			{
+				start = Clock::now();
+				page.Free(offsets[event.myAllocationIndex]);
+				offsets[event.myAllocationIndex] = UINT32_MAX;
+			}
+			else
+			{
+				continue;
+			}
+			latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+
+			dbz::MemoryPageStats stats = page.GetStats();
+			if (stats.myFreeBytes != 0u)
+				result.myPeakFragmentation = std::max(result.myPeakFragmentation, 1.0 - static_cast<double>(stats.myLargestFreeBlockSize) / stats.myFreeBytes);
+		}
+
+		result.myFailedAllocationCount = page.GetStats().myFailedAllocationCount;
+		dbz::MemoryPage::Destroy(page);
+
+		if (latencies.empty() == false)
+		{
+			std::nth_element(latencies.begin(), latencies.begin() + latencies.size() / 2u, latencies.end());
+			result.myMedianLatency = latencies[latencies.size() / 2u];
+			std::nth_element(latencies.begin(), latencies.begin() + latencies.size() * 99u / 100u, latencies.end());
+			result.myP99Latency = latencies[latencies.size() * 99u / 100u];
+		}
+
+		return result;
+	}
+
+	void ReplayAndPrint(const std::string& aName, const dbz::AllocationTrace& aTrace)
+	{
+		std::cout << aName << ": " << aTrace.GetEvents().size() << " events, " << aTrace.GetAllocationCount() << " allocations, page size " << aTrace.GetPageSize() << " bytes\n";
+		std::cout << std::left << std::setw(12) << "Allocator" << std::right << std::setw(16) << "Calls/s" << std::setw(12) << "p50 (ns)" << std::setw(12) << "p99 (ns)"
+			<< std::setw(16) << "Peak frag (%)" << std::setw(16) << "Failed allocs" << "\n";
+
+		for (const SelectionMethodInfo& selectionMethod : locSelectionMethods)
+		{
+			ReplayResult result = Replay(aTrace, selectionMethod.mySelectionMethod);
+			std::cout << std::left << std::setw(12) << selectionMethod.myName << std::right << std::fixed
+				<< std::setw(16) << std::setprecision(0) << result.myCallsPerSecond
+				<< std::setw(12) << std::setprecision(1) << result.myMedianLatency
+				<< std::setw(12) << std::setprecision(1) << result.myP99Latency
+				<< std::setw(16) << std::setprecision(2) << result.myPeakFragmentation * 100.0
+				<< std::setw(16) << result.myFailedAllocationCount << "\n";
+		}
+
+		std::cout << std::endl;
+	}
+}
+
+int main(int anArgumentCount, char** someArguments)
+{
+	if (anArgumentCount <= 1)
+	{
+		ReplayAndPrint("Churn", dbz::AllocationTrace::GenerateChurn(locSyntheticPageSize, locSyntheticLiveBytes, locSyntheticEventCount, 1u));
+		ReplayAndPrint("Stack like", dbz::AllocationTrace::GenerateStackLike(locSyntheticPageSize, locSyntheticLiveBytes, locSyntheticEventCount, 1u));
+		ReplayAndPrint("Bimodal", dbz::AllocationTrace::GenerateBimodal(locSyntheticPageSize, locSyntheticLiveBytes, locSyntheticEventCount, 1u));
+		return 0;
+	}
+
+	int result = 0;
+	for (int i = 1; i < anArgumentCount; ++i)
+	{
+		dbz::AllocationTrace trace;
+		if (dbz::AllocationTrace::Load(someArguments[i], trace) == false)
+		{
+			std::cerr << "Could not load trace " << someArguments[i] << "\n";
+			result = 1;
+			continue;
+		}
+
+		ReplayAndPrint(someArguments[i], trace);
+	}
+
+	return result;
+}
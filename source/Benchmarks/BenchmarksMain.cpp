@@ -0,0 +1,324 @@
+#include "GlobalDefines.h"
+
+#include "Math/Matrix44.h"
+#include "Math/Quaternion.h"
+#include "Math/SIMDVector.h"
+#include "Math/Vector3.h"
+#include "Math/Vector3A.h"
+#include "Math/Vector4.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#if IS_WINDOWS_PLATFORM
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <intrin.h>
+// Stores before it have to happen and loads after it have to be done again
+#define BENCHMARK_CLOBBER_MEMORY() _ReadWriteBarrier()
+#else
+#include <sched.h>
+#define BENCHMARK_CLOBBER_MEMORY() asm volatile("" : : : "memory")
+#endif // IS_WINDOWS_PLATFORM
+
+// Measures the core math operations in ns/op and ops/s
+// Usage: DBZ_Benchmarks [--json file] [--samples count] [name filter]
+// Only benchmarks whose name contains the filter run. Results are printed and, with --json, written to a file to compare between versions
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	// Operands cycle through arrays small enough to stay in L1, so the operations are measured and not the memory
+	constexpr uint32_t locElementCount = 128u;
+	constexpr uint32_t locDefaultSampleCount = 30u;
+	// Long enough for the CPU to leave its idle clocks before the first sample
+	constexpr double locWarmupSeconds = 0.2;
+	// Each sample repeats the operations until it takes at least this long, far above the clock resolution
+	constexpr double locMinimumSampleSeconds = 0.002;
+
+	alignas(32) Matrix44 locMatrices[2][locElementCount];
+	alignas(32) Matrix44 locMatricesOut[locElementCount];
+	alignas(32) Vector4 locVectors[locElementCount];
+	alignas(32) Vector4 locVectorsOut[locElementCount];
+	alignas(32) Quaternion locQuaternions[2][locElementCount];
+	alignas(32) Quaternion locQuaternionsOut[locElementCount];
+	Vector3 locVector3s[2][locElementCount];
+	Vector3 locVector3sOut[locElementCount];
+	alignas(32) Vector3A locVector3As[2][locElementCount];
+	alignas(32) Vector3A locVector3AsOut[locElementCount];
+	alignas(32) float locFloats[4u * locElementCount];
+
+	struct Benchmark
+	{
+		const char* myName;
+		// Runs the operation locElementCount * aRepeatCount times
+		void (*myRunFn)(uint32_t aRepeatCount);
+	};
+
+	struct Result
+	{
+		const char* myName = nullptr;
+		uint64_t myOperationsPerSample = 0u;
+		// Nanoseconds per operation
+		double myMedian = 0.0;
+		double myMean = 0.0;
+		double myStandardDeviation = 0.0;
+		double myMin = 0.0;
+		double myMax = 0.0;
+	};
+
+	// The barrier after every pass keeps the compiler from merging passes, which compute the same results
+	template <typename OPERATION_FN>
+	void Run(uint32_t aRepeatCount, OPERATION_FN anOperationFn)
+	{
+		for (uint32_t repeat = 0u; repeat < aRepeatCount; ++repeat)
+		{
+			for (uint32_t i = 0u; i < locElementCount; ++i)
+				anOperationFn(i);
+			BENCHMARK_CLOBBER_MEMORY();
+		}
+	}
+
+	const Benchmark locBenchmarks[] =
+	{
+		{ "Matrix44 * Matrix44", [](uint32_t aRepeatCount) { Run(aRepeatCount, [](uint32_t i) { locMatricesOut[i] = locMatrices[0][i] * locMatrices[1][i]; }); } },
+		{ "Matrix44 * Vector4", [](uint32_t aRepeatCount) { Run(aRepeatCount, [](uint32_t i) { locVectorsOut[i] = locMatrices[0][i] * locVectors[i]; }); } },
+		{ "Quaternion * Quaternion", [](uint32_t aRepeatCount) { Run(aRepeatCount, [](uint32_t i) { locQuaternionsOut[i] = locQuaternions[0][i] * locQuaternions[1][i]; }); } },
+		{ "Quaternion::GetMatrix", [](uint32_t aRepeatCount) { Run(aRepeatCount, [](uint32_t i) { locMatricesOut[i] = locQuaternions[0][i].GetMatrix(); }); } },
+		{ "Vector3::Normalize", [](uint32_t aRepeatCount) { Run(aRepeatCount, [](uint32_t i) { locVector3sOut[i] = locVector3s[0][i].Normalize(); }); } },
+		{ "Vector3::Cross", [](uint32_t aRepeatCount) { Run(aRepeatCount, [](uint32_t i) { locVector3sOut[i] = locVector3s[0][i].Cross(locVector3s[1][i]); }); } },
+		{ "Vector3A::Normalize", [](uint32_t aRepeatCount) { Run(aRepeatCount, [](uint32_t i) { locVector3AsOut[i] = locVector3As[0][i].Normalize(); }); } },
+		{ "Vector3A::Cross", [](uint32_t aRepeatCount) { Run(aRepeatCount, [](uint32_t i) { locVector3AsOut[i] = locVector3As[0][i].Cross(locVector3As[1][i]); }); } },
+		{ "SIMD::Load(const float*)", [](uint32_t aRepeatCount) { Run(aRepeatCount, [](uint32_t i) { locVectorsOut[i] = SIMD::Load(locFloats + 4u * i); }); } },
+		{ "SIMD::Load(x, y, z, w)", [](uint32_t aRepeatCount)
+			{
+				Run(aRepeatCount, [](uint32_t i) { locVectorsOut[i] = SIMD::Load(locFloats[i], locFloats[i + 1u], locFloats[i + 2u], locFloats[i + 3u]); });
+			}
+		}
+	};
+
+	float RandomFloat()
+	{
+		return static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0f - 1.0f;
+	}
+
+	void InitializeOperands()
+	{
+		for (uint32_t i = 0u; i < locElementCount; ++i)
+		{
+			for (uint32_t j = 0u; j < 2u; ++j)
+			{
+				locQuaternions[j][i] = Quaternion{ Vector3{ RandomFloat(), RandomFloat(), RandomFloat() + 2.0f }, Math::Radian(RandomFloat() * Math::PI) };
+				locMatrices[j][i] = Matrix44::Translate(RandomFloat(), RandomFloat(), RandomFloat()) * locQuaternions[j][i].GetMatrix();
+				locVector3s[j][i] = Vector3{ RandomFloat(), RandomFloat(), RandomFloat() + 2.0f };
+				locVector3As[j][i] = Vector3A{ locVector3s[j][i] };
+			}
+
+			locVectors[i] = Vector4{ RandomFloat(), RandomFloat(), RandomFloat(), 1.0f };
+			for (uint32_t j = 0u; j < 4u; ++j)
+				locFloats[4u * i + j] = RandomFloat();
+		}
+	}
+
+	// Keeps the thread on the core it is running on, so samples are not split between cores with different clocks and caches
+	bool PinToCurrentCore()
+	{
+#if IS_WINDOWS_PLATFORM
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+		return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{ 1u } << GetCurrentProcessorNumber()) != 0u;
+#else
+		int core = sched_getcpu();
+		if (core < 0)
+			return false;
+
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(core, &cpuSet);
+		return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#endif // IS_WINDOWS_PLATFORM
+	}
+
+	double Measure(const Benchmark& aBenchmark, uint32_t aRepeatCount)
+	{
+		Clock::time_point start = Clock::now();
+		aBenchmark.myRunFn(aRepeatCount);
+		return std::chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	Result RunBenchmark(const Benchmark& aBenchmark, uint32_t aSampleCount)
+	{
+		// Warmup doubles the repeat count until a sample is long enough, then keeps running until the warmup time is over
+		uint32_t repeatCount = 1u;
+		double warmupSeconds = 0.0;
+		while (warmupSeconds < locWarmupSeconds)
+		{
+			double seconds = Measure(aBenchmark, repeatCount);
+			warmupSeconds += seconds;
+			if (seconds < locMinimumSampleSeconds)
+				repeatCount *= 2u;
+		}
+
+		Result result;
+		result.myName = aBenchmark.myName;
+		result.myOperationsPerSample = static_cast<uint64_t>(repeatCount) * locElementCount;
+
+		std::vector<double> samples(aSampleCount);
+		for (double& sample : samples)
+			sample = Measure(aBenchmark, repeatCount) * 1e9 / result.myOperationsPerSample;
+
+		double sum = 0.0;
+		for (double sample : samples)
+			sum += sample;
+		result.myMean = sum / aSampleCount;
+
+		double squaredDifferenceSum = 0.0;
+		for (double sample : samples)
+			squaredDifferenceSum += (sample - result.myMean) * (sample - result.myMean);
+		result.myStandardDeviation = aSampleCount > 1u ? std::sqrt(squaredDifferenceSum / (aSampleCount - 1u)) : 0.0;
+
+		// The median is what gets compared, a few samples hit by interrupts do not move it
+		std::sort(samples.begin(), samples.end());
+		result.myMedian = aSampleCount % 2u == 1u ? samples[aSampleCount / 2u] : (samples[aSampleCount / 2u - 1u] + samples[aSampleCount / 2u]) * 0.5;
+		result.myMin = samples.front();
+		result.myMax = samples.back();
+		return result;
+	}
+
+	const char* GetName(SIMD::InstructionSet anInstructionSet)
+	{
+		switch (anInstructionSet)
+		{
+		case SIMD::InstructionSet::SSE2: return "SSE2";
+		case SIMD::InstructionSet::SSE4_1: return "SSE4_1";
+		case SIMD::InstructionSet::AVX2: return "AVX2";
+		default: return "SCALAR";
+		}
+	}
+
+	const char* GetBuildName()
+	{
+#if IS_DEBUG_BUILD
+		return "Debug";
+#elif IS_DEVELOPMENT_BUILD
+		return "Development";
+#else
+		return "Release";
+#endif // IS_DEBUG_BUILD
+	}
+
+	void Print(const Result& aResult)
+	{
+		std::cout << std::left << std::setw(28) << aResult.myName << std::right << std::fixed
+			<< std::setw(12) << std::setprecision(3) << aResult.myMedian
+			<< std::setw(16) << std::setprecision(0) << 1e9 / aResult.myMedian
+			<< std::setw(12) << std::setprecision(3) << aResult.myMean
+			<< std::setw(12) << std::setprecision(3) << aResult.myStandardDeviation
+			<< std::setw(10) << std::setprecision(2) << aResult.myStandardDeviation / aResult.myMean * 100.0
+			<< std::setw(12) << std::setprecision(3) << aResult.myMin << "\n";
+	}
+
+	bool WriteJson(const char* aPath, const std::vector<Result>& someResults, uint32_t aSampleCount, bool anIsPinned)
+	{
+		std::ofstream file(aPath);
+		if (file.is_open() == false)
+			return false;
+
+		char timestamp[32];
+		std::time_t now = std::time(nullptr);
+		std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+		// Names are written as they are, none of them has characters JSON needs escaped
+		file << std::setprecision(9);
+		file << "{\n";
+		file << "\t\"timestamp\": \"" << timestamp << "\",\n";
+		file << "\t\"build\": \"" << GetBuildName() << "\",\n";
+		file << "\t\"compiled_instruction_set\": \"" << GetName(SIMD::ourCompiledInstructionSet) << "\",\n";
+		file << "\t\"supported_instruction_set\": \"" << GetName(SIMD::GetSupportedInstructionSet()) << "\",\n";
+		file << "\t\"pinned\": " << (anIsPinned ? "true" : "false") << ",\n";
+		file << "\t\"sample_count\": " << aSampleCount << ",\n";
+		file << "\t\"benchmarks\": [\n";
+		for (size_t i = 0u; i < someResults.size(); ++i)
+		{
+			const Result& result = someResults[i];
+			file << "\t\t{\n";
+			file << "\t\t\t\"name\": \"" << result.myName << "\",\n";
+			file << "\t\t\t\"operations_per_sample\": " << result.myOperationsPerSample << ",\n";
+			file << "\t\t\t\"ns_per_op\": " << result.myMedian << ",\n";
+			file << "\t\t\t\"ops_per_second\": " << 1e9 / result.myMedian << ",\n";
+			file << "\t\t\t\"mean_ns\": " << result.myMean << ",\n";
+			file << "\t\t\t\"stddev_ns\": " << result.myStandardDeviation << ",\n";
+			file << "\t\t\t\"min_ns\": " << result.myMin << ",\n";
+			file << "\t\t\t\"max_ns\": " << result.myMax << "\n";
+			file << "\t\t}" << (i + 1u < someResults.size() ? "," : "") << "\n";
+		}
+		file << "\t]\n";
+		file << "}\n";
+		return file.good();
+	}
+}
+
+int main(int anArgumentCount, char** someArguments)
+{
+	const char* jsonPath = nullptr;
+	const char* filter = nullptr;
+	uint32_t sampleCount = locDefaultSampleCount;
+	for (int i = 1; i < anArgumentCount; ++i)
+	{
+		if (std::strcmp(someArguments[i], "--json") == 0 && i + 1 < anArgumentCount)
+		{
+			jsonPath = someArguments[++i];
+		}
+		else if (std::strcmp(someArguments[i], "--samples") == 0 && i + 1 < anArgumentCount)
+		{
+			sampleCount = static_cast<uint32_t>(std::max(std::atoi(someArguments[++i]), 1));
+		}
+		else if (someArguments[i][0] == '-')
+		{
+			std::cerr << "Usage: DBZ_Benchmarks [--json file] [--samples count] [name filter]\n";
+			return 1;
+		}
+		else
+		{
+			filter = someArguments[i];
+		}
+	}
+
+	bool isPinned = PinToCurrentCore();
+	if (isPinned == false)
+		std::cerr << "Could not pin the thread to a core, results may be noisier\n";
+
+	InitializeOperands();
+
+	std::cout << GetBuildName() << " build, compiled for " << GetName(SIMD::ourCompiledInstructionSet) << ", CPU supports " << GetName(SIMD::GetSupportedInstructionSet())
+		<< ", " << sampleCount << " samples\n";
+	std::cout << std::left << std::setw(28) << "Benchmark" << std::right << std::setw(12) << "ns/op" << std::setw(16) << "ops/s" << std::setw(12) << "Mean (ns)"
+		<< std::setw(12) << "Stddev (ns)" << std::setw(10) << "CV (%)" << std::setw(12) << "Min (ns)" << "\n";
+
+	std::vector<Result> results;
+	for (const Benchmark& benchmark : locBenchmarks)
+	{
+		if (filter != nullptr && std::strstr(benchmark.myName, filter) == nullptr)
+			continue;
+
+		results.push_back(RunBenchmark(benchmark, sampleCount));
+		Print(results.back());
+	}
+
+	if (jsonPath != nullptr && WriteJson(jsonPath, results, sampleCount, isPinned) == false)
+	{
+		std::cerr << "Could not write " << jsonPath << "\n";
+		return 1;
+	}
+
+	return 0;
+}
@@ -439,7 +439,9 @@ void Application::Initialize()
 
 	// Create uniform buffer
 	float aspectRatio = static_cast<float>(myMainWindow.GetClientWidth()) / static_cast<float>(myMainWindow.GetClientHeight());
-	Matrix44 mvp = Gfx::locCamera.ProjectionMatrix(aspectRatio) * Matrix44::Translate(0.0f, 0.0f, -10.0f);
+	Gfx::locCamera.SetPosition(Vector3{ 0.0f, 0.0f, 10.0f });
+	Gfx::locCamera.SetAspectRatio(aspectRatio);
+	Matrix44 mvp = Gfx::locCamera.ViewProjectionMatrix();
 
 	bufferCreateInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 	bufferCreateInfo.size = sizeof(mvp);
@@ -586,7 +588,9 @@ void Application::WindowPaint()
 
 	Matrix44 orientationMatrix = orientation.GetMatrix();
 	float aspectRatio = static_cast<float>(myMainWindow.GetClientWidth()) / static_cast<float>(myMainWindow.GetClientHeight());
-	Matrix44 mvp = Gfx::locCamera.ProjectionMatrix(aspectRatio) * Matrix44::Translate(xPosition, yPosition, -10.0f) * orientationMatrix;
+	// Only rebuilds the projection when the window changed shape
+	Gfx::locCamera.SetAspectRatio(aspectRatio);
+	Matrix44 mvp = Gfx::locCamera.ViewProjectionMatrix() * Matrix44::Translate(xPosition, yPosition, 0.0f) * orientationMatrix;
 	VkDeviceSize offset = Gfx::locUniformBufferOffset * frameIndex;
 	void* mappedDeviceMemory = myRenderer.MapDeviceMemory(Gfx::locUniformDeviceMemory, offset, sizeof(mvp));
 	std::memcpy(mappedDeviceMemory, &mvp, sizeof(mvp));
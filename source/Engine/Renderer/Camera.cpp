@@ -1,14 +1,103 @@
 #include "Camera.h"
 
-#include "Math/Matrix44.h"
+const Matrix44& Camera::ViewMatrix() const
+{
+	if (myIsViewDirty)
+	{
+		// Inverse of the camera transform, the conjugate rotation and the position rotated back
+		myViewMatrix = myOrientation.Conjugate().GetMatrix();
+		myViewMatrix.myPosition = myViewMatrix * Vector4{ -myPosition.x, -myPosition.y, -myPosition.z, 1.0f };
+		myIsViewDirty = false;
+#if IS_DEVELOPMENT_BUILD
+		++myRebuildCount;
+#endif // IS_DEVELOPMENT_BUILD
+	}
+	return myViewMatrix;
+}
+
+const Matrix44& Camera::ProjectionMatrix() const
+{
+	if (myIsProjectionDirty)
+	{
+		myProjectionMatrix = Matrix44::Perspective(myFieldOfViewY.myValue, myAspectRatio, myNearPlane, myFarPlane);
+		myIsProjectionDirty = false;
+#if IS_DEVELOPMENT_BUILD
+		++myRebuildCount;
+#endif // IS_DEVELOPMENT_BUILD
+	}
+	return myProjectionMatrix;
+}
+
+const Matrix44& Camera::ViewProjectionMatrix() const
+{
+	if (myIsViewProjectionDirty)
+	{
+		myViewProjectionMatrix = ProjectionMatrix() * ViewMatrix();
+		myViewFrustum = Frustum{ myViewProjectionMatrix };
+		myIsViewProjectionDirty = false;
+#if IS_DEVELOPMENT_BUILD
+		++myRebuildCount;
+#endif // IS_DEVELOPMENT_BUILD
+	}
+	return myViewProjectionMatrix;
+}
+
+const Frustum& Camera::ViewFrustum() const
+{
+	ViewProjectionMatrix();
+	return myViewFrustum;
+}
+
+void Camera::SetPosition(const Vector3& aPosition)
+{
+	if (myPosition.x == aPosition.x && myPosition.y == aPosition.y && myPosition.z == aPosition.z)
+		return;
+
+	myPosition = aPosition;
+	SetViewDirty();
+}
+
+void Camera::SetOrientation(const Quaternion& anOrientation)
+{
+	if (SIMD::GetMask(SIMD::CompareEqual(myOrientation.GetVector(), anOrientation.GetVector())) == 0xF)
+		return;
+
+	myOrientation = anOrientation;
+	SetViewDirty();
+}
+
+void Camera::SetAspectRatio(float anAspectRatio)
+{
+	if (myAspectRatio == anAspectRatio)
+		return;
 
-Matrix44 Camera::ViewMatrix() const
+	myAspectRatio = anAspectRatio;
+	SetProjectionDirty();
+}
+
+void Camera::SetFieldOfViewY(Math::Radian aRadian)
 {
-	// TODO
-	return Matrix44{};
+	if (myFieldOfViewY.myValue == aRadian.myValue)
+		return;
+
+	myFieldOfViewY = aRadian;
+	SetProjectionDirty();
 }
 
-Matrix44 Camera::ProjectionMatrix(float anAspectRatio) const
+void Camera::SetFarPlane(float aFarPlane)
 {
-	return Matrix44::Perspective(myFieldOfViewY.myValue, anAspectRatio, myNearPlane, myFarPlane);
+	if (myFarPlane == aFarPlane)
+		return;
+
+	myFarPlane = aFarPlane;
+	SetProjectionDirty();
 }
+
+void Camera::SetNearPlane(float aNearPlane)
+{
+	if (myNearPlane == aNearPlane)
+		return;
+
+	myNearPlane = aNearPlane;
+	SetProjectionDirty();
+}
\ No newline at end of file
@@ -1,28 +1,64 @@
 #pragma once
 
 #include "Math/MathCommon.h"
+#include "Math/Frustum.h"
+#include "Math/Matrix44.h"
 #include "Math/Vector3.h"
 #include "Math/Quaternion.h"
 
-struct Matrix44;
-
+// The matrices and the frustum are cached, they are only rebuilt on the first call after a setter changed
+// something they depend on. Setting the value the camera already has does not invalidate them
 class Camera
 {
 public:
-	Matrix44 ViewMatrix() const;
-	Matrix44 ProjectionMatrix(float anAspectRatio) const;
+	// World to camera, the camera looks down its -z axis with y up
+	const Matrix44& ViewMatrix() const;
+	const Matrix44& ProjectionMatrix() const;
+	const Matrix44& ViewProjectionMatrix() const;
+	// World space planes of what the camera sees
+	const Frustum& ViewFrustum() const;
 
-	void SetFieldOfViewY(Math::Radian aRadian) { myFieldOfViewY = aRadian; }
-	void SetFieldOfViewY(Math::Degree aDegree) { myFieldOfViewY = aDegree.ToRadian(); }
-	void SetFarPlane(float aFarPlane) { myFarPlane = aFarPlane; }
-	void SetNearPlane(float aNearPlane) { myNearPlane = aNearPlane; }
+	void SetPosition(const Vector3& aPosition);
+	// Expects a unit quaternion
+	void SetOrientation(const Quaternion& anOrientation);
+	void SetAspectRatio(float anAspectRatio);
+	void SetFieldOfViewY(Math::Radian aRadian);
+	void SetFieldOfViewY(Math::Degree aDegree) { SetFieldOfViewY(Math::Radian{ aDegree }); }
+	void SetFarPlane(float aFarPlane);
+	void SetNearPlane(float aNearPlane);
 
+	const Vector3& GetPosition() const { return myPosition; }
+	const Quaternion& GetOrientation() const { return myOrientation; }
+	float GetAspectRatio() const { return myAspectRatio; }
 	Math::Radian GetFieldOfViewY() const { return myFieldOfViewY; }
+	float GetFarPlane() const { return myFarPlane; }
+	float GetNearPlane() const { return myNearPlane; }
 
 private:
+	void SetViewDirty() { myIsViewDirty = true; myIsViewProjectionDirty = true; }
+	void SetProjectionDirty() { myIsProjectionDirty = true; myIsViewProjectionDirty = true; }
+
+	mutable Matrix44 myViewMatrix;
+	mutable Matrix44 myProjectionMatrix;
+	mutable Matrix44 myViewProjectionMatrix;
+	mutable Frustum myViewFrustum;
 	Quaternion myOrientation;
 	Vector3 myPosition;
+	float myAspectRatio = 1.0f;
 	Math::Radian myFieldOfViewY = Math::DegreeToRadian(60.0f);
 	float myFarPlane = 100.0f;
 	float myNearPlane = 0.1f;
+	// The frustum is rebuilt with the view projection matrix
+	mutable bool myIsViewDirty = true;
+	mutable bool myIsProjectionDirty = true;
+	mutable bool myIsViewProjectionDirty = true;
+
+#if IS_DEVELOPMENT_BUILD
+public:
+	// Matrices rebuilt so far, the frustum is rebuilt with the view projection matrix
+	uint32_t GetRebuildCount() const { return myRebuildCount; }
+
+private:
+	mutable uint32_t myRebuildCount = 0u;
+#endif // IS_DEVELOPMENT_BUILD
 };
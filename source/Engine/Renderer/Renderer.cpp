@@ -2,7 +2,6 @@
 
 #include "DisplayRenderer.h"
 
-#include "Memory/StackAllocation.h"
 #include "Window/Window.h"
 
 #include "Common/Debug.h"
@@ -10,8 +9,24 @@
 namespace DBZ
 {
 
-void Renderer::Create(Renderer& aRendererOut)
+namespace
 {
+	template <typename T>
+	T* AllocateScratch(dbz::FrameArena& aFrameArena, uint32_t aCount)
+	{
+		T* scratch = aFrameArena.AllocateArray<T>(aCount);
+
+		// Frame arena capacity is too small for what the renderer needs
+		if (scratch == nullptr)
+			Debug::Breakpoint();
+
+		return scratch;
+	}
+}
+
+void Renderer::Create(Renderer& aRendererOut, size_t aFrameArenaCapacity)
+{
+	aRendererOut.myFrameArena = dbz::FrameArena::Create(aFrameArenaCapacity);
 	VulkanInstanceWrapper::Create(aRendererOut.myVulkanInstanceWrapper);
 }
 
@@ -19,11 +34,15 @@ void Renderer::Destroy(Renderer& aRenderer)
 {
 	aRenderer.DestroyDevice();
 	VulkanInstanceWrapper::Destroy(aRenderer.myVulkanInstanceWrapper);
+	dbz::FrameArena::Destroy(aRenderer.myFrameArena);
 }
 
 void Renderer::BeginFrame(DisplayRenderer* someDisplayRenderers, uint32_t aDisplayRendererCount)
 {
-	Fence* fencesToWaitFor = static_cast<Fence*>(DBZ_ALLOCATE_STACK_MEMORY(sizeof(Fence) * aDisplayRendererCount));
+	// Scratch memory from previous frame is not needed anymore
+	myFrameArena.Reset();
+
+	Fence* fencesToWaitFor = AllocateScratch<Fence>(myFrameArena, aDisplayRendererCount);
 	for (uint32_t i = 0; i < aDisplayRendererCount; ++i)
 		fencesToWaitFor[i] = someDisplayRenderers[i].myOnFlightFences[someDisplayRenderers[i].myOnFlightImageIndex];
 
@@ -41,8 +60,8 @@ void Renderer::BeginFrame(DisplayRenderer* someDisplayRenderers, uint32_t aDispl
 
 void Renderer::EndFrame(Semaphore* someWaitSemaphores, uint32_t aWaitSemaphoreCount, DisplayRenderer* someDisplayRenderers, uint32_t aDisplayRendererCount)
 {
-	SwapchainKHR* displaySwapchains = static_cast<SwapchainKHR*>(DBZ_ALLOCATE_STACK_MEMORY(sizeof(SwapchainKHR) * aDisplayRendererCount));
-	uint32_t* displayImageIndices = static_cast<uint32_t*>(DBZ_ALLOCATE_STACK_MEMORY(sizeof(uint32_t) * aDisplayRendererCount));
+	SwapchainKHR* displaySwapchains = AllocateScratch<SwapchainKHR>(myFrameArena, aDisplayRendererCount);
+	uint32_t* displayImageIndices = AllocateScratch<uint32_t>(myFrameArena, aDisplayRendererCount);
 
 	for (uint32_t i = 0; i < aDisplayRendererCount; ++i)
 	{
@@ -327,13 +346,15 @@ void Renderer::UnmapDeviceMemory(DeviceMemory& aDeviceMemory)
 
 void Renderer::CreateDevice(const DisplayRenderer* someDisplays, uint32_t aDisplayCount)
 {
+	dbz::FrameArena::Scope scratchScope(myFrameArena);
+
 	uint32_t physicalDeviceCount = 0u;
 	myVulkanInstanceWrapper.EnumeratePhysicalDevices(physicalDeviceCount, nullptr);
 
 	if (physicalDeviceCount == 0u)
 		Debug::Breakpoint();
 
-	PhysicalDevice* physicalDevices = static_cast<PhysicalDevice*>(DBZ_ALLOCATE_STACK_MEMORY(physicalDeviceCount * sizeof(PhysicalDevice)));
+	PhysicalDevice* physicalDevices = AllocateScratch<PhysicalDevice>(myFrameArena, physicalDeviceCount);
 	myVulkanInstanceWrapper.EnumeratePhysicalDevices(physicalDeviceCount, physicalDevices);
 
 	// Choose best physical device to create device with
@@ -342,6 +363,8 @@ void Renderer::CreateDevice(const DisplayRenderer* someDisplays, uint32_t aDispl
 	uint32_t maxScore = 0u;
 	for (uint32_t i = 0; i < physicalDeviceCount; ++i)
 	{
+		dbz::FrameArena::Scope physicalDeviceScratchScope(myFrameArena);
+
 		// Give a score to the physical device. (Somehow)
 		PhysicalDevice device = physicalDevices[i];
 		uint32_t score = 0u;
@@ -363,7 +386,7 @@ void Renderer::CreateDevice(const DisplayRenderer* someDisplays, uint32_t aDispl
 		if (familyPropertyCount == 0u)
 			continue;
 
-		VkQueueFamilyProperties* familyProperties = static_cast<VkQueueFamilyProperties*>(DBZ_ALLOCATE_STACK_MEMORY(familyPropertyCount * sizeof(VkQueueFamilyProperties)));
+		VkQueueFamilyProperties* familyProperties = AllocateScratch<VkQueueFamilyProperties>(myFrameArena, familyPropertyCount);
 		myVulkanInstanceWrapper.GetPhysicalDeviceQueueFamilyProperties(device, familyPropertyCount, familyProperties);
 
 		for (uint32_t j = 0; j < familyPropertyCount; ++j)
@@ -442,8 +465,10 @@ void Renderer::CreateDisplaySurface(const Window& aWindow, DisplayRenderer& aDis
 	myVulkanInstanceWrapper.Create(aWindow.GetWindowHandle(), aDisplayRendererOut.mySurface);
 }
 
-void Renderer::CreateDisplaySwapchain(uint32_t aWidth, uint32_t aHeight, uint32_t aDesiredImageCount, DisplayRenderer& aDisplayRendererOut) const
+void Renderer::CreateDisplaySwapchain(uint32_t aWidth, uint32_t aHeight, uint32_t aDesiredImageCount, DisplayRenderer& aDisplayRendererOut)
 {
+	dbz::FrameArena::Scope scratchScope(myFrameArena);
+
 	aDisplayRendererOut.myDisplayImageIndex = 0u;
 	aDisplayRendererOut.myOnFlightImageIndex = 0u;
 	aDisplayRendererOut.myDisplayWidth = aWidth;
@@ -459,7 +484,7 @@ void Renderer::CreateDisplaySwapchain(uint32_t aWidth, uint32_t aHeight, uint32_
 	if (surfaceFormatCount == 0)
 		Debug::Breakpoint();
 
-	VkSurfaceFormatKHR* surfaceFormats = static_cast<VkSurfaceFormatKHR*>(DBZ_ALLOCATE_STACK_MEMORY(sizeof(VkSurfaceFormatKHR) * surfaceFormatCount));
+	VkSurfaceFormatKHR* surfaceFormats = AllocateScratch<VkSurfaceFormatKHR>(myFrameArena, surfaceFormatCount);
 	myVulkanInstanceWrapper.GetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, surfaceFormatCount, surfaceFormats);
 	aDisplayRendererOut.mySwapchainFormat = surfaceFormats[0].format;
 
@@ -515,10 +540,12 @@ void Renderer::CreateDisplayRenderPass(const VkRenderPassCreateInfo& aRenderPass
 	myVulkanDeviceWrapper.Create(aRenderPassCreateInfo, aDisplayRendererOut.myDisplayRenderPass);
 }
 
-void Renderer::CreateDisplayImageViews(DisplayRenderer& aDisplayRendererOut) const
+void Renderer::CreateDisplayImageViews(DisplayRenderer& aDisplayRendererOut)
 {
+	dbz::FrameArena::Scope scratchScope(myFrameArena);
+
 	uint32_t swapchainImageCount = aDisplayRendererOut.myDisplayImageCount;
-	Image* swapchainImages = static_cast<Image*>(DBZ_ALLOCATE_STACK_MEMORY(sizeof(Image) * swapchainImageCount));
+	Image* swapchainImages = AllocateScratch<Image>(myFrameArena, swapchainImageCount);
 	myVulkanDeviceWrapper.GetSwapchainImagesKHR(aDisplayRendererOut.mySwapchain, swapchainImageCount, swapchainImages);
 
 	for (uint32_t i = 0; i < swapchainImageCount; ++i)
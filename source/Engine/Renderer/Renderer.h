@@ -2,6 +2,8 @@
 
 #include "VulkanWrapper/VulkanWrapper.h"
 
+#include "Memory/FrameArena.h"
+
 class Window;
 
 namespace DBZ
@@ -12,7 +14,7 @@ class DisplayRenderer;
 class Renderer
 {
 public:
-	static void Create(Renderer& aRendererOut);
+	static void Create(Renderer& aRendererOut, size_t aFrameArenaCapacity = ourDefaultFrameArenaCapacity);
 	static void Destroy(Renderer& aRenderer);
 
 	void BeginFrame(DisplayRenderer* someDisplayRenderers, uint32_t aDisplayRendererCount);
@@ -83,6 +85,10 @@ public:
 	constexpr static uint32_t ourMaxDisplayImagesPerDisplay = 3u;
 	// One presented and at maximum another 2 being processed
 	constexpr static uint32_t ourMaxOnFlightImagesPerDisplay = 2u;
+	// Scratch memory for per frame arrays and device queries
+	constexpr static size_t ourDefaultFrameArenaCapacity = 64u * 1024u;
+
+	size_t GetFrameArenaHighWaterMark() const { return myFrameArena.GetHighWaterMark(); }
 
 private:
 	// Device management helpers
@@ -91,14 +97,15 @@ private:
 
 	// DisplayRenderer object management helpers
 	void CreateDisplaySurface(const Window& aWindow, DisplayRenderer& aDisplayRendererOut) const;
-	void CreateDisplaySwapchain(uint32_t aWidth, uint32_t aHeight, uint32_t aDesiredImageCount, DisplayRenderer& aDisplayRendererOut) const;
+	void CreateDisplaySwapchain(uint32_t aWidth, uint32_t aHeight, uint32_t aDesiredImageCount, DisplayRenderer& aDisplayRendererOut);
 	void CreateDisplayRenderPass(const VkRenderPassCreateInfo& aRenderPassCreateInfo, DisplayRenderer& aDisplayRendererOut) const;
-	void CreateDisplayImageViews(DisplayRenderer& aDisplayRendererOut) const;
+	void CreateDisplayImageViews(DisplayRenderer& aDisplayRendererOut);
 	void CreateDisplayFramebuffers(DisplayRenderer& aDisplayRendererOut) const;
 	void DestroyDisplaySwapchainResources(DisplayRenderer& aDisplayRenderer) const;
 
 	VulkanInstanceWrapper myVulkanInstanceWrapper;
 	VulkanDeviceWrapper myVulkanDeviceWrapper;
+	dbz::FrameArena myFrameArena;
 };
 
 }
@@ -31,3 +31,20 @@
 #else
 #define IS_DEVELOPMENT_BUILD 0
 #endif // DBZ_DEVELOPMENT
+
+// Allocators report to an AllocationTracker when one is set, tracking stays off until enabled at runtime
+#if IS_DEVELOPMENT_BUILD
+#define IS_ALLOCATION_TRACKING_BUILD 1
+#else
+#define IS_ALLOCATION_TRACKING_BUILD 0
+#endif // IS_DEVELOPMENT_BUILD
+
+// Functions reporting their return address as the allocation callsite are kept out of line in tracking builds,
+// otherwise the address would point into the caller of the code making the allocation
+#if IS_ALLOCATION_TRACKING_BUILD && IS_WINDOWS_PLATFORM
+#define DBZ_TRACKED_NOINLINE __declspec(noinline)
+#elif IS_ALLOCATION_TRACKING_BUILD
+#define DBZ_TRACKED_NOINLINE __attribute__((noinline))
+#else
+#define DBZ_TRACKED_NOINLINE
+#endif // IS_ALLOCATION_TRACKING_BUILD
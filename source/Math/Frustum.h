@@ -0,0 +1,238 @@
+#pragma once
+
+#include "Matrix44.h"
+#include "SIMDVector.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+#include <stdint.h>
+
+// View frustum as six planes, left, right, top, bottom, near and far. Normals are unit length and point inside,
+// so a point p is inside when Dot(normal, p) + w >= 0 for every plane. Bounds touching a plane count as visible
+struct Frustum
+{
+	static constexpr uint32_t ourPlaneCount = 6u;
+
+	// Bounding spheres in separate streams
+	struct SphereStream
+	{
+		const float* myX;
+		const float* myY;
+		const float* myZ;
+		const float* myRadius;
+	};
+
+	// Axis aligned boxes as center and half extents in separate streams
+	struct BoxStream
+	{
+		const float* myCenterX;
+		const float* myCenterY;
+		const float* myCenterZ;
+		const float* myExtentX;
+		const float* myExtentY;
+		const float* myExtentZ;
+	};
+
+	// All planes are zero, everything is visible
+	Frustum() = default;
+
+	// Planes in the space the matrix transforms from, world space for a view projection matrix.
+	// Expects Vulkan clip space, -w <= x, y <= w and 0 <= z <= w
+	explicit Frustum(const Matrix44& aViewProjection)
+	{
+		// Gribb and Hartmann, each clip space inequality is a combination of two rows of the matrix
+		Matrix44 rows = aViewProjection.Transpose();
+		const SIMD::Vector& x = rows.myXAxis.myVector;
+		const SIMD::Vector& y = rows.myYAxis.myVector;
+		const SIMD::Vector& z = rows.myZAxis.myVector;
+		const SIMD::Vector& w = rows.myPosition.myVector;
+
+		// Vulkan y points down, so -w <= y is the top of the screen
+		const SIMD::Vector planes[ourPlaneCount] = { SIMD::Add(w, x), SIMD::Subtract(w, x), SIMD::Add(w, y), SIMD::Subtract(w, y), z, SIMD::Subtract(w, z) };
+		for (uint32_t i = 0u; i < ourPlaneCount; ++i)
+			myPlanes[i] = SIMD::Divide(planes[i], SIMD::Sqrt(SIMD::Dot3(planes[i], planes[i])));
+	}
+
+	inline bool IsSphereVisible(const Vector3& aCenter, float aRadius) const
+	{
+		for (const Vector4& plane : myPlanes)
+		{
+			if (plane.x * aCenter.x + plane.y * aCenter.y + plane.z * aCenter.z + plane.w + aRadius < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+	// The box is outside when its corner furthest along the normal is outside
+	inline bool IsBoxVisible(const Vector3& aCenter, const Vector3& anExtent) const
+	{
+		for (const Vector4& plane : myPlanes)
+		{
+			float radius = fabsf(plane.x) * anExtent.x + fabsf(plane.y) * anExtent.y + fabsf(plane.z) * anExtent.z;
+			if (plane.x * aCenter.x + plane.y * aCenter.y + plane.z * aCenter.z + plane.w + radius < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+	// Writes the indices of the visible bounds in increasing order and returns how many there are, 8 at a time when
+	// the CPU supports AVX2. someVisibleIndicesOut needs room for aCount indices, the ones past the returned count are garbage
+	uint32_t CullSpheres(const SphereStream& someSpheres, uint32_t aCount, uint32_t* someVisibleIndicesOut) const;
+	uint32_t CullBoxes(const BoxStream& someBoxes, uint32_t aCount, uint32_t* someVisibleIndicesOut) const;
+
+	Vector4 myPlanes[ourPlaneCount];
+
+private:
+	// Spheres pass their radius in someExtentX and null for the other two extents
+	template <bool IsBox>
+	uint32_t Cull(const float* someX, const float* someY, const float* someZ, const float* someExtentX, const float* someExtentY, const float* someExtentZ, uint32_t aCount, uint32_t* someVisibleIndicesOut) const;
+
+	// Appends the indices of the set bits of aMask. Writes every lane without branching and only advances past the visible
+	// ones, the written slot is never past the index being written so the output can be as long as the input
+	static inline uint32_t AppendVisible(uint32_t aMask, uint32_t aFirstIndex, uint32_t aLaneCount, uint32_t* someVisibleIndicesOut, uint32_t aVisibleCount)
+	{
+		for (uint32_t lane = 0u; lane < aLaneCount; ++lane)
+		{
+			someVisibleIndicesOut[aVisibleCount] = aFirstIndex + lane;
+			aVisibleCount += (aMask >> lane) & 1u;
+		}
+		return aVisibleCount;
+	}
+
+#if SIMD_HAS_AVX2_KERNELS
+	template <bool IsBox>
+	SIMD_AVX2_TARGET uint32_t CullAVX2(const float* someX, const float* someY, const float* someZ, const float* someExtentX, const float* someExtentY, const float* someExtentZ, uint32_t aCount, uint32_t* someVisibleIndicesOut) const;
+
+	template <bool IsBox>
+	SIMD_AVX2_TARGET static __m256 IsVisibleAVX2(const __m256 (&somePlanes)[ourPlaneCount][4], const __m256 (&someAbsoluteNormals)[ourPlaneCount][3],
+		__m256 anX, __m256 aY, __m256 aZ, __m256 anExtentX, __m256 anExtentY, __m256 anExtentZ);
+#endif // SIMD_HAS_AVX2_KERNELS
+};
+
+inline uint32_t Frustum::CullSpheres(const SphereStream& someSpheres, uint32_t aCount, uint32_t* someVisibleIndicesOut) const
+{
+	return Cull<false>(someSpheres.myX, someSpheres.myY, someSpheres.myZ, someSpheres.myRadius, nullptr, nullptr, aCount, someVisibleIndicesOut);
+}
+
+inline uint32_t Frustum::CullBoxes(const BoxStream& someBoxes, uint32_t aCount, uint32_t* someVisibleIndicesOut) const
+{
+	return Cull<true>(someBoxes.myCenterX, someBoxes.myCenterY, someBoxes.myCenterZ, someBoxes.myExtentX, someBoxes.myExtentY, someBoxes.myExtentZ, aCount, someVisibleIndicesOut);
+}
+
+template <bool IsBox>
+uint32_t Frustum::Cull(const float* someX, const float* someY, const float* someZ, const float* someExtentX, const float* someExtentY, const float* someExtentZ, uint32_t aCount, uint32_t* someVisibleIndicesOut) const
+{
+#if SIMD_HAS_AVX2_KERNELS
+	if (SIMD::GetSupportedInstructionSet() == SIMD::InstructionSet::AVX2)
+		return CullAVX2<IsBox>(someX, someY, someZ, someExtentX, someExtentY, someExtentZ, aCount, someVisibleIndicesOut);
+#endif // SIMD_HAS_AVX2_KERNELS
+
+	// 4 at a time with the compiled instruction set
+	SIMD::Vector planes[ourPlaneCount][4];
+	SIMD::Vector absoluteNormals[ourPlaneCount][3];
+	for (uint32_t i = 0u; i < ourPlaneCount; ++i)
+	{
+		for (uint32_t j = 0u; j < 4u; ++j)
+			planes[i][j] = SIMD::Load(myPlanes[i][j]);
+		for (uint32_t j = 0u; j < 3u; ++j)
+			absoluteNormals[i][j] = SIMD::Abs(planes[i][j]);
+	}
+
+	const SIMD::Vector zero = SIMD::Load(0.0f);
+	auto getVisibleMask = [&](const float* someBounds[6]) -> uint32_t
+	{
+		SIMD::Vector x = SIMD::LoadUnaligned(someBounds[0]);
+		SIMD::Vector y = SIMD::LoadUnaligned(someBounds[1]);
+		SIMD::Vector z = SIMD::LoadUnaligned(someBounds[2]);
+		SIMD::Vector extentX = SIMD::LoadUnaligned(someBounds[3]);
+		SIMD::Vector extentY = IsBox ? SIMD::LoadUnaligned(someBounds[4]) : zero;
+		SIMD::Vector extentZ = IsBox ? SIMD::LoadUnaligned(someBounds[5]) : zero;
+
+		SIMD::Vector isVisible = SIMD::CompareEqual(zero, zero);
+		for (uint32_t i = 0u; i < ourPlaneCount; ++i)
+		{
+			SIMD::Vector distance = SIMD::MultiplyAdd(x, planes[i][0], SIMD::MultiplyAdd(y, planes[i][1], SIMD::MultiplyAdd(z, planes[i][2], planes[i][3])));
+			SIMD::Vector radius = IsBox ? SIMD::MultiplyAdd(extentX, absoluteNormals[i][0], SIMD::MultiplyAdd(extentY, absoluteNormals[i][1], SIMD::Multiply(extentZ, absoluteNormals[i][2]))) : extentX;
+			isVisible = SIMD::And(isVisible, SIMD::CompareGreaterEqual(SIMD::Add(distance, radius), zero));
+		}
+		return static_cast<uint32_t>(SIMD::GetMask(isVisible));
+	};
+
+	uint32_t visibleCount = 0u;
+	uint32_t i = 0u;
+	for (; i + 4u <= aCount; i += 4u)
+	{
+		const float* bounds[6] = { someX + i, someY + i, someZ + i, someExtentX + i, IsBox ? someExtentY + i : nullptr, IsBox ? someExtentZ + i : nullptr };
+		visibleCount = AppendVisible(getVisibleMask(bounds), i, 4u, someVisibleIndicesOut, visibleCount);
+	}
+
+	if (i < aCount)
+	{
+		// Tail padded with zeros, so it runs through the same math as the rest of the array
+		alignas(16) float tail[6][4] = {};
+		const float* streams[6] = { someX, someY, someZ, someExtentX, someExtentY, someExtentZ };
+		for (uint32_t j = 0u; j < (IsBox ? 6u : 4u); ++j)
+		{
+			for (uint32_t k = 0u; i + k < aCount; ++k)
+				tail[j][k] = streams[j][i + k];
+		}
+
+		const float* bounds[6] = { tail[0], tail[1], tail[2], tail[3], tail[4], tail[5] };
+		visibleCount = AppendVisible(getVisibleMask(bounds), i, aCount - i, someVisibleIndicesOut, visibleCount);
+	}
+
+	return visibleCount;
+}
+
+#if SIMD_HAS_AVX2_KERNELS
+
+template <bool IsBox>
+SIMD_AVX2_TARGET __m256 Frustum::IsVisibleAVX2(const __m256 (&somePlanes)[ourPlaneCount][4], const __m256 (&someAbsoluteNormals)[ourPlaneCount][3],
+	__m256 anX, __m256 aY, __m256 aZ, __m256 anExtentX, __m256 anExtentY, __m256 anExtentZ)
+{
+	__m256 isVisible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+	for (uint32_t i = 0u; i < ourPlaneCount; ++i)
+	{
+		__m256 distance = _mm256_fmadd_ps(anX, somePlanes[i][0], _mm256_fmadd_ps(aY, somePlanes[i][1], _mm256_fmadd_ps(aZ, somePlanes[i][2], somePlanes[i][3])));
+		__m256 radius = IsBox ? _mm256_fmadd_ps(anExtentX, someAbsoluteNormals[i][0], _mm256_fmadd_ps(anExtentY, someAbsoluteNormals[i][1], _mm256_mul_ps(anExtentZ, someAbsoluteNormals[i][2]))) : anExtentX;
+		isVisible = _mm256_and_ps(isVisible, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+	}
+	return isVisible;
+}
+
+template <bool IsBox>
+SIMD_AVX2_TARGET uint32_t Frustum::CullAVX2(const float* someX, const float* someY, const float* someZ, const float* someExtentX, const float* someExtentY, const float* someExtentZ, uint32_t aCount, uint32_t* someVisibleIndicesOut) const
+{
+	__m256 planes[ourPlaneCount][4];
+	__m256 absoluteNormals[ourPlaneCount][3];
+	const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	for (uint32_t i = 0u; i < ourPlaneCount; ++i)
+	{
+		for (uint32_t j = 0u; j < 4u; ++j)
+			planes[i][j] = _mm256_set1_ps(myPlanes[i][j]);
+		for (uint32_t j = 0u; j < 3u; ++j)
+			absoluteNormals[i][j] = _mm256_and_ps(planes[i][j], signMask);
+	}
+
+	uint32_t visibleCount = 0u;
+	uint32_t i = 0u;
+	for (; i + 8u <= aCount; i += 8u)
+	{
+		__m256 isVisible = IsVisibleAVX2<IsBox>(planes, absoluteNormals, _mm256_loadu_ps(someX + i), _mm256_loadu_ps(someY + i), _mm256_loadu_ps(someZ + i), _mm256_loadu_ps(someExtentX + i),
+			IsBox ? _mm256_loadu_ps(someExtentY + i) : _mm256_setzero_ps(), IsBox ? _mm256_loadu_ps(someExtentZ + i) : _mm256_setzero_ps());
+		visibleCount = AppendVisible(static_cast<uint32_t>(_mm256_movemask_ps(isVisible)), i, 8u, someVisibleIndicesOut, visibleCount);
+	}
+
+	// Tail with masked loads, masked out elements are not read
+	if (i < aCount)
+	{
+		__m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(aCount - i)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		__m256 isVisible = IsVisibleAVX2<IsBox>(planes, absoluteNormals, _mm256_maskload_ps(someX + i, mask), _mm256_maskload_ps(someY + i, mask), _mm256_maskload_ps(someZ + i, mask), _mm256_maskload_ps(someExtentX + i, mask),
+			IsBox ? _mm256_maskload_ps(someExtentY + i, mask) : _mm256_setzero_ps(), IsBox ? _mm256_maskload_ps(someExtentZ + i, mask) : _mm256_setzero_ps());
+		visibleCount = AppendVisible(static_cast<uint32_t>(_mm256_movemask_ps(isVisible)), i, aCount - i, someVisibleIndicesOut, visibleCount);
+	}
+
+	return visibleCount;
+}
+
+#endif // SIMD_HAS_AVX2_KERNELS
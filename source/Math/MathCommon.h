@@ -1,6 +1,9 @@
 #pragma once
 
+#include "SIMDVector.h"
+
 #include <math.h>
+#include <stdint.h>
 
 namespace Math
 {
@@ -64,4 +67,147 @@ namespace Math
 	inline float Sin(const Degree& aDegree) { return sinf(aDegree.ToRadian()); }
 	inline float Tan(const Radian& aRadian) { return tanf(aRadian.myValue); }
 	inline float Tan(const Degree& aDegree) { return tanf(aDegree.ToRadian()); }
+
+	// Sine and cosine of 4 angles in radians from one range reduction. The angles are reduced by multiples of PI / 2 to
+	// [-PI / 4, PI / 4], where minimax polynomials of degree 7 and 8 take over. For |angle| <= 8192 the results are within
+	// 2 ulp of the correctly rounded ones, and 1e-7 of them next to the zeros. Bigger angles lose precision in the reduction
+	inline void SinCos(const SIMD::Vector& someAngles, SIMD::Vector& someSinesOut, SIMD::Vector& someCosinesOut)
+	{
+		SIMD::Vector quadrant = SIMD::Round(SIMD::Multiply(someAngles, 2.0f / PI));
+
+		// PI / 2 in three parts, the first two have few enough bits that their products with quadrant are exact
+		SIMD::Vector x = SIMD::MultiplyAdd(quadrant, SIMD::Load(-1.5703125f), someAngles);
+		x = SIMD::MultiplyAdd(quadrant, SIMD::Load(-4.837512969970703125e-4f), x);
+		x = SIMD::MultiplyAdd(quadrant, SIMD::Load(-7.54978995489188216e-8f), x);
+		SIMD::Vector x2 = SIMD::Multiply(x, x);
+
+		SIMD::Vector sinePolynomial = SIMD::MultiplyAdd(SIMD::MultiplyAdd(x2, SIMD::Load(-1.9515295891e-4f), SIMD::Load(8.3321608736e-3f)), x2, SIMD::Load(-1.6666654611e-1f));
+		SIMD::Vector sine = SIMD::MultiplyAdd(SIMD::Multiply(x, x2), sinePolynomial, x);
+		SIMD::Vector cosinePolynomial = SIMD::MultiplyAdd(SIMD::MultiplyAdd(x2, SIMD::Load(2.443315711809948e-5f), SIMD::Load(-1.388731625493765e-3f)), x2, SIMD::Load(4.166664568298827e-2f));
+		SIMD::Vector cosine = SIMD::MultiplyAdd(SIMD::Multiply(x2, x2), cosinePolynomial, SIMD::MultiplyAdd(x2, SIMD::Load(-0.5f), SIMD::Load(1.0f)));
+
+		// Quadrant modulo 4 in [-2, 2]. Odd quadrants swap sine and cosine, the sine is negative in 2 and 3, the cosine in 1 and 2
+		SIMD::Vector quadrantModulo = SIMD::Subtract(quadrant, SIMD::Multiply(SIMD::Round(SIMD::Multiply(quadrant, 0.25f)), 4.0f));
+		SIMD::Vector absoluteModulo = SIMD::Abs(quadrantModulo);
+		SIMD::Vector isSwapped = SIMD::CompareEqual(absoluteModulo, SIMD::Load(1.0f));
+		SIMD::Vector isHalfTurn = SIMD::CompareEqual(absoluteModulo, SIMD::Load(2.0f));
+		SIMD::Vector isSineNegative = SIMD::Or(isHalfTurn, SIMD::CompareEqual(quadrantModulo, SIMD::Load(-1.0f)));
+		SIMD::Vector isCosineNegative = SIMD::Or(isHalfTurn, SIMD::CompareEqual(quadrantModulo, SIMD::Load(1.0f)));
+
+		SIMD::Vector swappedSine = SIMD::Select(sine, cosine, isSwapped);
+		SIMD::Vector swappedCosine = SIMD::Select(cosine, sine, isSwapped);
+		someSinesOut = SIMD::Select(swappedSine, SIMD::Negate(swappedSine), isSineNegative);
+		someCosinesOut = SIMD::Select(swappedCosine, SIMD::Negate(swappedCosine), isCosineNegative);
+	}
+
+	// Quotient of SinCos, within 4 ulp of the correctly rounded result for |angle| <= 8192 away from the zeros and poles
+	inline SIMD::Vector Tan(const SIMD::Vector& someAngles)
+	{
+		SIMD::Vector sines, cosines;
+		SinCos(someAngles, sines, cosines);
+		return SIMD::Divide(sines, cosines);
+	}
+
+	inline void SinCos(const Radian& aRadian, float& aSineOut, float& aCosineOut)
+	{
+		SIMD::Vector sines, cosines;
+		SinCos(SIMD::Load(aRadian.myValue), sines, cosines);
+		aSineOut = SIMD::GetX(sines);
+		aCosineOut = SIMD::GetX(cosines);
+	}
+
+	inline void SinCos(const Degree& aDegree, float& aSineOut, float& aCosineOut) { SinCos(Radian{ aDegree }, aSineOut, aCosineOut); }
+
+#if SIMD_HAS_AVX2_KERNELS
+
+	// Same as SinCos for 8 angles, only to be called when SIMD::GetSupportedInstructionSet() is AVX2
+	SIMD_AVX2_TARGET inline void SinCos(const __m256& someAngles, __m256& someSinesOut, __m256& someCosinesOut)
+	{
+		__m256 quadrant = _mm256_round_ps(_mm256_mul_ps(someAngles, _mm256_set1_ps(2.0f / PI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+		__m256 x = _mm256_fmadd_ps(quadrant, _mm256_set1_ps(-1.5703125f), someAngles);
+		x = _mm256_fmadd_ps(quadrant, _mm256_set1_ps(-4.837512969970703125e-4f), x);
+		x = _mm256_fmadd_ps(quadrant, _mm256_set1_ps(-7.54978995489188216e-8f), x);
+		__m256 x2 = _mm256_mul_ps(x, x);
+
+		__m256 sinePolynomial = _mm256_fmadd_ps(_mm256_fmadd_ps(x2, _mm256_set1_ps(-1.9515295891e-4f), _mm256_set1_ps(8.3321608736e-3f)), x2, _mm256_set1_ps(-1.6666654611e-1f));
+		__m256 sine = _mm256_fmadd_ps(_mm256_mul_ps(x, x2), sinePolynomial, x);
+		__m256 cosinePolynomial = _mm256_fmadd_ps(_mm256_fmadd_ps(x2, _mm256_set1_ps(2.443315711809948e-5f), _mm256_set1_ps(-1.388731625493765e-3f)), x2, _mm256_set1_ps(4.166664568298827e-2f));
+		__m256 cosine = _mm256_fmadd_ps(_mm256_mul_ps(x2, x2), cosinePolynomial, _mm256_fmadd_ps(x2, _mm256_set1_ps(-0.5f), _mm256_set1_ps(1.0f)));
+
+		// Quadrant modulo 4 as an integer, bit 0 swaps sine and cosine, bit 1 negates the sine, bit 1 of quadrant + 1 negates the cosine
+		__m256i quadrantBits = _mm256_cvtps_epi32(quadrant);
+		__m256 isSwapped = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrantBits, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+		__m256 sineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrantBits, _mm256_set1_epi32(2)), 30));
+		__m256 cosineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrantBits, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+
+		someSinesOut = _mm256_xor_ps(_mm256_blendv_ps(sine, cosine, isSwapped), sineSign);
+		someCosinesOut = _mm256_xor_ps(_mm256_blendv_ps(cosine, sine, isSwapped), cosineSign);
+	}
+
+	// Array version of the above, only to be called when SIMD::GetSupportedInstructionSet() is AVX2
+	SIMD_AVX2_TARGET inline void SinCosAVX2(const float* someAngles, float* someSinesOut, float* someCosinesOut, uint32_t aCount)
+	{
+		uint32_t i = 0u;
+		for (; i + 8u <= aCount; i += 8u)
+		{
+			__m256 sines, cosines;
+			SinCos(_mm256_loadu_ps(someAngles + i), sines, cosines);
+			_mm256_storeu_ps(someSinesOut + i, sines);
+			_mm256_storeu_ps(someCosinesOut + i, cosines);
+		}
+
+		// Tail with masked loads and stores, masked out elements are neither read nor written
+		if (i < aCount)
+		{
+			__m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(aCount - i)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+			__m256 sines, cosines;
+			SinCos(_mm256_maskload_ps(someAngles + i, mask), sines, cosines);
+			_mm256_maskstore_ps(someSinesOut + i, mask, sines);
+			_mm256_maskstore_ps(someCosinesOut + i, mask, cosines);
+		}
+	}
+
+#endif // SIMD_HAS_AVX2_KERNELS
+
+	// SinCos of each element of the arrays, 8 at a time when the CPU supports AVX2. Sines and cosines can be written over the angles
+	inline void SinCos(const float* someAngles, float* someSinesOut, float* someCosinesOut, uint32_t aCount)
+	{
+#if SIMD_HAS_AVX2_KERNELS
+		if (SIMD::GetSupportedInstructionSet() == SIMD::InstructionSet::AVX2)
+		{
+			SinCosAVX2(someAngles, someSinesOut, someCosinesOut, aCount);
+			return;
+		}
+#endif // SIMD_HAS_AVX2_KERNELS
+
+		uint32_t i = 0u;
+		for (; i + 4u <= aCount; i += 4u)
+		{
+			SIMD::Vector sines, cosines;
+			SinCos(SIMD::LoadUnaligned(someAngles + i), sines, cosines);
+			SIMD::StoreUnaligned(someSinesOut + i, sines);
+			SIMD::StoreUnaligned(someCosinesOut + i, cosines);
+		}
+
+		if (i < aCount)
+		{
+			// Tail padded with zeros, so it runs through the same math as the rest of the array
+			alignas(16) float angles[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (uint32_t j = 0u; i + j < aCount; ++j)
+				angles[j] = someAngles[i + j];
+
+			SIMD::Vector sines, cosines;
+			SinCos(SIMD::Load(angles), sines, cosines);
+			alignas(16) float sineValues[4];
+			alignas(16) float cosineValues[4];
+			SIMD::Store(sineValues, sines);
+			SIMD::Store(cosineValues, cosines);
+			for (uint32_t j = 0u; i + j < aCount; ++j)
+			{
+				someSinesOut[i + j] = sineValues[j];
+				someCosinesOut[i + j] = cosineValues[j];
+			}
+		}
+	}
 }
@@ -3,6 +3,7 @@
 #include "Vector4.h"
 
 #include <math.h>
+#include <stdint.h>
 
 struct Matrix44
 {
@@ -96,8 +97,90 @@ struct Matrix44
 		return result;
 	}
 
-	inline const Vector4& operator[](unsigned int anIndex) const { return myVectors[anIndex]; }
-	inline Vector4& operator[](unsigned int anIndex) { return myVectors[anIndex]; }
+	inline Matrix44 Transpose() const
+	{
+		SIMD::Vector xy01 = SIMD::Shuffle<0, 1, 0, 1>(myXAxis.myVector, myYAxis.myVector);
+		SIMD::Vector xy23 = SIMD::Shuffle<2, 3, 2, 3>(myXAxis.myVector, myYAxis.myVector);
+		SIMD::Vector zp01 = SIMD::Shuffle<0, 1, 0, 1>(myZAxis.myVector, myPosition.myVector);
+		SIMD::Vector zp23 = SIMD::Shuffle<2, 3, 2, 3>(myZAxis.myVector, myPosition.myVector);
+
+		Matrix44 result;
+		result.myXAxis = SIMD::Shuffle<0, 2, 0, 2>(xy01, zp01);
+		result.myYAxis = SIMD::Shuffle<1, 3, 1, 3>(xy01, zp01);
+		result.myZAxis = SIMD::Shuffle<0, 2, 0, 2>(xy23, zp23);
+		result.myPosition = SIMD::Shuffle<1, 3, 1, 3>(xy23, zp23);
+		return result;
+	}
+
+	// General inverse from the cofactors of the 2x2 blocks. Singular matrices give non finite values
+	inline Matrix44 Inverse() const
+	{
+		const SIMD::Vector& X = myXAxis.myVector;
+		const SIMD::Vector& Y = myYAxis.myVector;
+		const SIMD::Vector& Z = myZAxis.myVector;
+		const SIMD::Vector& P = myPosition.myVector;
+
+		// 2x2 blocks | A B |, each stored as (m00, m01, m10, m11)
+		//            | C D |
+		SIMD::Vector A = SIMD::Shuffle<0, 1, 0, 1>(X, Y);
+		SIMD::Vector B = SIMD::Shuffle<2, 3, 2, 3>(X, Y);
+		SIMD::Vector C = SIMD::Shuffle<0, 1, 0, 1>(Z, P);
+		SIMD::Vector D = SIMD::Shuffle<2, 3, 2, 3>(Z, P);
+
+		// Determinants of the blocks as (|A|, |B|, |C|, |D|)
+		SIMD::Vector blockDeterminants = SIMD::Subtract(
+			SIMD::Multiply(SIMD::Shuffle<0, 2, 0, 2>(X, Z), SIMD::Shuffle<1, 3, 1, 3>(Y, P)),
+			SIMD::Multiply(SIMD::Shuffle<1, 3, 1, 3>(X, Z), SIMD::Shuffle<0, 2, 0, 2>(Y, P)));
+		SIMD::Vector determinantA = SIMD::Shuffle<0, 0, 0, 0>(blockDeterminants, blockDeterminants);
+		SIMD::Vector determinantB = SIMD::Shuffle<1, 1, 1, 1>(blockDeterminants, blockDeterminants);
+		SIMD::Vector determinantC = SIMD::Shuffle<2, 2, 2, 2>(blockDeterminants, blockDeterminants);
+		SIMD::Vector determinantD = SIMD::Shuffle<3, 3, 3, 3>(blockDeterminants, blockDeterminants);
+
+		// Adjugate products, # is the adjugate
+		SIMD::Vector adjugateDC = Adjugate2x2Multiply(D, C);
+		SIMD::Vector adjugateAB = Adjugate2x2Multiply(A, B);
+		SIMD::Vector blockX = SIMD::Subtract(SIMD::Multiply(determinantD, A), Multiply2x2(B, adjugateDC));
+		SIMD::Vector blockW = SIMD::Subtract(SIMD::Multiply(determinantA, D), Multiply2x2(C, adjugateAB));
+		SIMD::Vector blockY = SIMD::Subtract(SIMD::Multiply(determinantB, C), Multiply2x2Adjugate(D, adjugateAB));
+		SIMD::Vector blockZ = SIMD::Subtract(SIMD::Multiply(determinantC, B), Multiply2x2Adjugate(A, adjugateDC));
+
+		// |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+		SIMD::Vector determinant = SIMD::MultiplyAdd(determinantA, determinantD, SIMD::Multiply(determinantB, determinantC));
+		determinant = SIMD::Subtract(determinant, SIMD::Dot(adjugateAB, SIMD::Shuffle<0, 2, 1, 3>(adjugateDC, adjugateDC)));
+
+		SIMD::Vector reciprocalDeterminant = SIMD::Divide(SIMD::Load(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+		blockX = SIMD::Multiply(blockX, reciprocalDeterminant);
+		blockY = SIMD::Multiply(blockY, reciprocalDeterminant);
+		blockZ = SIMD::Multiply(blockZ, reciprocalDeterminant);
+		blockW = SIMD::Multiply(blockW, reciprocalDeterminant);
+
+		// Adjugate of the blocks and the 2x2 to 4x4 layout in one shuffle
+		Matrix44 result;
+		result.myXAxis = SIMD::Shuffle<3, 1, 3, 1>(blockX, blockY);
+		result.myYAxis = SIMD::Shuffle<2, 0, 2, 0>(blockX, blockY);
+		result.myZAxis = SIMD::Shuffle<3, 1, 3, 1>(blockZ, blockW);
+		result.myPosition = SIMD::Shuffle<2, 0, 2, 0>(blockZ, blockW);
+		return result;
+	}
+
+	// Inverse of a rotation and translation, the transposed rotation and the translation rotated back
+	inline Matrix44 InverseRigid() const
+	{
+		return InverseOrthogonal(myXAxis.myVector, myYAxis.myVector, myZAxis.myVector);
+	}
+
+	// Inverse of a rotation, a scale along each axis and a translation. Axes must be orthogonal, use Inverse for shear or projections
+	inline Matrix44 InverseAffine() const
+	{
+		return InverseOrthogonal(
+			SIMD::Divide(myXAxis.myVector, SIMD::Dot3(myXAxis.myVector, myXAxis.myVector)),
+			SIMD::Divide(myYAxis.myVector, SIMD::Dot3(myYAxis.myVector, myYAxis.myVector)),
+			SIMD::Divide(myZAxis.myVector, SIMD::Dot3(myZAxis.myVector, myZAxis.myVector)));
+	}
+
+	// Axes are laid out one after the other, see the static_assert below
+	inline const Vector4& operator[](unsigned int anIndex) const { return (&myXAxis)[anIndex]; }
+	inline Vector4& operator[](unsigned int anIndex) { return (&myXAxis)[anIndex]; }
 
 	inline static Matrix44 Translate(float aX, float aY, float aZ)
 	{
@@ -126,26 +209,262 @@ struct Matrix44
 		// need to negate the y coordinate
 		result[0][0] = 1.0f / (anAspectRatio * tanHalfFieldOfViewY);
 		result[1][1] = -1.0f / tanHalfFieldOfViewY;
-		result[2][2] = aFar / (aFar - aNear);
+		// Depth goes from 0 at the near plane to 1 at the far plane, as Vulkan clip space expects
+		result[2][2] = aFar / (aNear - aFar);
 		result[2][3] = -1.0f;
 		result[3][2] = -(aFar * aNear) / (aFar - aNear);
 
 		return result;
 	}
 
-	union
+	// Transforms aCount positions given as separate x, y and z streams, 8 at a time when the CPU supports AVX2
+	// Positions use w = 1 and directions w = 0, the resulting w is not computed so projections need operator*
+	// The outputs can be the same streams as the inputs
+	void TransformPoints(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const;
+	void TransformDirections(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const;
+	// Same as above, every stream must be 32 byte aligned
+	void TransformPointsAligned(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const;
+	void TransformDirectionsAligned(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const;
+
+	// someResultsOut[i] = someParents[i] * someLocals[i], two axes per AVX2 instruction when the CPU supports it
+	// The results can be written over either input
+	static void MultiplyBatch(const Matrix44* someParents, const Matrix44* someLocals, Matrix44* someResultsOut, uint32_t aCount);
+	// Same as above, every array must be 32 byte aligned
+	static void MultiplyBatchAligned(const Matrix44* someParents, const Matrix44* someLocals, Matrix44* someResultsOut, uint32_t aCount);
+
+	// Not in an anonymous union with an array, GCC and Clang do not allow members with constructors in anonymous structs
+	Vector4 myXAxis;
+	Vector4 myYAxis;
+	Vector4 myZAxis;
+	Vector4 myPosition;
+
+private:
+	// 2x2 matrices stored as (m00, m01, m10, m11)
+	static SIMD::Vector Multiply2x2(const SIMD::Vector& aLeft, const SIMD::Vector& aRight)
+	{
+		return SIMD::MultiplyAdd(aLeft, SIMD::Shuffle<0, 3, 0, 3>(aRight, aRight), SIMD::Multiply(SIMD::Shuffle<1, 0, 3, 2>(aLeft, aLeft), SIMD::Shuffle<2, 1, 2, 1>(aRight, aRight)));
+	}
+
+	// Adjugate of aLeft times aRight
+	static SIMD::Vector Adjugate2x2Multiply(const SIMD::Vector& aLeft, const SIMD::Vector& aRight)
+	{
+		return SIMD::Subtract(SIMD::Multiply(SIMD::Shuffle<3, 3, 0, 0>(aLeft, aLeft), aRight), SIMD::Multiply(SIMD::Shuffle<1, 1, 2, 2>(aLeft, aLeft), SIMD::Shuffle<2, 3, 0, 1>(aRight, aRight)));
+	}
+
+	// aLeft times the adjugate of aRight
+	static SIMD::Vector Multiply2x2Adjugate(const SIMD::Vector& aLeft, const SIMD::Vector& aRight)
+	{
+		return SIMD::Subtract(SIMD::Multiply(aLeft, SIMD::Shuffle<3, 0, 3, 0>(aRight, aRight)), SIMD::Multiply(SIMD::Shuffle<1, 0, 3, 2>(aLeft, aLeft), SIMD::Shuffle<2, 1, 2, 1>(aRight, aRight)));
+	}
+
+	// Inverse of an affine matrix whose 3x3 inverse is the transpose of the given axes
+	inline Matrix44 InverseOrthogonal(const SIMD::Vector& anXAxis, const SIMD::Vector& aYAxis, const SIMD::Vector& aZAxis) const
+	{
+		// Transposed with (0, 0, 0, 1) as the last axis, so the w of the axes only ends up in the discarded last row
+		SIMD::Vector last = SIMD::Load(0.0f, 0.0f, 0.0f, 1.0f);
+		SIMD::Vector xy01 = SIMD::Shuffle<0, 1, 0, 1>(anXAxis, aYAxis);
+		SIMD::Vector xy23 = SIMD::Shuffle<2, 3, 2, 3>(anXAxis, aYAxis);
+		SIMD::Vector zw01 = SIMD::Shuffle<0, 1, 0, 1>(aZAxis, last);
+		SIMD::Vector zw23 = SIMD::Shuffle<2, 3, 2, 3>(aZAxis, last);
+
+		Matrix44 result;
+		result.myXAxis = SIMD::Shuffle<0, 2, 0, 2>(xy01, zw01);
+		result.myYAxis = SIMD::Shuffle<1, 3, 1, 3>(xy01, zw01);
+		result.myZAxis = SIMD::Shuffle<0, 2, 0, 2>(xy23, zw23);
+
+		const SIMD::Vector& position = myPosition.myVector;
+		SIMD::Vector translation = SIMD::MultiplyAdd(result.myXAxis.myVector, SIMD::Shuffle<0, 0, 0, 0>(position, position), SIMD::MultiplyAdd(
+			result.myYAxis.myVector, SIMD::Shuffle<1, 1, 1, 1>(position, position), SIMD::Multiply(result.myZAxis.myVector, SIMD::Shuffle<2, 2, 2, 2>(position, position))));
+		result.myPosition = SIMD::Subtract(last, translation);
+		return result;
+	}
+
+	template <bool IsPoint, bool IsAligned>
+	void TransformBatch(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const;
+	template <bool IsAligned>
+	static void MultiplyBatch(const Matrix44* someParents, const Matrix44* someLocals, Matrix44* someResultsOut, uint32_t aCount);
+
+#if SIMD_HAS_AVX2_KERNELS
+	template <bool IsPoint, bool IsAligned>
+	SIMD_AVX2_TARGET void TransformBatchAVX2(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const;
+	template <bool IsAligned>
+	SIMD_AVX2_TARGET static void MultiplyBatchAVX2(const Matrix44* someParents, const Matrix44* someLocals, Matrix44* someResultsOut, uint32_t aCount);
+#endif // SIMD_HAS_AVX2_KERNELS
+};
+
+static_assert(sizeof(Matrix44) == 4u * sizeof(Vector4), "Matrix44 axes must be contiguous");
+
+inline void Matrix44::TransformPoints(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const
+{
+	TransformBatch<true, false>(someX, someY, someZ, someXOut, someYOut, someZOut, aCount);
+}
+
+inline void Matrix44::TransformDirections(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const
+{
+	TransformBatch<false, false>(someX, someY, someZ, someXOut, someYOut, someZOut, aCount);
+}
+
+inline void Matrix44::TransformPointsAligned(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const
+{
+	TransformBatch<true, true>(someX, someY, someZ, someXOut, someYOut, someZOut, aCount);
+}
+
+inline void Matrix44::TransformDirectionsAligned(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const
+{
+	TransformBatch<false, true>(someX, someY, someZ, someXOut, someYOut, someZOut, aCount);
+}
+
+inline void Matrix44::MultiplyBatch(const Matrix44* someParents, const Matrix44* someLocals, Matrix44* someResultsOut, uint32_t aCount)
+{
+	MultiplyBatch<false>(someParents, someLocals, someResultsOut, aCount);
+}
+
+inline void Matrix44::MultiplyBatchAligned(const Matrix44* someParents, const Matrix44* someLocals, Matrix44* someResultsOut, uint32_t aCount)
+{
+	MultiplyBatch<true>(someParents, someLocals, someResultsOut, aCount);
+}
+
+template <bool IsPoint, bool IsAligned>
+void Matrix44::TransformBatch(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const
+{
+#if SIMD_HAS_AVX2_KERNELS
+	if (SIMD::GetSupportedInstructionSet() == SIMD::InstructionSet::AVX2)
+	{
+		TransformBatchAVX2<IsPoint, IsAligned>(someX, someY, someZ, someXOut, someYOut, someZOut, aCount);
+		return;
+	}
+#endif // SIMD_HAS_AVX2_KERNELS
+
+	// 4 at a time with the compiled instruction set, 16 byte alignment is not guaranteed for the aligned variants
+	const SIMD::Vector m00 = SIMD::Load(myXAxis.x), m01 = SIMD::Load(myXAxis.y), m02 = SIMD::Load(myXAxis.z);
+	const SIMD::Vector m10 = SIMD::Load(myYAxis.x), m11 = SIMD::Load(myYAxis.y), m12 = SIMD::Load(myYAxis.z);
+	const SIMD::Vector m20 = SIMD::Load(myZAxis.x), m21 = SIMD::Load(myZAxis.y), m22 = SIMD::Load(myZAxis.z);
+	const SIMD::Vector m30 = SIMD::Load(IsPoint ? myPosition.x : 0.0f), m31 = SIMD::Load(IsPoint ? myPosition.y : 0.0f), m32 = SIMD::Load(IsPoint ? myPosition.z : 0.0f);
+
+	uint32_t i = 0u;
+	for (; i + 4u <= aCount; i += 4u)
+	{
+		SIMD::Vector x = SIMD::LoadUnaligned(someX + i);
+		SIMD::Vector y = SIMD::LoadUnaligned(someY + i);
+		SIMD::Vector z = SIMD::LoadUnaligned(someZ + i);
+
+		SIMD::StoreUnaligned(someXOut + i, SIMD::MultiplyAdd(x, m00, SIMD::MultiplyAdd(y, m10, SIMD::MultiplyAdd(z, m20, m30))));
+		SIMD::StoreUnaligned(someYOut + i, SIMD::MultiplyAdd(x, m01, SIMD::MultiplyAdd(y, m11, SIMD::MultiplyAdd(z, m21, m31))));
+		SIMD::StoreUnaligned(someZOut + i, SIMD::MultiplyAdd(x, m02, SIMD::MultiplyAdd(y, m12, SIMD::MultiplyAdd(z, m22, m32))));
+	}
+
+	for (; i < aCount; ++i)
+	{
+		float x = someX[i];
+		float y = someY[i];
+		float z = someZ[i];
+
+		someXOut[i] = x * myXAxis.x + y * myYAxis.x + z * myZAxis.x + (IsPoint ? myPosition.x : 0.0f);
+		someYOut[i] = x * myXAxis.y + y * myYAxis.y + z * myZAxis.y + (IsPoint ? myPosition.y : 0.0f);
+		someZOut[i] = x * myXAxis.z + y * myYAxis.z + z * myZAxis.z + (IsPoint ? myPosition.z : 0.0f);
+	}
+}
+
+template <bool IsAligned>
+void Matrix44::MultiplyBatch(const Matrix44* someParents, const Matrix44* someLocals, Matrix44* someResultsOut, uint32_t aCount)
+{
+#if SIMD_HAS_AVX2_KERNELS
+	if (SIMD::GetSupportedInstructionSet() == SIMD::InstructionSet::AVX2)
 	{
-		struct
+		MultiplyBatchAVX2<IsAligned>(someParents, someLocals, someResultsOut, aCount);
+		return;
+	}
+#endif // SIMD_HAS_AVX2_KERNELS
+
+	for (uint32_t i = 0u; i < aCount; ++i)
+		someResultsOut[i] = someParents[i] * someLocals[i];
+}
+
+#if SIMD_HAS_AVX2_KERNELS
+
+template <bool IsPoint, bool IsAligned>
+SIMD_AVX2_TARGET void Matrix44::TransformBatchAVX2(const float* someX, const float* someY, const float* someZ, float* someXOut, float* someYOut, float* someZOut, uint32_t aCount) const
+{
+	const __m256 m00 = _mm256_set1_ps(myXAxis.x), m01 = _mm256_set1_ps(myXAxis.y), m02 = _mm256_set1_ps(myXAxis.z);
+	const __m256 m10 = _mm256_set1_ps(myYAxis.x), m11 = _mm256_set1_ps(myYAxis.y), m12 = _mm256_set1_ps(myYAxis.z);
+	const __m256 m20 = _mm256_set1_ps(myZAxis.x), m21 = _mm256_set1_ps(myZAxis.y), m22 = _mm256_set1_ps(myZAxis.z);
+	const __m256 m30 = _mm256_set1_ps(IsPoint ? myPosition.x : 0.0f), m31 = _mm256_set1_ps(IsPoint ? myPosition.y : 0.0f), m32 = _mm256_set1_ps(IsPoint ? myPosition.z : 0.0f);
+
+	uint32_t i = 0u;
+	for (; i + 8u <= aCount; i += 8u)
+	{
+		__m256 x = IsAligned ? _mm256_load_ps(someX + i) : _mm256_loadu_ps(someX + i);
+		__m256 y = IsAligned ? _mm256_load_ps(someY + i) : _mm256_loadu_ps(someY + i);
+		__m256 z = IsAligned ? _mm256_load_ps(someZ + i) : _mm256_loadu_ps(someZ + i);
+
+		__m256 xOut = _mm256_fmadd_ps(x, m00, _mm256_fmadd_ps(y, m10, _mm256_fmadd_ps(z, m20, m30)));
+		__m256 yOut = _mm256_fmadd_ps(x, m01, _mm256_fmadd_ps(y, m11, _mm256_fmadd_ps(z, m21, m31)));
+		__m256 zOut = _mm256_fmadd_ps(x, m02, _mm256_fmadd_ps(y, m12, _mm256_fmadd_ps(z, m22, m32)));
+
+		if (IsAligned)
 		{
-			Vector4 myXAxis;
-			Vector4 myYAxis;
-			Vector4 myZAxis;
-			Vector4 myPosition;
-		};
+			_mm256_store_ps(someXOut + i, xOut);
+			_mm256_store_ps(someYOut + i, yOut);
+			_mm256_store_ps(someZOut + i, zOut);
+		}
+		else
+		{
+			_mm256_storeu_ps(someXOut + i, xOut);
+			_mm256_storeu_ps(someYOut + i, yOut);
+			_mm256_storeu_ps(someZOut + i, zOut);
+		}
+	}
 
-		struct
+	// Tail with masked loads and stores, masked out elements are neither read nor written
+	if (i < aCount)
+	{
+		__m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(aCount - i)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		__m256 x = _mm256_maskload_ps(someX + i, mask);
+		__m256 y = _mm256_maskload_ps(someY + i, mask);
+		__m256 z = _mm256_maskload_ps(someZ + i, mask);
+
+		__m256 xOut = _mm256_fmadd_ps(x, m00, _mm256_fmadd_ps(y, m10, _mm256_fmadd_ps(z, m20, m30)));
+		__m256 yOut = _mm256_fmadd_ps(x, m01, _mm256_fmadd_ps(y, m11, _mm256_fmadd_ps(z, m21, m31)));
+		__m256 zOut = _mm256_fmadd_ps(x, m02, _mm256_fmadd_ps(y, m12, _mm256_fmadd_ps(z, m22, m32)));
+
+		_mm256_maskstore_ps(someXOut + i, mask, xOut);
+		_mm256_maskstore_ps(someYOut + i, mask, yOut);
+		_mm256_maskstore_ps(someZOut + i, mask, zOut);
+	}
+}
+
+template <bool IsAligned>
+SIMD_AVX2_TARGET void Matrix44::MultiplyBatchAVX2(const Matrix44* someParents, const Matrix44* someLocals, Matrix44* someResultsOut, uint32_t aCount)
+{
+	for (uint32_t i = 0u; i < aCount; ++i)
+	{
+		// Parent axes in both halves, two local axes per register
+		const float* parent = &someParents[i].myXAxis.x;
+		const float* local = &someLocals[i].myXAxis.x;
+		__m256 X = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(parent));
+		__m256 Y = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(parent + 4));
+		__m256 Z = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(parent + 8));
+		__m256 P = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(parent + 12));
+		__m256 localXY = IsAligned ? _mm256_load_ps(local) : _mm256_loadu_ps(local);
+		__m256 localZP = IsAligned ? _mm256_load_ps(local + 8) : _mm256_loadu_ps(local + 8);
+
+		__m256 resultXY = _mm256_fmadd_ps(X, _mm256_permute_ps(localXY, 0x00), _mm256_fmadd_ps(Y, _mm256_permute_ps(localXY, 0x55),
+			_mm256_fmadd_ps(Z, _mm256_permute_ps(localXY, 0xAA), _mm256_mul_ps(P, _mm256_permute_ps(localXY, 0xFF)))));
+		__m256 resultZP = _mm256_fmadd_ps(X, _mm256_permute_ps(localZP, 0x00), _mm256_fmadd_ps(Y, _mm256_permute_ps(localZP, 0x55),
+			_mm256_fmadd_ps(Z, _mm256_permute_ps(localZP, 0xAA), _mm256_mul_ps(P, _mm256_permute_ps(localZP, 0xFF)))));
+
+		float* result = &someResultsOut[i].myXAxis.x;
+		if (IsAligned)
 		{
-			Vector4 myVectors[4];
-		};
-	};
-};
+			_mm256_store_ps(result, resultXY);
+			_mm256_store_ps(result + 8, resultZP);
+		}
+		else
+		{
+			_mm256_storeu_ps(result, resultXY);
+			_mm256_storeu_ps(result + 8, resultZP);
+		}
+	}
+}
+
+#endif // SIMD_HAS_AVX2_KERNELS
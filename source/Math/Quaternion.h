@@ -2,10 +2,14 @@
 
 #include "MathCommon.h"
 #include "Vector3.h"
+#include "Vector3A.h"
 #include "Vector4.h"
 #include "Matrix44.h"
 
-struct Quaternion
+#include <stdint.h>
+
+// 16 byte aligned so it can be loaded as a single SIMD vector
+struct alignas(16) Quaternion
 {
 	Quaternion()
 		: myAxis(0.0f)
@@ -13,69 +17,439 @@ struct Quaternion
 	{ }
 
 	Quaternion(const Vector3& anAxis, Math::Radian aRadian)
-		: myAxis(anAxis.Normalize() * Math::Sin(aRadian * 0.5f))
-		, myValue(Math::Cos(aRadian * 0.5f))
-	{ }
+	{
+		float sine, cosine;
+		Math::SinCos(aRadian * 0.5f, sine, cosine);
+		SIMD::Store(&myAxis.x, (Vector3A{ anAxis }.Normalize() * sine).ToVector4(cosine).myVector);
+	}
 
 	Quaternion(const Vector3& anAxis, Math::Degree aDegree)
-		: myAxis(anAxis.Normalize() * Math::Sin(aDegree * 0.5f))
-		, myValue(Math::Cos(aDegree * 0.5f))
+		: Quaternion(anAxis, Math::Radian{ aDegree })
 	{ }
 
 	inline Quaternion operator*(const Quaternion& aQuaternion) const
 	{
-		return Quaternion
-		{
-			myAxis.Cross(aQuaternion.myAxis) + aQuaternion.myAxis * myValue + myAxis * aQuaternion.myValue,
-			aQuaternion.myValue * myValue - myAxis.Dot(aQuaternion.myAxis)
-		};
+		// Hamilton product, each element of this quaternion scales a signed permutation of the other one
+		SIMD::Vector left = GetVector();
+		SIMD::Vector right = aQuaternion.GetVector();
+
+		SIMD::Vector result = SIMD::Multiply(SIMD::Shuffle<3, 3, 3, 3>(left, left), right);
+		result = SIMD::MultiplyAdd(SIMD::Shuffle<0, 0, 0, 0>(left, left), SIMD::Multiply(SIMD::Shuffle<3, 2, 1, 0>(right, right), SIMD::Load(1.0f, -1.0f, 1.0f, -1.0f)), result);
+		result = SIMD::MultiplyAdd(SIMD::Shuffle<1, 1, 1, 1>(left, left), SIMD::Multiply(SIMD::Shuffle<2, 3, 0, 1>(right, right), SIMD::Load(1.0f, 1.0f, -1.0f, -1.0f)), result);
+		result = SIMD::MultiplyAdd(SIMD::Shuffle<2, 2, 2, 2>(left, left), SIMD::Multiply(SIMD::Shuffle<1, 0, 3, 2>(right, right), SIMD::Load(-1.0f, 1.0f, 1.0f, -1.0f)), result);
+
+		return Quaternion{ result };
 	}
 
-	inline Quaternion Conjugate() const { return Quaternion{ -myAxis, myValue }; }
+	inline Quaternion Conjugate() const { return Quaternion{ SIMD::Multiply(GetVector(), SIMD::Load(-1.0f, -1.0f, -1.0f, 1.0f)) }; }
+	inline float Dot(const Quaternion& aQuaternion) const { return SIMD::GetX(SIMD::Dot(GetVector(), aQuaternion.GetVector())); }
+	inline Quaternion Normalize() const
+	{
+		SIMD::Vector vector = GetVector();
+		return Quaternion{ SIMD::Multiply(vector, SIMD::ReciprocalSqrt(SIMD::Dot(vector, vector))) };
+	}
 
+	// Axis in the first three elements, value in the last one
+	inline SIMD::Vector GetVector() const { return SIMD::Load(&myAxis.x); }
+	// Rotation axis scaled by the sine of half the angle
+	inline Vector3A GetAxis() const { return GetVector(); }
+
+	// v + 2w(q x v) + 2q x (q x v), cheaper than building the matrix to rotate a few vectors
+	inline Vector3A Rotate(const Vector3A& aVector) const
+	{
+		Vector3A axis = GetAxis();
+		Vector3A doubledCross = axis.Cross(aVector) * 2.0f;
+		return aVector + doubledCross * myValue + axis.Cross(doubledCross);
+	}
+
+	// Elements are within 2e-7 of the exact rotation matrix of a unit quaternion
 	inline Matrix44 GetMatrix() const
 	{
-		// TODO: This can be optimized
-		Vector3 axisSquared{ myAxis.x * myAxis.x, myAxis.y * myAxis.y, myAxis.z * myAxis.z };
-		float xy = x * y;
-		float xz = x * z;
-		float yz = y * z;
-		float wx = w * x;
-		float wy = w * y;
-		float wz = w * z;
+		// Each axis is a row of the identity plus two signed products of the elements with their doubles
+		SIMD::Vector vector = GetVector();
+		SIMD::Vector doubled = SIMD::Add(vector, vector);
 
-		return Matrix44
-		{
-			1.0f - 2.0f * (axisSquared.y + axisSquared.z), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f,
-			2.0f * (xy - wz), 1.0f - 2.0f * (axisSquared.x + axisSquared.z), 2.0f * (yz + wx), 0.0f,
-			2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (axisSquared.x + axisSquared.y), 0.0f,
-			0.0f, 0.0f, 0.0f, 1.0f
-		};
+		Matrix44 result;
+		result.myXAxis = SIMD::MultiplyAdd(SIMD::Multiply(SIMD::Shuffle<1, 0, 0, 3>(vector, vector), SIMD::Shuffle<1, 1, 2, 3>(doubled, doubled)), SIMD::Load(-1.0f, 1.0f, 1.0f, 0.0f),
+			SIMD::MultiplyAdd(SIMD::Multiply(SIMD::Shuffle<2, 3, 3, 3>(vector, vector), SIMD::Shuffle<2, 2, 1, 3>(doubled, doubled)), SIMD::Load(-1.0f, 1.0f, -1.0f, 0.0f), SIMD::Load(1.0f, 0.0f, 0.0f, 0.0f)));
+		result.myYAxis = SIMD::MultiplyAdd(SIMD::Multiply(SIMD::Shuffle<0, 0, 1, 3>(vector, vector), SIMD::Shuffle<1, 0, 2, 3>(doubled, doubled)), SIMD::Load(1.0f, -1.0f, 1.0f, 0.0f),
+			SIMD::MultiplyAdd(SIMD::Multiply(SIMD::Shuffle<3, 2, 3, 3>(vector, vector), SIMD::Shuffle<2, 2, 0, 3>(doubled, doubled)), SIMD::Load(-1.0f, -1.0f, 1.0f, 0.0f), SIMD::Load(0.0f, 1.0f, 0.0f, 0.0f)));
+		result.myZAxis = SIMD::MultiplyAdd(SIMD::Multiply(SIMD::Shuffle<0, 1, 0, 3>(vector, vector), SIMD::Shuffle<2, 2, 0, 3>(doubled, doubled)), SIMD::Load(1.0f, 1.0f, -1.0f, 0.0f),
+			SIMD::MultiplyAdd(SIMD::Multiply(SIMD::Shuffle<3, 3, 1, 3>(vector, vector), SIMD::Shuffle<1, 0, 1, 3>(doubled, doubled)), SIMD::Load(1.0f, -1.0f, -1.0f, 0.0f), SIMD::Load(0.0f, 0.0f, 1.0f, 0.0f)));
+		result.myPosition = SIMD::Load(0.0f, 0.0f, 0.0f, 1.0f);
+		return result;
 	}
 
-	union
+	// Normalized linear interpolation along the shortest arc, cheaper than Slerp but the angular speed is not constant
+	inline static Quaternion Nlerp(const Quaternion& aFrom, const Quaternion& aTo, float aFactor)
 	{
-		struct
-		{
-			float x;
-			float y;
-			float z;
-			float w;
-		};
+		SIMD::Vector from = aFrom.GetVector();
+		SIMD::Vector to = aTo.GetVector();
+		SIMD::Vector factor = SIMD::Load(aFactor);
 
-		struct
-		{
-			Vector3 myAxis;
-			float myValue;
-		};
+		// q and -q are the same rotation, the one closer to aFrom gives the shortest arc
+		SIMD::Vector toFactor = SIMD::Select(factor, SIMD::Negate(factor), SIMD::CompareLess(SIMD::Dot(from, to), SIMD::Load(0.0f)));
+		SIMD::Vector result = SIMD::MultiplyAdd(to, toFactor, SIMD::Multiply(from, SIMD::Load(1.0f - aFactor)));
+		return Quaternion{ SIMD::Multiply(result, SIMD::ReciprocalSqrt(SIMD::Dot(result, result))) };
+	}
 
-		Vector4 myVector;
+	// Spherical linear interpolation along the shortest arc, reference for SlerpBatch
+	inline static Quaternion Slerp(const Quaternion& aFrom, const Quaternion& aTo, float aFactor)
+	{
+		float cosAngle = aFrom.Dot(aTo);
+		float toSign = cosAngle < 0.0f ? -1.0f : 1.0f;
+		cosAngle *= toSign;
+
+		// sin(angle) gets too small to divide by, the arc is close enough to a line
+		if (cosAngle > 0.9995f)
+			return Nlerp(aFrom, aTo, aFactor);
+
+		float angle = acosf(cosAngle);
+		float reciprocalSin = 1.0f / sinf(angle);
+		SIMD::Vector fromFactor = SIMD::Load(sinf((1.0f - aFactor) * angle) * reciprocalSin);
+		SIMD::Vector toFactor = SIMD::Load(sinf(aFactor * angle) * reciprocalSin * toSign);
+		return Quaternion{ SIMD::MultiplyAdd(aTo.GetVector(), toFactor, SIMD::Multiply(aFrom.GetVector(), fromFactor)) };
+	}
+
+	// Structure of arrays of quaternions, element i of every array makes quaternion i
+	struct Stream
+	{
+		float* myX;
+		float* myY;
+		float* myZ;
+		float* myW;
 	};
 
+	struct ConstStream
+	{
+		ConstStream(const float* someX, const float* someY, const float* someZ, const float* someW)
+			: myX(someX), myY(someY), myZ(someZ), myW(someW)
+		{ }
+
+		ConstStream(const Stream& aStream)
+			: myX(aStream.myX), myY(aStream.myY), myZ(aStream.myZ), myW(aStream.myW)
+		{ }
+
+		const float* myX;
+		const float* myY;
+		const float* myZ;
+		const float* myW;
+	};
+
+	// Batch operations work on 4 quaternions at a time with the compiled instruction set.
+	// Results can be written over the inputs
+
+	// Same error as GetMatrix, the 9 products are shared by 4 quaternions
+	static void ToMatrices(const Quaternion* someQuaternions, Matrix44* someMatricesOut, uint32_t aCount);
+	// Elements are within 3e-7 of the exact result and of Normalize
+	static void NormalizeBatch(const ConstStream& someQuaternions, const Stream& someResultsOut, uint32_t aCount);
+	// Elements are within 3e-7 of the exact result and of Nlerp for unit quaternions
+	static void NlerpBatch(const ConstStream& someFrom, const ConstStream& someTo, float aFactor, const Stream& someResultsOut, uint32_t aCount);
+	// Polynomial approximation without trigonometry (Eberly, A Fast and Accurate Algorithm for Computing SLERP).
+	// Elements are within 1.5e-6 of the exact result and of Slerp for unit quaternions, results are not renormalized
+	static void SlerpBatch(const ConstStream& someFrom, const ConstStream& someTo, float aFactor, const Stream& someResultsOut, uint32_t aCount);
+
+	// Not in an anonymous union with x, y, z and w, GCC and Clang do not allow members with constructors in anonymous structs
+	Vector3 myAxis;
+	float myValue;
+
 private:
-	// Needed for conjugate, do not provide this to the users
-	Quaternion(const Vector3& aAxis, float aValue)
-		: myAxis(aAxis)
-		, myValue(aValue)
-	{ }
+	// Needed for the SIMD operations, do not provide this to the users
+	explicit Quaternion(const SIMD::Vector& aVector)
+	{
+		SIMD::Store(&myAxis.x, aVector);
+	}
+
+	// 4 quaternions of a stream, one element per vector
+	struct Block
+	{
+		SIMD::Vector myX;
+		SIMD::Vector myY;
+		SIMD::Vector myZ;
+		SIMD::Vector myW;
+	};
+
+#if SIMD_HAS_AVX2_KERNELS
+	// Converts 8 quaternions at a time, returns how many were converted
+	SIMD_AVX2_TARGET static uint32_t ToMatricesAVX2(const Quaternion* someQuaternions, Matrix44* someMatricesOut, uint32_t aCount);
+	// Transpose of the 4x4 matrix in each half
+	SIMD_AVX2_TARGET static void TransposeAVX2(__m256& aVector0, __m256& aVector1, __m256& aVector2, __m256& aVector3);
+#endif // SIMD_HAS_AVX2_KERNELS
+
+	static void Transpose(SIMD::Vector& aVector0, SIMD::Vector& aVector1, SIMD::Vector& aVector2, SIMD::Vector& aVector3);
+	static Block LoadBlock(const ConstStream& aStream, uint32_t anIndex, uint32_t aCount);
+	static void StoreBlock(const Stream& aStream, uint32_t anIndex, uint32_t aCount, const Block& aBlock);
+	static SIMD::Vector Dot(const Block& aLeft, const Block& aRight);
+	static Block NormalizeBlock(const Block& aBlock);
+	// aLeft * aLeftFactor + aRight * aRightFactor
+	static Block CombineBlocks(const Block& aLeft, const SIMD::Vector& aLeftFactor, const Block& aRight, const SIMD::Vector& aRightFactor);
 };
+
+static_assert(sizeof(Quaternion) == 4u * sizeof(float), "Quaternion must be loadable as a single SIMD vector");
+
+inline void Quaternion::ToMatrices(const Quaternion* someQuaternions, Matrix44* someMatricesOut, uint32_t aCount)
+{
+	const SIMD::Vector one = SIMD::Load(1.0f);
+	const SIMD::Vector zero = SIMD::Load(0.0f);
+	const SIMD::Vector position = SIMD::Load(0.0f, 0.0f, 0.0f, 1.0f);
+
+	uint32_t i = 0u;
+#if SIMD_HAS_AVX2_KERNELS
+	if (SIMD::GetSupportedInstructionSet() == SIMD::InstructionSet::AVX2)
+		i = ToMatricesAVX2(someQuaternions, someMatricesOut, aCount);
+#endif // SIMD_HAS_AVX2_KERNELS
+
+	for (; i + 4u <= aCount; i += 4u)
+	{
+		// One element of the 4 quaternions per vector
+		SIMD::Vector x = someQuaternions[i].GetVector();
+		SIMD::Vector y = someQuaternions[i + 1u].GetVector();
+		SIMD::Vector z = someQuaternions[i + 2u].GetVector();
+		SIMD::Vector w = someQuaternions[i + 3u].GetVector();
+		Transpose(x, y, z, w);
+
+		SIMD::Vector x2 = SIMD::Add(x, x);
+		SIMD::Vector y2 = SIMD::Add(y, y);
+		SIMD::Vector z2 = SIMD::Add(z, z);
+		SIMD::Vector xx = SIMD::Multiply(x, x2), yy = SIMD::Multiply(y, y2), zz = SIMD::Multiply(z, z2);
+		SIMD::Vector xy = SIMD::Multiply(x, y2), xz = SIMD::Multiply(x, z2), yz = SIMD::Multiply(y, z2);
+		SIMD::Vector wx = SIMD::Multiply(w, x2), wy = SIMD::Multiply(w, y2), wz = SIMD::Multiply(w, z2);
+
+		// Transposed back, each vector is an axis of one matrix
+		SIMD::Vector xAxes[4] = { SIMD::Subtract(SIMD::Subtract(one, yy), zz), SIMD::Add(xy, wz), SIMD::Subtract(xz, wy), zero };
+		SIMD::Vector yAxes[4] = { SIMD::Subtract(xy, wz), SIMD::Subtract(SIMD::Subtract(one, xx), zz), SIMD::Add(yz, wx), zero };
+		SIMD::Vector zAxes[4] = { SIMD::Add(xz, wy), SIMD::Subtract(yz, wx), SIMD::Subtract(SIMD::Subtract(one, xx), yy), zero };
+		Transpose(xAxes[0], xAxes[1], xAxes[2], xAxes[3]);
+		Transpose(yAxes[0], yAxes[1], yAxes[2], yAxes[3]);
+		Transpose(zAxes[0], zAxes[1], zAxes[2], zAxes[3]);
+
+		for (uint32_t j = 0u; j < 4u; ++j)
+		{
+			Matrix44& matrix = someMatricesOut[i + j];
+			matrix.myXAxis = xAxes[j];
+			matrix.myYAxis = yAxes[j];
+			matrix.myZAxis = zAxes[j];
+			matrix.myPosition = position;
+		}
+	}
+
+	for (; i < aCount; ++i)
+		someMatricesOut[i] = someQuaternions[i].GetMatrix();
+}
+
+inline void Quaternion::NormalizeBatch(const ConstStream& someQuaternions, const Stream& someResultsOut, uint32_t aCount)
+{
+	for (uint32_t i = 0u; i < aCount; i += 4u)
+		StoreBlock(someResultsOut, i, aCount, NormalizeBlock(LoadBlock(someQuaternions, i, aCount)));
+}
+
+inline void Quaternion::NlerpBatch(const ConstStream& someFrom, const ConstStream& someTo, float aFactor, const Stream& someResultsOut, uint32_t aCount)
+{
+	const SIMD::Vector zero = SIMD::Load(0.0f);
+	const SIMD::Vector fromFactor = SIMD::Load(1.0f - aFactor);
+	const SIMD::Vector toFactor = SIMD::Load(aFactor);
+	const SIMD::Vector negatedToFactor = SIMD::Negate(toFactor);
+
+	for (uint32_t i = 0u; i < aCount; i += 4u)
+	{
+		Block from = LoadBlock(someFrom, i, aCount);
+		Block to = LoadBlock(someTo, i, aCount);
+
+		SIMD::Vector signedToFactor = SIMD::Select(toFactor, negatedToFactor, SIMD::CompareLess(Dot(from, to), zero));
+		StoreBlock(someResultsOut, i, aCount, NormalizeBlock(CombineBlocks(from, fromFactor, to, signedToFactor)));
+	}
+}
+
+inline void Quaternion::SlerpBatch(const ConstStream& someFrom, const ConstStream& someTo, float aFactor, const Stream& someResultsOut, uint32_t aCount)
+{
+	// sin(t * angle) / sin(angle) as a series in cos(angle) - 1, truncated after 12 terms with the last one scaled by
+	// mu to spread the error over [0, 1]. Term i is (u * t^2 - v) with u = 1 / ((i + 1)(2i + 3)) and v = (i + 1) / (2i + 3),
+	// so the terms only depend on the interpolation factor. 8 terms leave errors of 2e-5
+	constexpr uint32_t termCount = 12u;
+	constexpr float mu = 1.8938f;
+	const float fromFactor = 1.0f - aFactor;
+	SIMD::Vector fromTerms[termCount];
+	SIMD::Vector toTerms[termCount];
+	for (uint32_t i = 0u; i < termCount; ++i)
+	{
+		float scale = i + 1u == termCount ? mu : 1.0f;
+		float u = scale / static_cast<float>((i + 1u) * (2u * i + 3u));
+		float v = scale * static_cast<float>(i + 1u) / static_cast<float>(2u * i + 3u);
+		fromTerms[i] = SIMD::Load(u * fromFactor * fromFactor - v);
+		toTerms[i] = SIMD::Load(u * aFactor * aFactor - v);
+	}
+
+	const SIMD::Vector zero = SIMD::Load(0.0f);
+	const SIMD::Vector one = SIMD::Load(1.0f);
+	const SIMD::Vector fromScale = SIMD::Load(fromFactor);
+	const SIMD::Vector toScale = SIMD::Load(aFactor);
+
+	for (uint32_t i = 0u; i < aCount; i += 4u)
+	{
+		Block from = LoadBlock(someFrom, i, aCount);
+		Block to = LoadBlock(someTo, i, aCount);
+
+		// Shortest arc, the cosine of the angle of the arc is positive
+		SIMD::Vector cosAngle = Dot(from, to);
+		SIMD::Vector isLongArc = SIMD::CompareLess(cosAngle, zero);
+		SIMD::Vector cosAngleMinusOne = SIMD::Subtract(SIMD::Abs(cosAngle), one);
+
+		SIMD::Vector fromSeries = one;
+		SIMD::Vector toSeries = one;
+		for (uint32_t term = termCount; term-- > 0u;)
+		{
+			fromSeries = SIMD::MultiplyAdd(SIMD::Multiply(fromTerms[term], cosAngleMinusOne), fromSeries, one);
+			toSeries = SIMD::MultiplyAdd(SIMD::Multiply(toTerms[term], cosAngleMinusOne), toSeries, one);
+		}
+
+		SIMD::Vector toWeight = SIMD::Multiply(toScale, toSeries);
+		toWeight = SIMD::Select(toWeight, SIMD::Negate(toWeight), isLongArc);
+		StoreBlock(someResultsOut, i, aCount, CombineBlocks(from, SIMD::Multiply(fromScale, fromSeries), to, toWeight));
+	}
+}
+
+inline void Quaternion::Transpose(SIMD::Vector& aVector0, SIMD::Vector& aVector1, SIMD::Vector& aVector2, SIMD::Vector& aVector3)
+{
+	SIMD::Vector low01 = SIMD::Shuffle<0, 1, 0, 1>(aVector0, aVector1);
+	SIMD::Vector high01 = SIMD::Shuffle<2, 3, 2, 3>(aVector0, aVector1);
+	SIMD::Vector low23 = SIMD::Shuffle<0, 1, 0, 1>(aVector2, aVector3);
+	SIMD::Vector high23 = SIMD::Shuffle<2, 3, 2, 3>(aVector2, aVector3);
+	aVector0 = SIMD::Shuffle<0, 2, 0, 2>(low01, low23);
+	aVector1 = SIMD::Shuffle<1, 3, 1, 3>(low01, low23);
+	aVector2 = SIMD::Shuffle<0, 2, 0, 2>(high01, high23);
+	aVector3 = SIMD::Shuffle<1, 3, 1, 3>(high01, high23);
+}
+
+inline Quaternion::Block Quaternion::LoadBlock(const ConstStream& aStream, uint32_t anIndex, uint32_t aCount)
+{
+	if (anIndex + 4u <= aCount)
+		return Block{ SIMD::LoadUnaligned(aStream.myX + anIndex), SIMD::LoadUnaligned(aStream.myY + anIndex), SIMD::LoadUnaligned(aStream.myZ + anIndex), SIMD::LoadUnaligned(aStream.myW + anIndex) };
+
+	// Tail padded with identities, so it runs through the same math as the rest of the stream
+	alignas(16) float x[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	alignas(16) float y[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	alignas(16) float z[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	alignas(16) float w[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	for (uint32_t i = 0u; anIndex + i < aCount; ++i)
+	{
+		x[i] = aStream.myX[anIndex + i];
+		y[i] = aStream.myY[anIndex + i];
+		z[i] = aStream.myZ[anIndex + i];
+		w[i] = aStream.myW[anIndex + i];
+	}
+
+	return Block{ SIMD::Load(x), SIMD::Load(y), SIMD::Load(z), SIMD::Load(w) };
+}
+
+inline void Quaternion::StoreBlock(const Stream& aStream, uint32_t anIndex, uint32_t aCount, const Block& aBlock)
+{
+	if (anIndex + 4u <= aCount)
+	{
+		SIMD::StoreUnaligned(aStream.myX + anIndex, aBlock.myX);
+		SIMD::StoreUnaligned(aStream.myY + anIndex, aBlock.myY);
+		SIMD::StoreUnaligned(aStream.myZ + anIndex, aBlock.myZ);
+		SIMD::StoreUnaligned(aStream.myW + anIndex, aBlock.myW);
+		return;
+	}
+
+	alignas(16) float x[4];
+	alignas(16) float y[4];
+	alignas(16) float z[4];
+	alignas(16) float w[4];
+	SIMD::Store(x, aBlock.myX);
+	SIMD::Store(y, aBlock.myY);
+	SIMD::Store(z, aBlock.myZ);
+	SIMD::Store(w, aBlock.myW);
+	for (uint32_t i = 0u; anIndex + i < aCount; ++i)
+	{
+		aStream.myX[anIndex + i] = x[i];
+		aStream.myY[anIndex + i] = y[i];
+		aStream.myZ[anIndex + i] = z[i];
+		aStream.myW[anIndex + i] = w[i];
+	}
+}
+
+inline SIMD::Vector Quaternion::Dot(const Block& aLeft, const Block& aRight)
+{
+	return SIMD::MultiplyAdd(aLeft.myX, aRight.myX, SIMD::MultiplyAdd(aLeft.myY, aRight.myY, SIMD::MultiplyAdd(aLeft.myZ, aRight.myZ, SIMD::Multiply(aLeft.myW, aRight.myW))));
+}
+
+inline Quaternion::Block Quaternion::NormalizeBlock(const Block& aBlock)
+{
+	SIMD::Vector reciprocalLength = SIMD::ReciprocalSqrt(Dot(aBlock, aBlock));
+	return Block{ SIMD::Multiply(aBlock.myX, reciprocalLength), SIMD::Multiply(aBlock.myY, reciprocalLength), SIMD::Multiply(aBlock.myZ, reciprocalLength), SIMD::Multiply(aBlock.myW, reciprocalLength) };
+}
+
+inline Quaternion::Block Quaternion::CombineBlocks(const Block& aLeft, const SIMD::Vector& aLeftFactor, const Block& aRight, const SIMD::Vector& aRightFactor)
+{
+	return Block{
+		SIMD::MultiplyAdd(aRight.myX, aRightFactor, SIMD::Multiply(aLeft.myX, aLeftFactor)),
+		SIMD::MultiplyAdd(aRight.myY, aRightFactor, SIMD::Multiply(aLeft.myY, aLeftFactor)),
+		SIMD::MultiplyAdd(aRight.myZ, aRightFactor, SIMD::Multiply(aLeft.myZ, aLeftFactor)),
+		SIMD::MultiplyAdd(aRight.myW, aRightFactor, SIMD::Multiply(aLeft.myW, aLeftFactor)) };
+}
+
+#if SIMD_HAS_AVX2_KERNELS
+
+SIMD_AVX2_TARGET inline void Quaternion::TransposeAVX2(__m256& aVector0, __m256& aVector1, __m256& aVector2, __m256& aVector3)
+{
+	__m256 low01 = _mm256_shuffle_ps(aVector0, aVector1, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 high01 = _mm256_shuffle_ps(aVector0, aVector1, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 low23 = _mm256_shuffle_ps(aVector2, aVector3, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 high23 = _mm256_shuffle_ps(aVector2, aVector3, _MM_SHUFFLE(3, 2, 3, 2));
+	aVector0 = _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(2, 0, 2, 0));
+	aVector1 = _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(3, 1, 3, 1));
+	aVector2 = _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(2, 0, 2, 0));
+	aVector3 = _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+SIMD_AVX2_TARGET inline uint32_t Quaternion::ToMatricesAVX2(const Quaternion* someQuaternions, Matrix44* someMatricesOut, uint32_t aCount)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m128 position = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+	uint32_t i = 0u;
+	for (; i + 8u <= aCount; i += 8u)
+	{
+		// Same as the 4 wide loop, quaternion i + j in the low half and i + j + 4 in the high half
+		const float* quaternions = &someQuaternions[i].myAxis.x;
+		__m256 x = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(quaternions)), _mm_load_ps(quaternions + 16), 1);
+		__m256 y = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(quaternions + 4)), _mm_load_ps(quaternions + 20), 1);
+		__m256 z = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(quaternions + 8)), _mm_load_ps(quaternions + 24), 1);
+		__m256 w = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(quaternions + 12)), _mm_load_ps(quaternions + 28), 1);
+		TransposeAVX2(x, y, z, w);
+
+		__m256 x2 = _mm256_add_ps(x, x);
+		__m256 y2 = _mm256_add_ps(y, y);
+		__m256 z2 = _mm256_add_ps(z, z);
+		__m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+		__m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+		__m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+
+		__m256 xAxes[4] = { _mm256_sub_ps(_mm256_sub_ps(one, yy), zz), _mm256_add_ps(xy, wz), _mm256_sub_ps(xz, wy), zero };
+		__m256 yAxes[4] = { _mm256_sub_ps(xy, wz), _mm256_sub_ps(_mm256_sub_ps(one, xx), zz), _mm256_add_ps(yz, wx), zero };
+		__m256 zAxes[4] = { _mm256_add_ps(xz, wy), _mm256_sub_ps(yz, wx), _mm256_sub_ps(_mm256_sub_ps(one, xx), yy), zero };
+		TransposeAVX2(xAxes[0], xAxes[1], xAxes[2], xAxes[3]);
+		TransposeAVX2(yAxes[0], yAxes[1], yAxes[2], yAxes[3]);
+		TransposeAVX2(zAxes[0], zAxes[1], zAxes[2], zAxes[3]);
+
+		for (uint32_t j = 0u; j < 4u; ++j)
+		{
+			float* low = &someMatricesOut[i + j].myXAxis.x;
+			float* high = &someMatricesOut[i + j + 4u].myXAxis.x;
+			_mm_store_ps(low, _mm256_castps256_ps128(xAxes[j]));
+			_mm_store_ps(low + 4, _mm256_castps256_ps128(yAxes[j]));
+			_mm_store_ps(low + 8, _mm256_castps256_ps128(zAxes[j]));
+			_mm_store_ps(low + 12, position);
+			_mm_store_ps(high, _mm256_extractf128_ps(xAxes[j], 1));
+			_mm_store_ps(high + 4, _mm256_extractf128_ps(yAxes[j], 1));
+			_mm_store_ps(high + 8, _mm256_extractf128_ps(zAxes[j], 1));
+			_mm_store_ps(high + 12, position);
+		}
+	}
+
+	return i;
+}
+
+#endif // SIMD_HAS_AVX2_KERNELS
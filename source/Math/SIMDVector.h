@@ -2,25 +2,155 @@
 
 #include "GlobalDefines.h"
 
-#if IS_WINDOWS_PLATFORM
+// Instruction set the SIMD functions are compiled for, picked at compile time:
+// - AVX2: AVX2 and FMA. Windows builds always used FMA, other compilers need -mavx2 -mfma
+// - SSE4_1: 128 bit vectors without FMA, MultiplyAdd is a multiply and an add. Needs -msse4.1
+// - SSE2: same as SSE4_1, with dot products, rounding and selection built from SSE2 instructions. Default for
+//   x86-64 compilers without -msse4.1
+// - SCALAR: plain floats, also forced with DBZ_SIMD_SCALAR
+// Batch functions built for a wider instruction set than this one check GetSupportedInstructionSet at runtime
+#define SIMD_INSTRUCTION_SET_SCALAR 0
+#define SIMD_INSTRUCTION_SET_SSE2 1
+#define SIMD_INSTRUCTION_SET_SSE4_1 2
+#define SIMD_INSTRUCTION_SET_AVX2 3
+
+#if defined(DBZ_SIMD_SCALAR)
+#define SIMD_INSTRUCTION_SET SIMD_INSTRUCTION_SET_SCALAR
+#elif IS_WINDOWS_PLATFORM || (defined(__AVX2__) && defined(__FMA__))
+#define SIMD_INSTRUCTION_SET SIMD_INSTRUCTION_SET_AVX2
+#elif defined(__SSE4_1__)
+#define SIMD_INSTRUCTION_SET SIMD_INSTRUCTION_SET_SSE4_1
+#elif defined(__SSE2__)
+#define SIMD_INSTRUCTION_SET SIMD_INSTRUCTION_SET_SSE2
+#else
+#define SIMD_INSTRUCTION_SET SIMD_INSTRUCTION_SET_SCALAR
+#endif // DBZ_SIMD_SCALAR
+
+// 8 wide AVX2 batch kernels are compiled whenever the compiler can target AVX2 for single functions, and are only
+// called when GetSupportedInstructionSet returns AVX2. Functions using them must be marked with SIMD_AVX2_TARGET
+#if !defined(DBZ_SIMD_SCALAR) && (IS_WINDOWS_PLATFORM || (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))))
+#define SIMD_HAS_AVX2_KERNELS 1
+#else
+#define SIMD_HAS_AVX2_KERNELS 0
+#endif // !DBZ_SIMD_SCALAR
+
+#if SIMD_HAS_AVX2_KERNELS && !IS_WINDOWS_PLATFORM
+#define SIMD_AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+#define SIMD_AVX2_TARGET
+#endif // SIMD_HAS_AVX2_KERNELS && !IS_WINDOWS_PLATFORM
 
-#include <xmmintrin.h>
+#if SIMD_INSTRUCTION_SET != SIMD_INSTRUCTION_SET_SCALAR || SIMD_HAS_AVX2_KERNELS
 #include <immintrin.h>
+#include <smmintrin.h>
+#endif // SIMD_INSTRUCTION_SET != SIMD_INSTRUCTION_SET_SCALAR || SIMD_HAS_AVX2_KERNELS
+
+#if SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SCALAR
+#include <cstring>
+#include <math.h>
+#include <stdint.h>
+#endif // SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SCALAR
+
+#if IS_WINDOWS_PLATFORM
+#include <intrin.h>
+#endif // IS_WINDOWS_PLATFORM
 
 namespace SIMD
 {
+	enum class InstructionSet
+	{
+		SCALAR = SIMD_INSTRUCTION_SET_SCALAR,
+		SSE2 = SIMD_INSTRUCTION_SET_SSE2,
+		SSE4_1 = SIMD_INSTRUCTION_SET_SSE4_1,
+		AVX2 = SIMD_INSTRUCTION_SET_AVX2
+	};
+
+	constexpr InstructionSet ourCompiledInstructionSet = static_cast<InstructionSet>(SIMD_INSTRUCTION_SET);
+
+	// Best instruction set the running CPU and OS support, checked once
+	inline InstructionSet GetSupportedInstructionSet()
+	{
+		static const InstructionSet supportedInstructionSet = []()
+		{
+#if IS_WINDOWS_PLATFORM
+			int registers[4];
+			__cpuid(registers, 0);
+			int maxLeaf = registers[0];
+
+			__cpuid(registers, 1);
+			bool hasSSE2 = (registers[3] & (1 << 26)) != 0;
+			bool hasSSE41 = (registers[2] & (1 << 19)) != 0;
+			bool hasFMA = (registers[2] & (1 << 12)) != 0;
+			// The OS has to save the ymm registers on context switches
+			bool hasOSXSave = (registers[2] & (1 << 27)) != 0;
+			bool hasYmmState = hasOSXSave && (_xgetbv(0) & 0x6u) == 0x6u;
+
+			bool hasAVX2 = false;
+			if (maxLeaf >= 7)
+			{
+				__cpuidex(registers, 7, 0);
+				hasAVX2 = (registers[1] & (1 << 5)) != 0;
+			}
+
+			if (hasAVX2 && hasFMA && hasYmmState)
+				return InstructionSet::AVX2;
+			if (hasSSE41)
+				return InstructionSet::SSE4_1;
+			return hasSSE2 ? InstructionSet::SSE2 : InstructionSet::SCALAR;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+				return InstructionSet::AVX2;
+			if (__builtin_cpu_supports("sse4.1"))
+				return InstructionSet::SSE4_1;
+			return __builtin_cpu_supports("sse2") ? InstructionSet::SSE2 : InstructionSet::SCALAR;
+#else
+			return InstructionSet::SCALAR;
+#endif // IS_WINDOWS_PLATFORM
+		}();
+
+		return supportedInstructionSet;
+	}
+
+#if SIMD_INSTRUCTION_SET != SIMD_INSTRUCTION_SET_SCALAR
+
 	using Vector = __m128;
 
 	inline Vector Load(float aX, float aY, float aZ, float aW)
 	{
-		alignas(16) float vector[] = { aX, aY, aZ, aW };
-		return _mm_load_ps(vector);
+		return _mm_setr_ps(aX, aY, aZ, aW);
 	}
 
 	inline Vector Load(float aValue)
 	{
-		alignas(16) float vector[] = { aValue, aValue, aValue, aValue };
-		return _mm_load_ps(vector);
+		return _mm_set1_ps(aValue);
+	}
+
+	// someValues must be 16 byte aligned
+	inline Vector Load(const float* someValues)
+	{
+		return _mm_load_ps(someValues);
+	}
+
+	inline Vector LoadUnaligned(const float* someValues)
+	{
+		return _mm_loadu_ps(someValues);
+	}
+
+	// someValuesOut must be 16 byte aligned
+	inline void Store(float* someValuesOut, const Vector& aVector)
+	{
+		_mm_store_ps(someValuesOut, aVector);
+	}
+
+	inline void StoreUnaligned(float* someValuesOut, const Vector& aVector)
+	{
+		_mm_storeu_ps(someValuesOut, aVector);
+	}
+
+	inline float GetX(const Vector& aVector)
+	{
+		return _mm_cvtss_f32(aVector);
 	}
 
 	inline Vector Add(const Vector& aLeft, const Vector& aRight)
@@ -55,7 +185,11 @@ namespace SIMD
 
 	inline Vector MultiplyAdd(const Vector& aLeftMultiply, const Vector& aRightMultiply, const Vector& anAddVector)
 	{
+#if SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_AVX2
 		return _mm_fmadd_ps(aLeftMultiply, aRightMultiply, anAddVector);
+#else
+		return _mm_add_ps(_mm_mul_ps(aLeftMultiply, aRightMultiply), anAddVector);
+#endif // SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_AVX2
 	}
 
 	// Creates vector with values (aLeft[anIndex0], aLeft[anIndex1], aRight[anIndex2], aRight[anIndex3])
@@ -64,38 +198,377 @@ namespace SIMD
 	{
 		return _mm_shuffle_ps(aLeft, aRight, _MM_SHUFFLE(Index3, Index2, Index1, Index0));
 	}
-}
 
-#define SIMD_VECTOR_INDEX_OPERATOR(aVector, anIndex) aVector.m128_f32[anIndex]
+#if SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SSE2
+	// Sum of the four elements in every element
+	inline Vector HorizontalAdd(const Vector& aVector)
+	{
+		Vector sum = _mm_add_ps(aVector, _mm_shuffle_ps(aVector, aVector, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	}
+#endif // SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SSE2
 
+	// Dot product of the four elements in every element
+	inline Vector Dot(const Vector& aLeft, const Vector& aRight)
+	{
+#if SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SSE2
+		return HorizontalAdd(_mm_mul_ps(aLeft, aRight));
 #else
+		return _mm_dp_ps(aLeft, aRight, 0xFF);
+#endif // SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SSE2
+	}
 
-// TODO: have this working
-namespace SIMD
-{
-	using Vector = __m128;
+	// Dot product of the first three elements in every element
+	inline Vector Dot3(const Vector& aLeft, const Vector& aRight)
+	{
+#if SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SSE2
+		Vector xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+		return HorizontalAdd(_mm_and_ps(_mm_mul_ps(aLeft, aRight), xyzMask));
+#else
+		return _mm_dp_ps(aLeft, aRight, 0x7F);
+#endif // SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SSE2
+	}
+
+	inline Vector Min(const Vector& aLeft, const Vector& aRight)
+	{
+		return _mm_min_ps(aLeft, aRight);
+	}
+
+	inline Vector Max(const Vector& aLeft, const Vector& aRight)
+	{
+		return _mm_max_ps(aLeft, aRight);
+	}
+
+	inline Vector Abs(const Vector& aVector)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), aVector);
+	}
+
+	inline Vector Negate(const Vector& aVector)
+	{
+		return _mm_xor_ps(aVector, _mm_set1_ps(-0.0f));
+	}
+
+	inline Vector Sqrt(const Vector& aVector)
+	{
+		return _mm_sqrt_ps(aVector);
+	}
+
+	// Takes aTrueVector where aMask is set and aFalseVector elsewhere
+	inline Vector Select(const Vector& aFalseVector, const Vector& aTrueVector, const Vector& aMask)
+	{
+#if SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SSE2
+		// Every bit of the mask is used, comparison masks always set all of them
+		return _mm_or_ps(_mm_and_ps(aMask, aTrueVector), _mm_andnot_ps(aMask, aFalseVector));
+#else
+		return _mm_blendv_ps(aFalseVector, aTrueVector, aMask);
+#endif // SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SSE2
+	}
+
+	// To the nearest integer, halfway cases to the even one
+	inline Vector Round(const Vector& aVector)
+	{
+#if SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SSE2
+		// Adding and removing 2^23 with the sign of the value drops the fraction bits, bigger values have none
+		Vector magic = _mm_or_ps(_mm_set1_ps(8388608.0f), _mm_and_ps(aVector, _mm_set1_ps(-0.0f)));
+		Vector rounded = _mm_sub_ps(_mm_add_ps(aVector, magic), magic);
+		return Select(aVector, rounded, _mm_cmplt_ps(Abs(aVector), _mm_set1_ps(8388608.0f)));
+#else
+		return _mm_round_ps(aVector, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#endif // SIMD_INSTRUCTION_SET == SIMD_INSTRUCTION_SET_SSE2
+	}
+
+	// Hardware estimate refined with one Newton-Raphson step, relative error below 2^-22. Infinite for 0
+	inline Vector ReciprocalSqrt(const Vector& aVector)
+	{
+		Vector estimate = _mm_rsqrt_ps(aVector);
+		Vector halfVector = _mm_mul_ps(aVector, _mm_set1_ps(0.5f));
+		Vector refined = _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfVector, _mm_mul_ps(estimate, estimate))));
+		// 0 gives 0 * infinity in the refinement, keep the estimate there
+		return Select(refined, estimate, _mm_cmpeq_ps(aVector, _mm_setzero_ps()));
+	}
+
+	// Comparisons return masks, every bit of an element is set where the comparison is true
+	inline Vector CompareEqual(const Vector& aLeft, const Vector& aRight)
+	{
+		return _mm_cmpeq_ps(aLeft, aRight);
+	}
+
+	inline Vector CompareLess(const Vector& aLeft, const Vector& aRight)
+	{
+		return _mm_cmplt_ps(aLeft, aRight);
+	}
+
+	inline Vector CompareLessEqual(const Vector& aLeft, const Vector& aRight)
+	{
+		return _mm_cmple_ps(aLeft, aRight);
+	}
+
+	inline Vector CompareGreater(const Vector& aLeft, const Vector& aRight)
+	{
+		return _mm_cmpgt_ps(aLeft, aRight);
+	}
+
+	inline Vector CompareGreaterEqual(const Vector& aLeft, const Vector& aRight)
+	{
+		return _mm_cmpge_ps(aLeft, aRight);
+	}
+
+	inline Vector And(const Vector& aLeft, const Vector& aRight)
+	{
+		return _mm_and_ps(aLeft, aRight);
+	}
+
+	inline Vector Or(const Vector& aLeft, const Vector& aRight)
+	{
+		return _mm_or_ps(aLeft, aRight);
+	}
+
+	// Bit i is set if element i of aMask is set
+	inline int GetMask(const Vector& aMask)
+	{
+		return _mm_movemask_ps(aMask);
+	}
+
+	// __m128 is declared as may alias on GCC and Clang, so reading it through a float pointer is fine
+	inline float& GetElement(Vector& aVector, unsigned int anIndex)
+	{
+		return reinterpret_cast<float*>(&aVector)[anIndex];
+	}
+
+	inline const float& GetElement(const Vector& aVector, unsigned int anIndex)
+	{
+		return reinterpret_cast<const float*>(&aVector)[anIndex];
+	}
+
+#else
+
+	struct alignas(16) Vector
+	{
+		float myValues[4];
+	};
 
 	inline Vector Load(float aX, float aY, float aZ, float aW)
 	{
-		alignas(16) float vector[] = { aX, aY, aZ, aW };
-		return __mm_load_ps(vector);
+		return Vector{ { aX, aY, aZ, aW } };
 	}
 
 	inline Vector Load(float aValue)
 	{
-		alignas(16) float vector[] = { aValue, aValue, aValue, aValue };
-		return __mm_load_ps(vector);
+		return Vector{ { aValue, aValue, aValue, aValue } };
+	}
+
+	inline Vector Load(const float* someValues)
+	{
+		return Vector{ { someValues[0], someValues[1], someValues[2], someValues[3] } };
+	}
+
+	inline Vector LoadUnaligned(const float* someValues)
+	{
+		return Load(someValues);
+	}
+
+	inline void Store(float* someValuesOut, const Vector& aVector)
+	{
+		std::memcpy(someValuesOut, aVector.myValues, sizeof(aVector.myValues));
+	}
+
+	inline void StoreUnaligned(float* someValuesOut, const Vector& aVector)
+	{
+		Store(someValuesOut, aVector);
+	}
+
+	inline float GetX(const Vector& aVector)
+	{
+		return aVector.myValues[0];
 	}
 
 	inline Vector Add(const Vector& aLeft, const Vector& aRight)
 	{
-		return __mm_add_ps(aLeft, aRight);
+		return Vector{ { aLeft.myValues[0] + aRight.myValues[0], aLeft.myValues[1] + aRight.myValues[1], aLeft.myValues[2] + aRight.myValues[2], aLeft.myValues[3] + aRight.myValues[3] } };
 	}
 
 	inline Vector Subtract(const Vector& aLeft, const Vector& aRight)
 	{
-		return __mm_sub_ps(aLeft, aRight);
+		return Vector{ { aLeft.myValues[0] - aRight.myValues[0], aLeft.myValues[1] - aRight.myValues[1], aLeft.myValues[2] - aRight.myValues[2], aLeft.myValues[3] - aRight.myValues[3] } };
+	}
+
+	inline Vector Multiply(const Vector& aLeft, const Vector& aRight)
+	{
+		return Vector{ { aLeft.myValues[0] * aRight.myValues[0], aLeft.myValues[1] * aRight.myValues[1], aLeft.myValues[2] * aRight.myValues[2], aLeft.myValues[3] * aRight.myValues[3] } };
+	}
+
+	inline Vector Multiply(const Vector& aVector, float aScalar)
+	{
+		return Multiply(aVector, Load(aScalar));
+	}
+
+	inline Vector Divide(const Vector& aLeft, const Vector& aRight)
+	{
+		return Vector{ { aLeft.myValues[0] / aRight.myValues[0], aLeft.myValues[1] / aRight.myValues[1], aLeft.myValues[2] / aRight.myValues[2], aLeft.myValues[3] / aRight.myValues[3] } };
+	}
+
+	inline Vector Divide(const Vector& aVector, float aScalar)
+	{
+		return Divide(aVector, Load(aScalar));
+	}
+
+	inline Vector MultiplyAdd(const Vector& aLeftMultiply, const Vector& aRightMultiply, const Vector& anAddVector)
+	{
+		return Add(Multiply(aLeftMultiply, aRightMultiply), anAddVector);
+	}
+
+	// Creates vector with values (aLeft[anIndex0], aLeft[anIndex1], aRight[anIndex2], aRight[anIndex3])
+	template <unsigned int Index0, unsigned int Index1, unsigned int Index2, unsigned int Index3>
+	Vector Shuffle(const Vector& aLeft, const Vector& aRight)
+	{
+		static_assert(Index0 < 4u && Index1 < 4u && Index2 < 4u && Index3 < 4u, "Shuffle indices go from 0 to 3");
+		return Vector{ { aLeft.myValues[Index0], aLeft.myValues[Index1], aRight.myValues[Index2], aRight.myValues[Index3] } };
+	}
+
+	// Masks keep every bit of an element set where a comparison is true, as the SIMD instructions do
+	inline float ToMaskElement(bool aValue)
+	{
+		uint32_t bits = aValue ? UINT32_MAX : 0u;
+		float element;
+		std::memcpy(&element, &bits, sizeof(element));
+		return element;
+	}
+
+	inline uint32_t ToBits(float anElement)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &anElement, sizeof(bits));
+		return bits;
+	}
+
+	inline float FromBits(uint32_t someBits)
+	{
+		float element;
+		std::memcpy(&element, &someBits, sizeof(element));
+		return element;
+	}
+
+	template <typename OPERATION>
+	Vector Apply(const Vector& aLeft, const Vector& aRight, OPERATION anOperation)
+	{
+		return Vector{ { anOperation(aLeft.myValues[0], aRight.myValues[0]), anOperation(aLeft.myValues[1], aRight.myValues[1]),
+			anOperation(aLeft.myValues[2], aRight.myValues[2]), anOperation(aLeft.myValues[3], aRight.myValues[3]) } };
+	}
+
+	// Dot product of the four elements in every element
+	inline Vector Dot(const Vector& aLeft, const Vector& aRight)
+	{
+		return Load(aLeft.myValues[0] * aRight.myValues[0] + aLeft.myValues[1] * aRight.myValues[1] + aLeft.myValues[2] * aRight.myValues[2] + aLeft.myValues[3] * aRight.myValues[3]);
+	}
+
+	// Dot product of the first three elements in every element
+	inline Vector Dot3(const Vector& aLeft, const Vector& aRight)
+	{
+		return Load(aLeft.myValues[0] * aRight.myValues[0] + aLeft.myValues[1] * aRight.myValues[1] + aLeft.myValues[2] * aRight.myValues[2]);
+	}
+
+	// Same operand order as minps and maxps, the right one is returned when either is NaN
+	inline Vector Min(const Vector& aLeft, const Vector& aRight)
+	{
+		return Apply(aLeft, aRight, [](float aLeftElement, float aRightElement) { return aLeftElement < aRightElement ? aLeftElement : aRightElement; });
 	}
+
+	inline Vector Max(const Vector& aLeft, const Vector& aRight)
+	{
+		return Apply(aLeft, aRight, [](float aLeftElement, float aRightElement) { return aLeftElement > aRightElement ? aLeftElement : aRightElement; });
+	}
+
+	inline Vector Abs(const Vector& aVector)
+	{
+		return Vector{ { fabsf(aVector.myValues[0]), fabsf(aVector.myValues[1]), fabsf(aVector.myValues[2]), fabsf(aVector.myValues[3]) } };
+	}
+
+	inline Vector Negate(const Vector& aVector)
+	{
+		return Vector{ { -aVector.myValues[0], -aVector.myValues[1], -aVector.myValues[2], -aVector.myValues[3] } };
+	}
+
+	inline Vector Sqrt(const Vector& aVector)
+	{
+		return Vector{ { sqrtf(aVector.myValues[0]), sqrtf(aVector.myValues[1]), sqrtf(aVector.myValues[2]), sqrtf(aVector.myValues[3]) } };
+	}
+
+	inline Vector Round(const Vector& aVector)
+	{
+		return Vector{ { nearbyintf(aVector.myValues[0]), nearbyintf(aVector.myValues[1]), nearbyintf(aVector.myValues[2]), nearbyintf(aVector.myValues[3]) } };
+	}
+
+	inline Vector ReciprocalSqrt(const Vector& aVector)
+	{
+		return Divide(Load(1.0f), Sqrt(aVector));
+	}
+
+	// Comparisons return masks, every bit of an element is set where the comparison is true
+	inline Vector CompareEqual(const Vector& aLeft, const Vector& aRight)
+	{
+		return Apply(aLeft, aRight, [](float aLeftElement, float aRightElement) { return ToMaskElement(aLeftElement == aRightElement); });
+	}
+
+	inline Vector CompareLess(const Vector& aLeft, const Vector& aRight)
+	{
+		return Apply(aLeft, aRight, [](float aLeftElement, float aRightElement) { return ToMaskElement(aLeftElement < aRightElement); });
+	}
+
+	inline Vector CompareLessEqual(const Vector& aLeft, const Vector& aRight)
+	{
+		return Apply(aLeft, aRight, [](float aLeftElement, float aRightElement) { return ToMaskElement(aLeftElement <= aRightElement); });
+	}
+
+	inline Vector CompareGreater(const Vector& aLeft, const Vector& aRight)
+	{
+		return Apply(aLeft, aRight, [](float aLeftElement, float aRightElement) { return ToMaskElement(aLeftElement > aRightElement); });
+	}
+
+	inline Vector CompareGreaterEqual(const Vector& aLeft, const Vector& aRight)
+	{
+		return Apply(aLeft, aRight, [](float aLeftElement, float aRightElement) { return ToMaskElement(aLeftElement >= aRightElement); });
+	}
+
+	inline Vector And(const Vector& aLeft, const Vector& aRight)
+	{
+		return Apply(aLeft, aRight, [](float aLeftElement, float aRightElement) { return FromBits(ToBits(aLeftElement) & ToBits(aRightElement)); });
+	}
+
+	inline Vector Or(const Vector& aLeft, const Vector& aRight)
+	{
+		return Apply(aLeft, aRight, [](float aLeftElement, float aRightElement) { return FromBits(ToBits(aLeftElement) | ToBits(aRightElement)); });
+	}
+
+	// Takes aTrueVector where aMask is set and aFalseVector elsewhere, only the sign bit of the mask is checked
+	inline Vector Select(const Vector& aFalseVector, const Vector& aTrueVector, const Vector& aMask)
+	{
+		Vector result;
+		for (unsigned int i = 0u; i < 4u; ++i)
+			result.myValues[i] = (ToBits(aMask.myValues[i]) & 0x80000000u) != 0u ? aTrueVector.myValues[i] : aFalseVector.myValues[i];
+		return result;
+	}
+
+	// Bit i is set if element i of aMask is set
+	inline int GetMask(const Vector& aMask)
+	{
+		int mask = 0;
+		for (unsigned int i = 0u; i < 4u; ++i)
+			mask |= static_cast<int>(ToBits(aMask.myValues[i]) >> 31u) << i;
+		return mask;
+	}
+
+	inline float& GetElement(Vector& aVector, unsigned int anIndex)
+	{
+		return aVector.myValues[anIndex];
+	}
+
+	inline const float& GetElement(const Vector& aVector, unsigned int anIndex)
+	{
+		return aVector.myValues[anIndex];
+	}
+
+#endif // SIMD_INSTRUCTION_SET != SIMD_INSTRUCTION_SET_SCALAR
 }
 
-#endif // IS_WINDOWS_PLATFORM
+#define SIMD_VECTOR_INDEX_OPERATOR(aVector, anIndex) SIMD::GetElement(aVector, anIndex)
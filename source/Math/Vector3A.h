@@ -0,0 +1,81 @@
+#pragma once
+
+#include "SIMDVector.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+// Vector3 padded to 16 bytes so it lives in a SIMD vector. The w element is not part of the vector, operations
+// may leave any value in it and none of them read it
+struct Vector3A
+{
+	inline Vector3A()
+		: myVector(SIMD::Load(0.0f))
+	{ }
+
+	inline Vector3A(float aX, float aY, float aZ)
+		: myVector(SIMD::Load(aX, aY, aZ, 0.0f))
+	{ }
+
+	inline Vector3A(float aValue)
+		: myVector(SIMD::Load(aValue))
+	{ }
+
+	inline Vector3A(SIMD::Vector aVector)
+		: myVector(aVector)
+	{ }
+
+	inline explicit Vector3A(const Vector3& aVector)
+		: myVector(SIMD::Load(aVector.x, aVector.y, aVector.z, 0.0f))
+	{ }
+
+	// Drops w
+	inline explicit Vector3A(const Vector4& aVector)
+		: myVector(aVector.myVector)
+	{ }
+
+	inline Vector3A operator+(const Vector3A& anOther) const { return SIMD::Add(myVector, anOther.myVector); }
+	inline Vector3A operator-(const Vector3A& anOther) const { return SIMD::Subtract(myVector, anOther.myVector); }
+	inline Vector3A operator*(float aScalar) const { return SIMD::Multiply(myVector, aScalar); }
+	inline friend Vector3A operator*(float aScalar, const Vector3A& aVector) { return aVector * aScalar; }
+	inline Vector3A operator/(float aScalar) const { return SIMD::Divide(myVector, aScalar); }
+	inline Vector3A operator-() const { return SIMD::Negate(myVector); }
+
+	inline Vector3A& operator+=(const Vector3A& anOther) { myVector = SIMD::Add(myVector, anOther.myVector); return *this; }
+	inline Vector3A& operator-=(const Vector3A& anOther) { myVector = SIMD::Subtract(myVector, anOther.myVector); return *this; }
+	inline Vector3A& operator*=(float aScalar) { myVector = SIMD::Multiply(myVector, aScalar); return *this; }
+	inline Vector3A& operator/=(float aScalar) { myVector = SIMD::Divide(myVector, aScalar); return *this; }
+
+	inline float Dot(const Vector3A& anOther) const { return SIMD::GetX(SIMD::Dot3(myVector, anOther.myVector)); }
+	inline float LengthSquare() const { return Dot(*this); }
+	inline float Length() const { return SIMD::GetX(SIMD::Sqrt(SIMD::Dot3(myVector, myVector))); }
+	// Uses the refined reciprocal square root, within a couple of ULP of dividing by Length
+	inline Vector3A Normalize() const { return SIMD::Multiply(myVector, SIMD::ReciprocalSqrt(SIMD::Dot3(myVector, myVector))); }
+
+	inline Vector3A Cross(const Vector3A& anOther) const
+	{
+		// (a * b.yzx - a.yzx * b).yzx, one shuffle less than the textbook form
+		SIMD::Vector right = anOther.myVector;
+		SIMD::Vector rotated = SIMD::Subtract(SIMD::Multiply(myVector, SIMD::Shuffle<1, 2, 0, 3>(right, right)), SIMD::Multiply(SIMD::Shuffle<1, 2, 0, 3>(myVector, myVector), right));
+		return SIMD::Shuffle<1, 2, 0, 3>(rotated, rotated);
+	}
+
+	inline Vector3 ToVector3() const { return Vector3{ x, y, z }; }
+	inline Vector4 ToVector4(float aW) const
+	{
+		SIMD::Vector zw = SIMD::Shuffle<2, 2, 0, 0>(myVector, SIMD::Load(aW));
+		return SIMD::Shuffle<0, 1, 0, 2>(myVector, zw);
+	}
+
+	union
+	{
+		struct
+		{
+			float x;
+			float y;
+			float z;
+		};
+		SIMD::Vector myVector;
+	};
+};
+
+static_assert(sizeof(Vector3A) == 4u * sizeof(float), "Vector3A must be a single SIMD vector");
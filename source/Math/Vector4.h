@@ -30,6 +30,12 @@ struct Vector4
 	inline Vector4& operator*=(float aScalar) { myVector = SIMD::Multiply(myVector, aScalar); return *this; }
 	inline Vector4& operator/=(float aScalar) { myVector = SIMD::Divide(myVector, aScalar); return *this; }
 
+	inline float Dot(const Vector4& anOther) const { return SIMD::GetX(SIMD::Dot(myVector, anOther.myVector)); }
+	inline float LengthSquare() const { return Dot(*this); }
+	inline float Length() const { return SIMD::GetX(SIMD::Sqrt(SIMD::Dot(myVector, myVector))); }
+	// Uses the refined reciprocal square root, within a couple of ULP of dividing by Length
+	inline Vector4 Normalize() const { return SIMD::Multiply(myVector, SIMD::ReciprocalSqrt(SIMD::Dot(myVector, myVector))); }
+
 	inline const float& operator[](unsigned int anIndex) const { return myValues[anIndex]; }
 	inline float& operator[](unsigned int anIndex) { return myValues[anIndex]; }
 
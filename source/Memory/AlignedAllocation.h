@@ -0,0 +1,37 @@
+#pragma once
+
+#include "GlobalDefines.h"
+
+#include <stdlib.h>
+
+#if IS_WINDOWS_PLATFORM
+#include <malloc.h>
+#endif // IS_WINDOWS_PLATFORM
+
+namespace dbz
+{
+
+// Size of a cache line in the platforms we target
+constexpr size_t CACHE_LINE_SIZE = 64u;
+
+// anAlignment must be a power of two. Memory must be released with FreeAligned
+inline void* AllocateAligned(size_t aSize, size_t anAlignment)
+{
+#if IS_WINDOWS_PLATFORM
+	return _aligned_malloc(aSize, anAlignment);
+#else
+	// aligned_alloc requires the size to be a multiple of the alignment
+	return aligned_alloc(anAlignment, (aSize + anAlignment - 1u) & ~(anAlignment - 1u));
+#endif // IS_WINDOWS_PLATFORM
+}
+
+inline void FreeAligned(void* aPointer)
+{
+#if IS_WINDOWS_PLATFORM
+	_aligned_free(aPointer);
+#else
+	free(aPointer);
+#endif // IS_WINDOWS_PLATFORM
+}
+
+}
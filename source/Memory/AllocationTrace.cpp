@@ -0,0 +1,356 @@
+#include "AllocationTrace.h"
+
+#include "BitOperations.h"
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace dbz
+{
+
+namespace
+{
+	// File layout, all values little endian:
+	// Header: magic, version, page size, event count
+	// Allocate: 1 byte type and alignment log2 in the upper bits, 4 bytes size, 4 bytes offset
+	// Free: 1 byte type and succeeded flag in the upper bits, 4 bytes allocation index
+	constexpr uint8_t locMagic[4] = { 'D', 'B', 'Z', 'T' };
+	constexpr uint32_t locVersion = 1u;
+	// Alignments are 32 bit powers of two, so 2^31 is the biggest one recorded
+	constexpr uint32_t locMaxAlignmentLog2 = 31u;
+
+	void WriteUint32(std::vector<uint8_t>& aBuffer, uint32_t aValue)
+	{
+		for (uint32_t i = 0u; i < 4u; ++i)
+			aBuffer.push_back(static_cast<uint8_t>(aValue >> (8u * i)));
+	}
+
+	bool ReadUint32(const std::vector<uint8_t>& aBuffer, size_t& anOffset, uint32_t& aValueOut)
+	{
+		if (aBuffer.size() - anOffset < 4u)
+			return false;
+
+		aValueOut = 0u;
+		for (uint32_t i = 0u; i < 4u; ++i)
+			aValueOut |= static_cast<uint32_t>(aBuffer[anOffset + i]) << (8u * i);
+
+		anOffset += 4u;
+		return true;
+	}
+
+	// Sizes spread evenly over powers of two, like real allocation sizes tend to be
+	uint32_t RandomLogUniform(std::mt19937& aGenerator, uint32_t aMin, uint32_t aMax)
+	{
+		uint32_t minLog2 = FindLastSetBit(aMin);
+		uint32_t maxLog2 = FindLastSetBit(aMax);
+		uint32_t log2 = minLog2 + aGenerator() % (maxLog2 - minLog2 + 1u);
+		uint32_t size = (1u << log2) + aGenerator() % (1u << log2);
+		return size < aMin ? aMin : (size > aMax ? aMax : size);
+	}
+
+	// Allocation made by a generator and not freed yet
+	struct LiveAllocation
+	{
+		uint32_t myIndex;
+		uint32_t mySize;
+	};
+
+	uint32_t RandomAlignment(std::mt19937& aGenerator)
+	{
+		// Mostly unaligned, with some 16 and 256 byte aligned allocations
+		uint32_t value = aGenerator() % 8u;
+		return value < 5u ? 1u : (value < 7u ? 16u : 256u);
+	}
+}
+
+AllocationTrace AllocationTrace::Create(uint32_t aPageSize)
+{
+	return AllocationTrace{ aPageSize };
+}
+
+void AllocationTrace::Destroy(AllocationTrace& aTrace)
+{
+	aTrace.myEvents.clear();
+	aTrace.myLiveAllocationIndices.clear();
+	aTrace.myPageSize = 0u;
+	aTrace.myAllocationCount = 0u;
+}
+
+bool AllocationTrace::Load(const char* aPath, AllocationTrace& aTraceOut)
+{
+	std::ifstream file(aPath, std::ios::binary);
+	if (file.is_open() == false)
+		return false;
+
+	std::vector<uint8_t> buffer{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	if (buffer.size() < sizeof(locMagic) || std::equal(std::begin(locMagic), std::end(locMagic), buffer.begin()) == false)
+		return false;
+
+	size_t offset = sizeof(locMagic);
+	uint32_t version = 0u;
+	uint32_t pageSize = 0u;
+	uint32_t eventCount = 0u;
+	if (ReadUint32(buffer, offset, version) == false || version != locVersion || ReadUint32(buffer, offset, pageSize) == false || ReadUint32(buffer, offset, eventCount) == false)
+		return false;
+
+	AllocationTrace trace{ pageSize };
+	trace.myEvents.reserve(eventCount);
+	for (uint32_t i = 0u; i < eventCount; ++i)
+	{
+		if (offset == buffer.size())
+			return false;
+
+		uint8_t typeByte = buffer[offset++];
+		Event event;
+		event.myType = static_cast<Event::Type>(typeByte & 1u);
+		if (event.myType == Event::Type::ALLOCATE)
+		{
+			uint32_t alignmentLog2 = typeByte >> 1u;
+			if (alignmentLog2 > locMaxAlignmentLog2)
+				return false;
+
+			event.myAlignment = 1u << alignmentLog2;
+			event.myAllocationIndex = trace.myAllocationCount++;
+			if (ReadUint32(buffer, offset, event.mySize) == false || ReadUint32(buffer, offset, event.myOffset) == false)
+				return false;
+			event.mySucceeded = event.myOffset != UINT32_MAX;
+		}
+		else
+		{
+			event.mySucceeded = (typeByte >> 1u) != 0u;
+			if (ReadUint32(buffer, offset, event.myAllocationIndex) == false)
+				return false;
+
+			// Frees can only refer to allocations recorded before them
+			if (event.myAllocationIndex != UINT32_MAX && event.myAllocationIndex >= trace.myAllocationCount)
+				return false;
+		}
+
+		trace.myEvents.push_back(event);
+	}
+
+	aTraceOut = std::move(trace);
+	return true;
+}
+
+bool AllocationTrace::Save(const char* aPath) const
+{
+	std::vector<uint8_t> buffer(std::begin(locMagic), std::end(locMagic));
+	WriteUint32(buffer, locVersion);
+	WriteUint32(buffer, myPageSize);
+	WriteUint32(buffer, static_cast<uint32_t>(myEvents.size()));
+
+	for (const Event& event : myEvents)
+	{
+		if (event.myType == Event::Type::ALLOCATE)
+		{
+			buffer.push_back(static_cast<uint8_t>(FindFirstSetBit(event.myAlignment) << 1u));
+			WriteUint32(buffer, event.mySize);
+			WriteUint32(buffer, event.myOffset);
+		}
+		else
+		{
+			buffer.push_back(static_cast<uint8_t>(1u | (event.mySucceeded ? 2u : 0u)));
+			WriteUint32(buffer, event.myAllocationIndex);
+		}
+	}
+
+	std::ofstream file(aPath, std::ios::binary);
+	if (file.is_open() == false)
+		return false;
+
+	file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	return file.good();
+}
+
+AllocationTrace AllocationTrace::GenerateChurn(uint32_t aPageSize, uint32_t aLiveBytes, uint32_t anEventCount, uint32_t aSeed)
+{
+	AllocationTrace trace{ aPageSize };
+	std::mt19937 generator{ aSeed };
+
+	std::vector<LiveAllocation> liveAllocations;
+	uint32_t liveBytes = 0u;
+	while (trace.myEvents.size() < anEventCount)
+	{
+		uint32_t size = RandomLogUniform(generator, 16u, 16u << 10);
+		if (liveAllocations.empty() || (liveBytes + size <= aLiveBytes && generator() % 2u == 0u))
+		{
+			liveAllocations.push_back(LiveAllocation{ trace.myAllocationCount, size });
+			liveBytes += size;
+			trace.AddAllocate(size, RandomAlignment(generator));
+		}
+		else
+		{
+			uint32_t index = generator() % liveAllocations.size();
+			liveBytes -= liveAllocations[index].mySize;
+			trace.AddFree(liveAllocations[index].myIndex);
+			liveAllocations[index] = liveAllocations.back();
+			liveAllocations.pop_back();
+		}
+	}
+
+	return trace;
+}
+
+AllocationTrace AllocationTrace::GenerateStackLike(uint32_t aPageSize, uint32_t aLiveBytes, uint32_t anEventCount, uint32_t aSeed)
+{
+	AllocationTrace trace{ aPageSize };
+	std::mt19937 generator{ aSeed };
+
+	std::vector<LiveAllocation> liveAllocations;
+	uint32_t liveBytes = 0u;
+	while (trace.myEvents.size() < anEventCount)
+	{
+		// Push a burst of allocations, then pop some of them back
+		uint32_t pushCount = 1u + generator() % 64u;
+		for (uint32_t i = 0u; i < pushCount && trace.myEvents.size() < anEventCount; ++i)
+		{
+			uint32_t size = RandomLogUniform(generator, 16u, 64u << 10);
+			if (liveAllocations.empty() == false && liveBytes + size > aLiveBytes)
+				break;
+
+			liveAllocations.push_back(LiveAllocation{ trace.myAllocationCount, size });
+			liveBytes += size;
+			trace.AddAllocate(size, RandomAlignment(generator));
+		}
+
+		uint32_t popCount = 1u + generator() % static_cast<uint32_t>(liveAllocations.size());
+		for (uint32_t i = 0u; i < popCount && trace.myEvents.size() < anEventCount; ++i)
+		{
+			liveBytes -= liveAllocations.back().mySize;
+			trace.AddFree(liveAllocations.back().myIndex);
+			liveAllocations.pop_back();
+		}
+	}
+
+	return trace;
+}
+
+AllocationTrace AllocationTrace::GenerateBimodal(uint32_t aPageSize, uint32_t aLiveBytes, uint32_t anEventCount, uint32_t aSeed)
+{
+	AllocationTrace trace{ aPageSize };
+	std::mt19937 generator{ aSeed };
+
+	constexpr uint32_t maxLiveSmallCount = 1024u;
+	constexpr uint32_t maxLiveBigCount = 8u;
+	uint32_t maxBigSize = std::max(aLiveBytes / (2u * maxLiveBigCount), 8u << 10);
+
+	// Small allocations die young, oldest first, big ones live until randomly replaced
+	std::deque<LiveAllocation> liveSmallAllocations;
+	std::vector<LiveAllocation> liveBigAllocations;
+	uint32_t liveBytes = 0u;
+	while (trace.myEvents.size() < anEventCount)
+	{
+		if (generator() % 64u == 0u)
+		{
+			uint32_t size = RandomLogUniform(generator, maxBigSize / 16u, maxBigSize);
+			if (liveBigAllocations.size() < maxLiveBigCount && liveBytes + size <= aLiveBytes)
+			{
+				liveBigAllocations.push_back(LiveAllocation{ trace.myAllocationCount, size });
+				liveBytes += size;
+				trace.AddAllocate(size, 256u);
+			}
+			else if (liveBigAllocations.empty() == false)
+			{
+				uint32_t index = generator() % liveBigAllocations.size();
+				liveBytes -= liveBigAllocations[index].mySize;
+				trace.AddFree(liveBigAllocations[index].myIndex);
+				liveBigAllocations[index] = liveBigAllocations.back();
+				liveBigAllocations.pop_back();
+			}
+			continue;
+		}
+
+		uint32_t size = RandomLogUniform(generator, 16u, 512u);
+		if (liveSmallAllocations.empty() || (liveSmallAllocations.size() < maxLiveSmallCount && liveBytes + size <= aLiveBytes))
+		{
+			liveSmallAllocations.push_back(LiveAllocation{ trace.myAllocationCount, size });
+			liveBytes += size;
+			trace.AddAllocate(size, RandomAlignment(generator));
+		}
+		else
+		{
+			liveBytes -= liveSmallAllocations.front().mySize;
+			trace.AddFree(liveSmallAllocations.front().myIndex);
+			liveSmallAllocations.pop_front();
+		}
+	}
+
+	return trace;
+}
+
+void AllocationTrace::RecordAllocate(uint32_t aSize, uint32_t anAlignment, uint32_t anOffset)
+{
+	if (anOffset != UINT32_MAX)
+		myLiveAllocationIndices[anOffset] = myAllocationCount;
+
+	// Only powers of two alignments can be saved, other calls are kept as zero sized allocations so they fail on replay too
+	bool isValidAlignment = anAlignment != 0u && (anAlignment & (anAlignment - 1u)) == 0u;
+
+	Event event;
+	event.myType = Event::Type::ALLOCATE;
+	event.mySize = isValidAlignment ? aSize : 0u;
+	event.myAlignment = isValidAlignment ? anAlignment : 1u;
+	event.myAllocationIndex = myAllocationCount++;
+	event.myOffset = anOffset;
+	event.mySucceeded = anOffset != UINT32_MAX;
+	myEvents.push_back(event);
+}
+
+void AllocationTrace::RecordFree(uint32_t anOffset, bool aSucceeded)
+{
+	Event event;
+	event.myType = Event::Type::FREE;
+	event.mySucceeded = aSucceeded;
+
+	auto it = myLiveAllocationIndices.find(anOffset);
+	if (it != myLiveAllocationIndices.end())
+	{
+		event.myAllocationIndex = it->second;
+		if (aSucceeded)
+			myLiveAllocationIndices.erase(it);
+	}
+
+	myEvents.push_back(event);
+}
+
+void AllocationTrace::RecordMove(uint32_t anOldOffset, uint32_t aNewOffset)
+{
+	auto it = myLiveAllocationIndices.find(anOldOffset);
+	if (it == myLiveAllocationIndices.end())
+		return;
+
+	uint32_t allocationIndex = it->second;
+	myLiveAllocationIndices.erase(it);
+	myLiveAllocationIndices[aNewOffset] = allocationIndex;
+}
+
+AllocationTrace::AllocationTrace(uint32_t aPageSize)
+	: myPageSize(aPageSize)
+{ }
+
+void AllocationTrace::AddAllocate(uint32_t aSize, uint32_t anAlignment)
+{
+	// Generated traces do not know the offsets, allocations are assumed to succeed
+	Event event;
+	event.myType = Event::Type::ALLOCATE;
+	event.mySize = aSize;
+	event.myAlignment = anAlignment;
+	event.myAllocationIndex = myAllocationCount++;
+	event.mySucceeded = true;
+	myEvents.push_back(event);
+}
+
+void AllocationTrace::AddFree(uint32_t anAllocationIndex)
+{
+	Event event;
+	event.myType = Event::Type::FREE;
+	event.myAllocationIndex = anAllocationIndex;
+	event.mySucceeded = true;
+	myEvents.push_back(event);
+}
+
+}
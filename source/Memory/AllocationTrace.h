@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace dbz
+{
+
+// Allocate and Free calls made on a memory page, kept in memory and saved to a compact binary file
+// so they can be replayed against other allocators
+class AllocationTrace
+{
+public:
+	struct Event
+	{
+		enum class Type : uint8_t
+		{
+			ALLOCATE = 0,
+			FREE
+		};
+
+		Type myType = Type::ALLOCATE;
+		uint32_t mySize = 0u;
+		uint32_t myAlignment = 1u;
+		// Allocations are numbered in the order they are recorded, frees refer to them by that index.
+		// UINT32_MAX for frees of offsets that were not allocated
+		uint32_t myAllocationIndex = UINT32_MAX;
+		// Offset returned by Allocate
+		uint32_t myOffset = UINT32_MAX;
+		bool mySucceeded = false;
+	};
+
+	static AllocationTrace Create(uint32_t aPageSize);
+	static void Destroy(AllocationTrace& aTrace);
+
+	// Returns false if the file could not be read or is not a valid trace
+	static bool Load(const char* aPath, AllocationTrace& aTraceOut);
+	bool Save(const char* aPath) const;
+
+	// Synthetic workloads, keeping at most aLiveBytes allocated at once
+	// Random sizes and lifetimes
+	static AllocationTrace GenerateChurn(uint32_t aPageSize, uint32_t aLiveBytes, uint32_t anEventCount, uint32_t aSeed);
+	// Allocations are freed in reverse order, in bursts of random depth
+	static AllocationTrace GenerateStackLike(uint32_t aPageSize, uint32_t aLiveBytes, uint32_t anEventCount, uint32_t aSeed);
+	// Many small short lived allocations mixed with a few big long lived ones
+	static AllocationTrace GenerateBimodal(uint32_t aPageSize, uint32_t aLiveBytes, uint32_t anEventCount, uint32_t aSeed);
+
+	// Dummy constructor, does nothing
+	AllocationTrace() = default;
+
+	void RecordAllocate(uint32_t aSize, uint32_t anAlignment, uint32_t anOffset);
+	void RecordFree(uint32_t anOffset, bool aSucceeded);
+	// Defragmentation moved a live allocation, later frees of the new offset refer to it
+	void RecordMove(uint32_t anOldOffset, uint32_t aNewOffset);
+
+	uint32_t GetPageSize() const { return myPageSize; }
+	uint32_t GetAllocationCount() const { return myAllocationCount; }
+	const std::vector<Event>& GetEvents() const { return myEvents; }
+
+private:
+	explicit AllocationTrace(uint32_t aPageSize);
+
+	void AddAllocate(uint32_t aSize, uint32_t anAlignment);
+	void AddFree(uint32_t anAllocationIndex);
+
+	std::vector<Event> myEvents;
+	// Allocation index of the offsets in use, only needed while recording
+	std::unordered_map<uint32_t, uint32_t> myLiveAllocationIndices;
+	uint32_t myPageSize = 0u;
+	uint32_t myAllocationCount = 0u;
+};
+
+}
@@ -0,0 +1,225 @@
+#include "AllocationTracker.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dbz
+{
+
+namespace
+{
+	const char* locUntaggedName = "Untagged";
+
+	const char* GetTagName(const char* aTag)
+	{
+		return aTag != nullptr ? aTag : locUntaggedName;
+	}
+}
+
+AllocationTracker AllocationTracker::Create()
+{
+	return AllocationTracker{};
+}
+
+void AllocationTracker::Destroy(AllocationTracker& aTracker)
+{
+	aTracker.myLiveAllocations.clear();
+	aTracker.myLeakedAllocations.clear();
+	aTracker.myTagStats.clear();
+	aTracker.myCallsiteStats.clear();
+	aTracker.myScopeTag = nullptr;
+	aTracker.myIsEnabled = false;
+}
+
+void AllocationTracker::RecordFreeRange(const void* anAllocator, uint64_t aBegin, uint64_t anEnd)
+{
+	auto allocatorIt = myLiveAllocations.find(anAllocator);
+	if (allocatorIt == myLiveAllocations.end())
+		return;
+
+	std::map<uint64_t, Allocation>& allocations = allocatorIt->second;
+	auto begin = allocations.lower_bound(aBegin);
+	auto end = allocations.lower_bound(anEnd);
+	for (auto it = begin; it != end; ++it)
+		RemoveStats(it->second);
+
+	allocations.erase(begin, end);
+	if (allocations.empty())
+		myLiveAllocations.erase(allocatorIt);
+}
+
+void AllocationTracker::RecordMove(const void* anAllocator, uint64_t anOldAllocation, uint64_t aNewAllocation)
+{
+	auto allocatorIt = myLiveAllocations.find(anAllocator);
+	if (allocatorIt == myLiveAllocations.end())
+		return;
+
+	std::map<uint64_t, Allocation>& allocations = allocatorIt->second;
+	auto it = allocations.find(anOldAllocation);
+	if (it == allocations.end())
+		return;
+
+	Allocation allocation = it->second;
+	allocation.myAllocation = aNewAllocation;
+	allocations.erase(it);
+	allocations[aNewAllocation] = allocation;
+}
+
+void AllocationTracker::RecordAllocatorDestroyed(const void* anAllocator)
+{
+	auto allocatorIt = myLiveAllocations.find(anAllocator);
+	if (allocatorIt == myLiveAllocations.end())
+		return;
+
+	for (const auto& entry : allocatorIt->second)
+	{
+		RemoveStats(entry.second);
+		myLeakedAllocations.push_back(entry.second);
+	}
+
+	myLiveAllocations.erase(allocatorIt);
+}
+
+std::vector<AllocationTracker::TagStats> AllocationTracker::GetTagStats() const
+{
+	std::vector<TagStats> tagStats;
+	for (const auto& entry : myTagStats)
+	{
+		const char* name = GetTagName(entry.first);
+		auto it = std::find_if(tagStats.begin(), tagStats.end(), [name](const TagStats& aStats) { return std::strcmp(aStats.myTag, name) == 0; });
+		if (it == tagStats.end())
+		{
+			tagStats.push_back(entry.second);
+			tagStats.back().myTag = name;
+			continue;
+		}
+
+		it->myLiveBytes += entry.second.myLiveBytes;
+		it->myLiveCount += entry.second.myLiveCount;
+		it->myAllocatedBytes += entry.second.myAllocatedBytes;
+		it->myAllocationCount += entry.second.myAllocationCount;
+	}
+
+	std::sort(tagStats.begin(), tagStats.end(), [](const TagStats& aLeft, const TagStats& aRight) { return aLeft.myLiveBytes > aRight.myLiveBytes; });
+	return tagStats;
+}
+
+std::vector<AllocationTracker::CallsiteStats> AllocationTracker::GetTopCallsites(uint32_t aCount) const
+{
+	std::vector<CallsiteStats> callsiteStats;
+	callsiteStats.reserve(myCallsiteStats.size());
+	for (const auto& entry : myCallsiteStats)
+		callsiteStats.push_back(entry.second);
+
+	auto isBigger = [](const CallsiteStats& aLeft, const CallsiteStats& aRight)
+	{
+		return aLeft.myLiveBytes != aRight.myLiveBytes ? aLeft.myLiveBytes > aRight.myLiveBytes : aLeft.myAllocatedBytes > aRight.myAllocatedBytes;
+	};
+
+	size_t count = std::min<size_t>(aCount, callsiteStats.size());
+	std::partial_sort(callsiteStats.begin(), callsiteStats.begin() + count, callsiteStats.end(), isBigger);
+	callsiteStats.resize(count);
+	return callsiteStats;
+}
+
+std::vector<AllocationTracker::Allocation> AllocationTracker::GetLiveAllocations() const
+{
+	std::vector<Allocation> allocations;
+	for (const auto& allocatorEntry : myLiveAllocations)
+	{
+		for (const auto& entry : allocatorEntry.second)
+			allocations.push_back(entry.second);
+	}
+
+	return allocations;
+}
+
+void AllocationTracker::AddAllocation(const void* anAllocator, uint64_t anAllocation, uint64_t aSize, const char* aTag, const void* aCallsite)
+{
+	Allocation allocation;
+	allocation.myAllocator = anAllocator;
+	allocation.myAllocation = anAllocation;
+	allocation.mySize = aSize;
+	allocation.myTag = aTag;
+	allocation.myCallsite = aCallsite;
+
+	// An allocation the tracker missed the free of, replaced so stats stay consistent
+	auto result = myLiveAllocations[anAllocator].emplace(anAllocation, allocation);
+	if (result.second == false)
+	{
+		RemoveStats(result.first->second);
+		result.first->second = allocation;
+	}
+
+	TagStats& tagStats = myTagStats[aTag];
+	tagStats.myTag = aTag;
+	tagStats.myLiveBytes += aSize;
+	++tagStats.myLiveCount;
+	tagStats.myAllocatedBytes += aSize;
+	++tagStats.myAllocationCount;
+
+	CallsiteStats& callsiteStats = myCallsiteStats[aCallsite];
+	callsiteStats.myCallsite = aCallsite;
+	callsiteStats.myLiveBytes += aSize;
+	++callsiteStats.myLiveCount;
+	callsiteStats.myAllocatedBytes += aSize;
+	++callsiteStats.myAllocationCount;
+}
+
+void AllocationTracker::RemoveAllocation(const void* anAllocator, uint64_t anAllocation)
+{
+	auto allocatorIt = myLiveAllocations.find(anAllocator);
+	if (allocatorIt == myLiveAllocations.end())
+		return;
+
+	std::map<uint64_t, Allocation>& allocations = allocatorIt->second;
+	auto it = allocations.find(anAllocation);
+	if (it == allocations.end())
+		return;
+
+	RemoveStats(it->second);
+	allocations.erase(it);
+	if (allocations.empty())
+		myLiveAllocations.erase(allocatorIt);
+}
+
+void AllocationTracker::RemoveStats(const Allocation& anAllocation)
+{
+	TagStats& tagStats = myTagStats[anAllocation.myTag];
+	tagStats.myLiveBytes -= anAllocation.mySize;
+	--tagStats.myLiveCount;
+
+	CallsiteStats& callsiteStats = myCallsiteStats[anAllocation.myCallsite];
+	callsiteStats.myLiveBytes -= anAllocation.mySize;
+	--callsiteStats.myLiveCount;
+}
+
+#if IS_DEVELOPMENT_BUILD
+
+void AllocationTracker::Print(std::ostream& anOutputStream, uint32_t aCallsiteCount) const
+{
+	anOutputStream << "Allocation tags:\n";
+	for (const TagStats& tagStats : GetTagStats())
+	{
+		anOutputStream << "\t" << tagStats.myTag << ": [Live: " << tagStats.myLiveBytes << " bytes in " << tagStats.myLiveCount
+			<< " allocations, Total: " << tagStats.myAllocatedBytes << " bytes in " << tagStats.myAllocationCount << " allocations]\n";
+	}
+
+	anOutputStream << "Top callsites:\n";
+	for (const CallsiteStats& callsiteStats : GetTopCallsites(aCallsiteCount))
+	{
+		anOutputStream << "\t" << callsiteStats.myCallsite << ": [Live: " << callsiteStats.myLiveBytes << " bytes in " << callsiteStats.myLiveCount
+			<< " allocations, Total: " << callsiteStats.myAllocatedBytes << " bytes in " << callsiteStats.myAllocationCount << " allocations]\n";
+	}
+
+	anOutputStream << "Leaked allocations: " << myLeakedAllocations.size() << "\n";
+	for (const Allocation& allocation : myLeakedAllocations)
+	{
+		anOutputStream << "\t" << GetTagName(allocation.myTag) << ": [Allocator: " << allocation.myAllocator << ", Allocation: " << allocation.myAllocation
+			<< ", Size: " << allocation.mySize << ", Callsite: " << allocation.myCallsite << "]\n";
+	}
+}
+
+#endif // IS_DEVELOPMENT_BUILD
+
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "GlobalDefines.h"
+
+#include <cstddef>
+#include <map>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#if IS_DEVELOPMENT_BUILD
+#include <iostream>
+#endif // IS_DEVELOPMENT_BUILD
+
+#if IS_WINDOWS_PLATFORM
+#include <intrin.h>
+#define DBZ_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define DBZ_RETURN_ADDRESS() __builtin_return_address(0)
+#endif // IS_WINDOWS_PLATFORM
+
+namespace dbz
+{
+
+// Live allocations of the allocators reporting to it, with the subsystem tag and the callsite that made them.
+// Callsites are return addresses into the code calling the allocator, resolved to source lines by the
+// debugger or addr2line. Allocators only report in IS_ALLOCATION_TRACKING_BUILD builds, and nothing is
+// recorded until the tracker is enabled, so a disabled tracker costs a branch per call. Not thread safe
+class AllocationTracker
+{
+public:
+	struct Allocation
+	{
+		const void* myAllocator = nullptr;
+		// Offset or address, depending on the allocator
+		uint64_t myAllocation = 0u;
+		uint64_t mySize = 0u;
+		const char* myTag = nullptr;
+		const void* myCallsite = nullptr;
+	};
+
+	struct TagStats
+	{
+		const char* myTag = nullptr;
+		uint64_t myLiveBytes = 0u;
+		uint64_t myLiveCount = 0u;
+		uint64_t myAllocatedBytes = 0u;
+		uint64_t myAllocationCount = 0u;
+	};
+
+	struct CallsiteStats
+	{
+		const void* myCallsite = nullptr;
+		uint64_t myLiveBytes = 0u;
+		uint64_t myLiveCount = 0u;
+		uint64_t myAllocatedBytes = 0u;
+		uint64_t myAllocationCount = 0u;
+	};
+
+	// Overrides the tag of the allocators for the allocations made while it lives
+	class TagScope
+	{
+	public:
+		TagScope(AllocationTracker& aTracker, const char* aTag)
+			: myTracker(aTracker)
+			, myPreviousTag(aTracker.myScopeTag)
+		{
+			aTracker.myScopeTag = aTag;
+		}
+
+		~TagScope() { myTracker.myScopeTag = myPreviousTag; }
+
+		TagScope(const TagScope&) = delete;
+		TagScope& operator=(const TagScope&) = delete;
+
+	private:
+		AllocationTracker& myTracker;
+		const char* myPreviousTag;
+	};
+
+	static AllocationTracker Create();
+	static void Destroy(AllocationTracker& aTracker);
+
+	// Dummy constructor, does nothing
+	AllocationTracker() = default;
+
+	void SetEnabled(bool anIsEnabled) { myIsEnabled = anIsEnabled; }
+	bool IsEnabled() const { return myIsEnabled; }
+
+	// Called by the allocators. Frees are processed while disabled too, so allocations recorded before disabling are not leaked
+	void RecordAllocate(const void* anAllocator, uint64_t anAllocation, uint64_t aSize, const char* anAllocatorTag, const void* aCallsite)
+	{
+		if (myIsEnabled)
+			AddAllocation(anAllocator, anAllocation, aSize, myScopeTag != nullptr ? myScopeTag : anAllocatorTag, aCallsite);
+	}
+
+	void RecordFree(const void* anAllocator, uint64_t anAllocation)
+	{
+		if (myLiveAllocations.empty() == false)
+			RemoveAllocation(anAllocator, anAllocation);
+	}
+
+	// Every live allocation of anAllocator in [aBegin, anEnd) is freed, for allocators that release memory in bulk
+	void RecordFreeRange(const void* anAllocator, uint64_t aBegin, uint64_t anEnd);
+	void RecordMove(const void* anAllocator, uint64_t anOldAllocation, uint64_t aNewAllocation);
+	// Allocations still alive in anAllocator are moved to the leaked allocations
+	void RecordAllocatorDestroyed(const void* anAllocator);
+
+	// Sorted by live bytes. Tags with the same name are merged
+	std::vector<TagStats> GetTagStats() const;
+	// Callsites with the most live bytes, then the most allocated bytes
+	std::vector<CallsiteStats> GetTopCallsites(uint32_t aCount) const;
+	std::vector<Allocation> GetLiveAllocations() const;
+	const std::vector<Allocation>& GetLeakedAllocations() const { return myLeakedAllocations; }
+
+private:
+	void AddAllocation(const void* anAllocator, uint64_t anAllocation, uint64_t aSize, const char* aTag, const void* aCallsite);
+	void RemoveAllocation(const void* anAllocator, uint64_t anAllocation);
+	void RemoveStats(const Allocation& anAllocation);
+
+	// Ordered by allocation per allocator, so range frees only visit the allocations they remove.
+	// Allocators without live allocations are erased
+	std::unordered_map<const void*, std::map<uint64_t, Allocation>> myLiveAllocations;
+	std::vector<Allocation> myLeakedAllocations;
+	// Keyed by tag pointer, GetTagStats merges tags with the same name
+	std::unordered_map<const char*, TagStats> myTagStats;
+	std::unordered_map<const void*, CallsiteStats> myCallsiteStats;
+	const char* myScopeTag = nullptr;
+	bool myIsEnabled = false;
+
+#if IS_DEVELOPMENT_BUILD
+public:
+	// Tag stats, the top callsites and the leaked allocations
+	void Print(std::ostream& anOutputStream, uint32_t aCallsiteCount = 10u) const;
+#endif // IS_DEVELOPMENT_BUILD
+};
+
+}
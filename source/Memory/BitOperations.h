@@ -0,0 +1,38 @@
+#pragma once
+
+#include "GlobalDefines.h"
+
+#include <stdint.h>
+
+#if IS_WINDOWS_PLATFORM
+#include <intrin.h>
+#endif // IS_WINDOWS_PLATFORM
+
+namespace dbz
+{
+
+// Index of the least significant bit set. Value must not be 0
+inline uint32_t FindFirstSetBit(uint32_t aValue)
+{
+#if IS_WINDOWS_PLATFORM
+	unsigned long index;
+	_BitScanForward(&index, aValue);
+	return static_cast<uint32_t>(index);
+#else
+	return static_cast<uint32_t>(__builtin_ctz(aValue));
+#endif // IS_WINDOWS_PLATFORM
+}
+
+// Index of the most significant bit set. Value must not be 0
+inline uint32_t FindLastSetBit(uint32_t aValue)
+{
+#if IS_WINDOWS_PLATFORM
+	unsigned long index;
+	_BitScanReverse(&index, aValue);
+	return static_cast<uint32_t>(index);
+#else
+	return static_cast<uint32_t>(31 - __builtin_clz(aValue));
+#endif // IS_WINDOWS_PLATFORM
+}
+
+}
@@ -0,0 +1,273 @@
+#include "BuddyPage.h"
+
+#include "BitOperations.h"
+
+#include <algorithm>
+
+namespace dbz
+{
+
+BuddyPage BuddyPage::Create(uint32_t aSize, uint32_t aMinBlockSize)
+{
+	return BuddyPage{ aSize, aMinBlockSize };
+}
+
+void BuddyPage::Destroy(BuddyPage& aPage)
+{
+	aPage.mySize = 0u;
+	aPage.myOrderCount = 0u;
+	aPage.myFreeOrderBitmap = 0u;
+	aPage.myFreeBitmaps.clear();
+	aPage.myAllocatedBitmaps.clear();
+	aPage.myStats = MemoryPageStats{};
+}
+
+uint32_t BuddyPage::Allocate(uint32_t aSize, uint32_t anAlignment)
+{
+	if (aSize == 0u || anAlignment == 0u || (anAlignment & (anAlignment - 1u)) != 0u)
+	{
+		++myStats.myFailedAllocationCount;
+		return UINT32_MAX;
+	}
+
+	// Blocks are aligned to their size, so alignment is just a minimum block size
+	uint32_t blockSize = std::max(aSize, anAlignment);
+	uint32_t blockSizeLog2 = FindLastSetBit(blockSize);
+	if ((blockSize & (blockSize - 1u)) != 0u)
+		++blockSizeLog2;
+
+	uint32_t order = blockSizeLog2 > myMinBlockSizeLog2 ? blockSizeLog2 - myMinBlockSizeLog2 : 0u;
+	uint32_t availableOrders = order < myOrderCount ? myFreeOrderBitmap & (UINT32_MAX << order) : 0u;
+	if (availableOrders == 0u)
+	{
+		++myStats.myFailedAllocationCount;
+		return UINT32_MAX;
+	}
+
+	uint32_t freeOrder = FindFirstSetBit(availableOrders);
+	uint32_t index = myFreeBitmaps[freeOrder].FindFirstSet();
+	RemoveFreeBlock(freeOrder, index);
+
+	// Split down to the requested order, upper halves stay free as buddies
+	while (freeOrder > order)
+	{
+		--freeOrder;
+		index <<= 1u;
+		InsertFreeBlock(freeOrder, index + 1u);
+	}
+
+	myAllocatedBitmaps[order][index >> 5u] |= 1u << (index & 31u);
+
+	++myStats.myAllocationCount;
+	myStats.myInUseBytes += 1u << GetBlockSizeLog2(order);
+	return index << GetBlockSizeLog2(order);
+}
+
+bool BuddyPage::Free(uint32_t anOffset)
+{
+	uint32_t order = 0u;
+	uint32_t index = 0u;
+	if (FindAllocatedBlock(anOffset, order, index) == false)
+	{
+		++myStats.myFailedFreeCount;
+		return false;
+	}
+
+	myAllocatedBitmaps[order][index >> 5u] &= ~(1u << (index & 31u));
+
+	++myStats.myFreeCount;
+	myStats.myInUseBytes -= 1u << GetBlockSizeLog2(order);
+
+	// Merge with the buddy for as long as it is free
+	while (order + 1u < myOrderCount && myFreeBitmaps[order].IsSet(index ^ 1u))
+	{
+		RemoveFreeBlock(order, index ^ 1u);
+		++order;
+		index >>= 1u;
+	}
+
+	InsertFreeBlock(order, index);
+	return true;
+}
+
+uint32_t BuddyPage::GetAllocationSize(uint32_t anOffset) const
+{
+	uint32_t order = 0u;
+	uint32_t index = 0u;
+	return FindAllocatedBlock(anOffset, order, index) ? 1u << GetBlockSizeLog2(order) : 0u;
+}
+
+MemoryPageStats BuddyPage::GetStats() const
+{
+	MemoryPageStats stats = myStats;
+	if (myFreeOrderBitmap != 0u)
+		stats.myLargestFreeBlockSize = 1u << GetBlockSizeLog2(FindLastSetBit(myFreeOrderBitmap));
+
+	return stats;
+}
+
+void BuddyPage::HierarchicalBitmap::Create(uint32_t aBitCount)
+{
+	uint32_t wordCount = 0u;
+	do
+	{
+		wordCount = (aBitCount + 31u) >> 5u;
+		myLevels.emplace_back(wordCount, 0u);
+		aBitCount = wordCount;
+	} while (wordCount > 1u);
+}
+
+void BuddyPage::HierarchicalBitmap::Set(uint32_t anIndex)
+{
+	for (std::vector<uint32_t>& level : myLevels)
+	{
+		uint32_t& word = level[anIndex >> 5u];
+		bool wasEmpty = word == 0u;
+		word |= 1u << (anIndex & 31u);
+
+		// Summary bits above are already set
+		if (wasEmpty == false)
+			return;
+
+		anIndex >>= 5u;
+	}
+}
+
+void BuddyPage::HierarchicalBitmap::Clear(uint32_t anIndex)
+{
+	for (std::vector<uint32_t>& level : myLevels)
+	{
+		uint32_t& word = level[anIndex >> 5u];
+		word &= ~(1u << (anIndex & 31u));
+
+		// Summary bits above stay set while the word has other bits
+		if (word != 0u)
+			return;
+
+		anIndex >>= 5u;
+	}
+}
+
+uint32_t BuddyPage::HierarchicalBitmap::FindFirstSet() const
+{
+	uint32_t index = 0u;
+	for (auto it = myLevels.rbegin(); it != myLevels.rend(); ++it)
+		index = (index << 5u) + FindFirstSetBit((*it)[index]);
+
+	return index;
+}
+
+bool BuddyPage::FindAllocatedBlock(uint32_t anOffset, uint32_t& anOrderOut, uint32_t& anIndexOut) const
+{
+	if (anOffset >= mySize || (anOffset & ((1u << myMinBlockSizeLog2) - 1u)) != 0u)
+		return false;
+
+	// Look for the allocated block starting at the offset, bigger orders need the offset aligned to their size
+	uint32_t order = 0u;
+	uint32_t index = anOffset >> myMinBlockSizeLog2;
+	while (IsAllocated(order, index) == false)
+	{
+		// Requested offset does not belong to this page
+		if ((index & 1u) != 0u || order + 1u == myOrderCount)
+			return false;
+
+		++order;
+		index >>= 1u;
+	}
+
+	anOrderOut = order;
+	anIndexOut = index;
+	return true;
+}
+
+void BuddyPage::InsertFreeBlock(uint32_t anOrder, uint32_t anIndex)
+{
+	myFreeBitmaps[anOrder].Set(anIndex);
+	myFreeOrderBitmap |= 1u << anOrder;
+
+	myStats.myFreeBytes += 1u << GetBlockSizeLog2(anOrder);
+	++myStats.myFreeBlockCount;
+	++myStats.myFreeBlockSizeHistogram[GetBlockSizeLog2(anOrder)];
+}
+
+void BuddyPage::RemoveFreeBlock(uint32_t anOrder, uint32_t anIndex)
+{
+	HierarchicalBitmap& bitmap = myFreeBitmaps[anOrder];
+	bitmap.Clear(anIndex);
+	if (bitmap.myLevels.back()[0] == 0u)
+		myFreeOrderBitmap &= ~(1u << anOrder);
+
+	myStats.myFreeBytes -= 1u << GetBlockSizeLog2(anOrder);
+	--myStats.myFreeBlockCount;
+	--myStats.myFreeBlockSizeHistogram[GetBlockSizeLog2(anOrder)];
+}
+
+BuddyPage::BuddyPage(uint32_t aSize, uint32_t aMinBlockSize)
+	: mySize(aSize & ~(aMinBlockSize - 1u))
+	, myMinBlockSizeLog2(FindFirstSetBit(aMinBlockSize))
+{
+	if (mySize == 0u)
+		return;
+
+	// Orders cover the page size rounded up to a power of two, blocks past the page end are never free
+	uint32_t pageSizeLog2 = FindLastSetBit(mySize);
+	if ((mySize & (mySize - 1u)) != 0u)
+		++pageSizeLog2;
+
+	myOrderCount = pageSizeLog2 - myMinBlockSizeLog2 + 1u;
+	myFreeBitmaps.resize(myOrderCount);
+	myAllocatedBitmaps.resize(myOrderCount);
+	for (uint32_t order = 0u; order < myOrderCount; ++order)
+	{
+		uint32_t blockCount = 1u << (myOrderCount - 1u - order);
+		myFreeBitmaps[order].Create(blockCount);
+		myAllocatedBitmaps[order].resize((blockCount + 31u) >> 5u, 0u);
+	}
+
+	// Fill the page with the biggest blocks that fit at each offset
+	uint64_t offset = 0u;
+	while (offset < mySize)
+	{
+		uint32_t order = myOrderCount - 1u;
+		while ((offset & ((1ull << GetBlockSizeLog2(order)) - 1u)) != 0u || offset + (1ull << GetBlockSizeLog2(order)) > mySize)
+			--order;
+
+		InsertFreeBlock(order, static_cast<uint32_t>(offset >> GetBlockSizeLog2(order)));
+		offset += 1ull << GetBlockSizeLog2(order);
+	}
+}
+
+#if IS_DEVELOPMENT_BUILD
+
+void BuddyPage::Print(std::ostream& anOutputStream) const
+{
+	anOutputStream << "In use blocks:\n";
+	anOutputStream << "Head";
+	for (uint32_t order = 0u; order < myOrderCount; ++order)
+	{
+		uint32_t blockCount = 1u << (myOrderCount - 1u - order);
+		for (uint32_t index = 0u; index < blockCount; ++index)
+		{
+			if (IsAllocated(order, index))
+				anOutputStream << " -> [Offset: " << (index << GetBlockSizeLog2(order)) << ", Size: " << (1ull << GetBlockSizeLog2(order)) << "]";
+		}
+	}
+	anOutputStream << " -> nullptr\n";
+
+	anOutputStream << "Free blocks:\n";
+	anOutputStream << "Head";
+	for (uint32_t order = 0u; order < myOrderCount; ++order)
+	{
+		uint32_t blockCount = 1u << (myOrderCount - 1u - order);
+		for (uint32_t index = 0u; index < blockCount; ++index)
+		{
+			if (myFreeBitmaps[order].IsSet(index))
+				anOutputStream << " -> [Offset: " << (index << GetBlockSizeLog2(order)) << ", Size: " << (1ull << GetBlockSizeLog2(order)) << "]";
+		}
+	}
+	anOutputStream << " -> nullptr\n";
+}
+
+#endif // IS_DEVELOPMENT_BUILD
+
+}
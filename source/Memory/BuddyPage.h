@@ -0,0 +1,83 @@
+#pragma once
+
+#include "GlobalDefines.h"
+#include "MemoryPageStats.h"
+
+#include <stdint.h>
+#include <vector>
+
+#if IS_DEVELOPMENT_BUILD
+#include <iostream>
+#endif // IS_DEVELOPMENT_BUILD
+
+namespace dbz
+{
+
+// Buddy system allocator. Blocks are powers of two no smaller than the minimum block size, each one
+// aligned to its own size, so splitting and merging are O(log n) and fragmentation stays bounded
+class BuddyPage
+{
+public:
+	constexpr static uint32_t ourDefaultMinBlockSize = 256u;
+
+	// aMinBlockSize must be a power of two bigger than 1. Memory past the last whole minimum block is not used
+	static BuddyPage Create(uint32_t aSize, uint32_t aMinBlockSize = ourDefaultMinBlockSize);
+	static void Destroy(BuddyPage& aPage);
+
+	// Dummy constructor, does nothing
+	BuddyPage() = default;
+
+	// Size is rounded up to a power of two, the returned offset is aligned to that size and so to
+	// anAlignment, which must be a power of two. Returns UINT32_MAX if there is no room for the allocation or aSize is 0
+	uint32_t Allocate(uint32_t aSize, uint32_t anAlignment = 1u);
+	bool Free(uint32_t anOffset);
+
+	// Size of the block allocated at anOffset, rounded up to a power of two. 0 if nothing is allocated there
+	uint32_t GetAllocationSize(uint32_t anOffset) const;
+
+	// Constant time. In use bytes count whole blocks, including the rounding up to powers of two
+	MemoryPageStats GetStats() const;
+
+private:
+	// Bit per block of an order, with summary levels on top where a bit is set if the word below is not
+	// zero, so finding a set bit only visits a word per level
+	struct HierarchicalBitmap
+	{
+		void Create(uint32_t aBitCount);
+		void Set(uint32_t anIndex);
+		void Clear(uint32_t anIndex);
+		bool IsSet(uint32_t anIndex) const { return (myLevels[0][anIndex >> 5u] & (1u << (anIndex & 31u))) != 0u; }
+		// Bitmap must not be empty
+		uint32_t FindFirstSet() const;
+
+		std::vector<std::vector<uint32_t>> myLevels;
+	};
+
+	BuddyPage(uint32_t aSize, uint32_t aMinBlockSize);
+
+	// Returns false if no allocated block starts at anOffset
+	bool FindAllocatedBlock(uint32_t anOffset, uint32_t& anOrderOut, uint32_t& anIndexOut) const;
+	bool IsAllocated(uint32_t anOrder, uint32_t anIndex) const { return (myAllocatedBitmaps[anOrder][anIndex >> 5u] & (1u << (anIndex & 31u))) != 0u; }
+	void InsertFreeBlock(uint32_t anOrder, uint32_t anIndex);
+	void RemoveFreeBlock(uint32_t anOrder, uint32_t anIndex);
+	uint32_t GetBlockSizeLog2(uint32_t anOrder) const { return myMinBlockSizeLog2 + anOrder; }
+
+	uint32_t mySize = 0u;
+	uint32_t myMinBlockSizeLog2 = 0u;
+	uint32_t myOrderCount = 0u;
+
+	// Bit per order, set if the order has any free block
+	uint32_t myFreeOrderBitmap = 0u;
+	std::vector<HierarchicalBitmap> myFreeBitmaps;
+	// Flat bit per block and order, set for the blocks handed out by Allocate
+	std::vector<std::vector<uint32_t>> myAllocatedBitmaps;
+
+	MemoryPageStats myStats;
+
+#if IS_DEVELOPMENT_BUILD
+public:
+	void Print(std::ostream& anOutputStream) const;
+#endif // IS_DEVELOPMENT_BUILD
+};
+
+}
@@ -0,0 +1,417 @@
+#include "ConcurrentMemoryPage.h"
+
+#include "AlignedAllocation.h"
+#include "BitOperations.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace dbz
+{
+
+constexpr uint32_t ConcurrentMemoryPage::ourSpanSize;
+constexpr uint32_t ConcurrentMemoryPage::ourMaxCachedSize;
+constexpr uint32_t ConcurrentMemoryPage::ourSizeClassCount;
+constexpr uint32_t ConcurrentMemoryPage::ourMaxThreadCacheCount;
+
+namespace
+{
+	constexpr uint32_t locInvalidOwner = UINT32_MAX;
+	constexpr uint32_t locRemoteFreeQueueCapacity = 4096u;
+
+	// Bounded queue of offsets, any thread can push and only the owner pops. Each cell sequence tells
+	// whether the cell is ready to be written or read for the current lap, so no locks are needed
+	class RemoteFreeQueue
+	{
+	public:
+		RemoteFreeQueue()
+		{
+			for (uint32_t i = 0u; i < locRemoteFreeQueueCapacity; ++i)
+				myCells[i].mySequence.store(i, std::memory_order_relaxed);
+		}
+
+		// Returns false if the queue is full
+		bool Push(uint32_t anOffset)
+		{
+			uint32_t position = myPushPosition.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				Cell& cell = myCells[position & (locRemoteFreeQueueCapacity - 1u)];
+				int32_t difference = static_cast<int32_t>(cell.mySequence.load(std::memory_order_acquire) - position);
+				if (difference == 0)
+				{
+					if (myPushPosition.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed))
+					{
+						cell.myOffset = anOffset;
+						cell.mySequence.store(position + 1u, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (difference < 0)
+				{
+					return false;
+				}
+				else
+				{
+					position = myPushPosition.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		bool Pop(uint32_t& anOffsetOut)
+		{
+			Cell& cell = myCells[myPopPosition & (locRemoteFreeQueueCapacity - 1u)];
+			if (cell.mySequence.load(std::memory_order_acquire) != myPopPosition + 1u)
+				return false;
+
+			anOffsetOut = cell.myOffset;
+			cell.mySequence.store(myPopPosition + locRemoteFreeQueueCapacity, std::memory_order_release);
+			++myPopPosition;
+			return true;
+		}
+
+	private:
+		struct Cell
+		{
+			std::atomic<uint32_t> mySequence;
+			uint32_t myOffset;
+		};
+
+		Cell myCells[locRemoteFreeQueueCapacity];
+		// Producers and the consumer write different cache lines
+		uint8_t myPadding[CACHE_LINE_SIZE];
+		std::atomic<uint32_t> myPushPosition{ 0u };
+		uint8_t myPadding2[CACHE_LINE_SIZE];
+		uint32_t myPopPosition = 0u;
+	};
+}
+
+class ConcurrentMemoryPage::ThreadCache
+{
+public:
+	RemoteFreeQueue myRemoteFrees;
+	// Frees that did not fit in the queue, guarded by the page mutex
+	std::vector<uint32_t> myRemoteFreeOverflow;
+	std::atomic<bool> myHasRemoteFreeOverflow{ false };
+
+	// Spans with free blocks for each size class
+	std::vector<uint32_t> myPartialSpans[ourSizeClassCount];
+	uint32_t myIndex = 0u;
+	bool myIsAcquired = false;
+};
+
+struct ConcurrentMemoryPage::Span
+{
+	// Index of the owning thread cache, read by other threads to route their frees
+	std::atomic<uint32_t> myOwner{ locInvalidOwner };
+
+	// Only used by the owner
+	uint32_t mySizeClass = 0u;
+	uint32_t myLiveBlockCount = 0u;
+	// Position in the owner partial span list, UINT32_MAX while the span has no free blocks
+	uint32_t myPartialSpanPosition = UINT32_MAX;
+	std::vector<uint16_t> myFreeBlocks;
+	std::vector<uint64_t> myAllocatedBlocks;
+};
+
+ConcurrentMemoryPage ConcurrentMemoryPage::Create(uint32_t aSize, MemoryPage::SelectionMethod aSelectionMethod)
+{
+	return ConcurrentMemoryPage{ aSize, aSelectionMethod };
+}
+
+void ConcurrentMemoryPage::Destroy(ConcurrentMemoryPage& aPage)
+{
+	for (uint32_t i = 0u; i < aPage.myThreadCacheCount; ++i)
+	{
+		delete aPage.myThreadCaches[i];
+		aPage.myThreadCaches[i] = nullptr;
+	}
+
+	delete[] aPage.mySpans;
+	delete aPage.myMutex;
+	MemoryPage::Destroy(aPage.myPage);
+
+	aPage.myThreadCacheCount = 0u;
+	aPage.mySpans = nullptr;
+	aPage.mySpanCount = 0u;
+	aPage.myMutex = nullptr;
+}
+
+uint32_t ConcurrentMemoryPage::GetSizeClass(uint32_t aSize)
+{
+	if (aSize <= 128u)
+		return (aSize + 15u) / 16u - 1u;
+
+	uint32_t group = FindLastSetBit(aSize - 1u) - 7u;
+	return 8u + group * 4u + (aSize - 1u - (128u << group)) / (32u << group);
+}
+
+uint32_t ConcurrentMemoryPage::GetSizeClassSize(uint32_t aSizeClass)
+{
+	if (aSizeClass < 8u)
+		return (aSizeClass + 1u) * 16u;
+
+	uint32_t group = (aSizeClass - 8u) / 4u;
+	return (128u << group) + ((aSizeClass - 8u) % 4u + 1u) * (32u << group);
+}
+
+ConcurrentMemoryPage::ThreadCache* ConcurrentMemoryPage::AcquireThreadCache()
+{
+	std::lock_guard<std::mutex> lock(*myMutex);
+
+	for (uint32_t i = 0u; i < myThreadCacheCount; ++i)
+	{
+		if (myThreadCaches[i]->myIsAcquired == false)
+		{
+			DrainOrphanedRemoteFrees(*myThreadCaches[i]);
+			myThreadCaches[i]->myIsAcquired = true;
+			return myThreadCaches[i];
+		}
+	}
+
+	if (myThreadCacheCount == ourMaxThreadCacheCount)
+		return nullptr;
+
+	ThreadCache* cache = new ThreadCache;
+	cache->myIndex = myThreadCacheCount;
+	cache->myIsAcquired = true;
+	myThreadCaches[myThreadCacheCount++] = cache;
+	return cache;
+}
+
+void ConcurrentMemoryPage::ReleaseThreadCache(ThreadCache& aCache)
+{
+	DrainRemoteFrees(aCache);
+
+	std::lock_guard<std::mutex> lock(*myMutex);
+	aCache.myIsAcquired = false;
+}
+
+uint32_t ConcurrentMemoryPage::Allocate(ThreadCache& aCache, uint32_t aSize, uint32_t anAlignment)
+{
+	bool isValid = aSize != 0u && anAlignment != 0u && (anAlignment & (anAlignment - 1u)) == 0u;
+	if (isValid && aSize <= ourMaxCachedSize && anAlignment <= ourMaxCachedSize)
+	{
+		// Blocks sit at multiples of the class size in the span, so a class multiple of the alignment keeps it
+		uint32_t sizeClass = GetSizeClass(std::max(aSize, anAlignment));
+		while ((GetSizeClassSize(sizeClass) & (anAlignment - 1u)) != 0u)
+			++sizeClass;
+
+		std::vector<uint32_t>& partialSpans = aCache.myPartialSpans[sizeClass];
+		if (partialSpans.empty())
+			DrainRemoteFrees(aCache);
+
+		// Pages too full or too small for a span still serve the allocation directly
+		if (partialSpans.empty() == false || RefillSizeClass(aCache, sizeClass))
+		{
+			uint32_t spanIndex = partialSpans.back();
+			Span& span = mySpans[spanIndex];
+
+			uint32_t block = span.myFreeBlocks.back();
+			span.myFreeBlocks.pop_back();
+			span.myAllocatedBlocks[block >> 6u] |= 1ull << (block & 63u);
+			++span.myLiveBlockCount;
+
+			if (span.myFreeBlocks.empty())
+			{
+				partialSpans.pop_back();
+				span.myPartialSpanPosition = UINT32_MAX;
+			}
+
+			return spanIndex * ourSpanSize + block * GetSizeClassSize(sizeClass);
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(*myMutex);
+	return myPage.Allocate(aSize, anAlignment);
+}
+
+bool ConcurrentMemoryPage::Free(ThreadCache& aCache, uint32_t anOffset)
+{
+	uint32_t spanIndex = anOffset / ourSpanSize;
+	uint32_t owner = spanIndex < mySpanCount ? mySpans[spanIndex].myOwner.load(std::memory_order_acquire) : locInvalidOwner;
+
+	if (owner == aCache.myIndex)
+		return FreeToSpan(aCache, anOffset);
+
+	if (owner == locInvalidOwner)
+	{
+		std::lock_guard<std::mutex> lock(*myMutex);
+		return myPage.Free(anOffset);
+	}
+
+	ThreadCache& ownerCache = *myThreadCaches[owner];
+	if (ownerCache.myRemoteFrees.Push(anOffset) == false)
+	{
+		std::lock_guard<std::mutex> lock(*myMutex);
+
+		// Released caches are only acquired under the lock, so nobody else touches them meanwhile
+		if (ownerCache.myIsAcquired == false)
+		{
+			DrainOrphanedRemoteFrees(ownerCache);
+			return FreeToSpan(ownerCache, anOffset, true);
+		}
+
+		ownerCache.myRemoteFreeOverflow.push_back(anOffset);
+		ownerCache.myHasRemoteFreeOverflow.store(true, std::memory_order_release);
+	}
+
+	return true;
+}
+
+void ConcurrentMemoryPage::DrainRemoteFrees(ThreadCache& aCache)
+{
+	uint32_t offset = 0u;
+	while (aCache.myRemoteFrees.Pop(offset))
+		FreeToSpan(aCache, offset);
+
+	if (aCache.myHasRemoteFreeOverflow.load(std::memory_order_acquire))
+	{
+		std::vector<uint32_t> overflow;
+		{
+			std::lock_guard<std::mutex> lock(*myMutex);
+			overflow.swap(aCache.myRemoteFreeOverflow);
+			aCache.myHasRemoteFreeOverflow.store(false, std::memory_order_relaxed);
+		}
+
+		for (uint32_t overflowOffset : overflow)
+			FreeToSpan(aCache, overflowOffset);
+	}
+}
+
+void ConcurrentMemoryPage::DrainOrphanedRemoteFrees(ThreadCache& aCache)
+{
+	uint32_t offset = 0u;
+	while (aCache.myRemoteFrees.Pop(offset))
+		FreeToSpan(aCache, offset, true);
+
+	for (uint32_t overflowOffset : aCache.myRemoteFreeOverflow)
+		FreeToSpan(aCache, overflowOffset, true);
+
+	aCache.myRemoteFreeOverflow.clear();
+	aCache.myHasRemoteFreeOverflow.store(false, std::memory_order_relaxed);
+}
+
+MemoryPageStats ConcurrentMemoryPage::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(*myMutex);
+	return myPage.GetStats();
+}
+
+ConcurrentMemoryPage::ConcurrentMemoryPage(uint32_t aSize, MemoryPage::SelectionMethod aSelectionMethod)
+	: myMutex(new std::mutex)
+	, myPage(MemoryPage::Create(aSize, aSelectionMethod))
+	, mySpanCount(static_cast<uint32_t>((static_cast<uint64_t>(aSize) + ourSpanSize - 1u) / ourSpanSize))
+{
+	mySpans = new Span[mySpanCount];
+}
+
+bool ConcurrentMemoryPage::RefillSizeClass(ThreadCache& aCache, uint32_t aSizeClass)
+{
+	uint32_t offset = UINT32_MAX;
+	{
+		std::lock_guard<std::mutex> lock(*myMutex);
+		offset = myPage.Allocate(ourSpanSize, ourSpanSize);
+	}
+
+	if (offset == UINT32_MAX)
+		return false;
+
+	uint32_t spanIndex = offset / ourSpanSize;
+	Span& span = mySpans[spanIndex];
+
+	// Blocks are handed out in address order
+	uint32_t blockCount = ourSpanSize / GetSizeClassSize(aSizeClass);
+	span.myFreeBlocks.resize(blockCount);
+	for (uint32_t i = 0u; i < blockCount; ++i)
+		span.myFreeBlocks[i] = static_cast<uint16_t>(blockCount - 1u - i);
+	span.myAllocatedBlocks.assign((blockCount + 63u) / 64u, 0u);
+
+	span.mySizeClass = aSizeClass;
+	span.myLiveBlockCount = 0u;
+
+	std::vector<uint32_t>& partialSpans = aCache.myPartialSpans[aSizeClass];
+	span.myPartialSpanPosition = static_cast<uint32_t>(partialSpans.size());
+	partialSpans.push_back(spanIndex);
+
+	span.myOwner.store(aCache.myIndex, std::memory_order_release);
+	return true;
+}
+
+bool ConcurrentMemoryPage::FreeToSpan(ThreadCache& aCache, uint32_t anOffset, bool anIsPageLocked)
+{
+	uint32_t spanIndex = anOffset / ourSpanSize;
+	Span& span = mySpans[spanIndex];
+
+	// Queued frees can refer to spans released since, if the offset was not allocated
+	if (span.myOwner.load(std::memory_order_relaxed) != aCache.myIndex)
+		return false;
+
+	uint32_t sizeClassSize = GetSizeClassSize(span.mySizeClass);
+	uint32_t spanOffset = anOffset - spanIndex * ourSpanSize;
+	uint32_t block = spanOffset / sizeClassSize;
+	if (spanOffset % sizeClassSize != 0u || block >= ourSpanSize / sizeClassSize || (span.myAllocatedBlocks[block >> 6u] & (1ull << (block & 63u))) == 0u)
+		return false;
+
+	span.myAllocatedBlocks[block >> 6u] &= ~(1ull << (block & 63u));
+	span.myFreeBlocks.push_back(static_cast<uint16_t>(block));
+	--span.myLiveBlockCount;
+
+	std::vector<uint32_t>& partialSpans = aCache.myPartialSpans[span.mySizeClass];
+	if (span.myPartialSpanPosition == UINT32_MAX)
+	{
+		span.myPartialSpanPosition = static_cast<uint32_t>(partialSpans.size());
+		partialSpans.push_back(spanIndex);
+	}
+
+	// Keep one span per size class even if empty, so allocating and freeing a single block does not lock
+	if (span.myLiveBlockCount == 0u && partialSpans.size() > 1u)
+		ReleaseSpan(aCache, spanIndex, anIsPageLocked);
+
+	return true;
+}
+
+void ConcurrentMemoryPage::ReleaseSpan(ThreadCache& aCache, uint32_t aSpanIndex, bool anIsPageLocked)
+{
+	Span& span = mySpans[aSpanIndex];
+
+	std::vector<uint32_t>& partialSpans = aCache.myPartialSpans[span.mySizeClass];
+	uint32_t lastSpanIndex = partialSpans.back();
+	partialSpans[span.myPartialSpanPosition] = lastSpanIndex;
+	mySpans[lastSpanIndex].myPartialSpanPosition = span.myPartialSpanPosition;
+	partialSpans.pop_back();
+
+	span.myPartialSpanPosition = UINT32_MAX;
+	span.myFreeBlocks.clear();
+	span.myAllocatedBlocks.clear();
+
+	std::unique_lock<std::mutex> lock(*myMutex, std::defer_lock);
+	if (anIsPageLocked == false)
+		lock.lock();
+
+	span.myOwner.store(locInvalidOwner, std::memory_order_relaxed);
+	myPage.Free(aSpanIndex * ourSpanSize);
+}
+
+#if IS_DEVELOPMENT_BUILD
+
+void ConcurrentMemoryPage::Print(std::ostream& anOutputStream) const
+{
+	std::lock_guard<std::mutex> lock(*myMutex);
+
+	for (uint32_t i = 0u; i < myThreadCacheCount; ++i)
+	{
+		uint32_t spanCount = 0u;
+		for (uint32_t spanIndex = 0u; spanIndex < mySpanCount; ++spanIndex)
+			spanCount += mySpans[spanIndex].myOwner.load(std::memory_order_relaxed) == i ? 1u : 0u;
+
+		anOutputStream << "Thread cache " << i << ": [Acquired: " << myThreadCaches[i]->myIsAcquired << ", Spans: " << spanCount << "]\n";
+	}
+
+	myPage.Print(anOutputStream);
+}
+
+#endif // IS_DEVELOPMENT_BUILD
+
+}
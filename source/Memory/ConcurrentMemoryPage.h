@@ -0,0 +1,88 @@
+#pragma once
+
+#include "GlobalDefines.h"
+#include "MemoryPage.h"
+
+#include <mutex>
+#include <stdint.h>
+
+#if IS_DEVELOPMENT_BUILD
+#include <iostream>
+#endif // IS_DEVELOPMENT_BUILD
+
+namespace dbz
+{
+
+// Memory page shared between threads. Each thread allocates through its own ThreadCache, which takes
+// whole spans of ourSpanSize bytes from the shared page under a lock and splits them into blocks of a
+// size class, so small allocations and frees do not lock. Spans left empty are given back to the page.
+// Frees of blocks owned by another thread cache go to a lock free queue the owner drains. Released caches
+// have no owner to drain them, so once their queue is full the freeing thread drains it under the lock.
+// Allocations bigger than ourMaxCachedSize, or with alignment that no size class keeps, lock the shared page
+class ConcurrentMemoryPage
+{
+public:
+	// Allocation state of a single thread, only to be used by one thread at a time
+	class ThreadCache;
+
+	constexpr static uint32_t ourSpanSize = 64u * 1024u;
+	constexpr static uint32_t ourMaxCachedSize = 8u * 1024u;
+	// 16 byte steps up to 128 bytes, then 4 classes per power of two
+	constexpr static uint32_t ourSizeClassCount = 32u;
+	constexpr static uint32_t ourMaxThreadCacheCount = 64u;
+
+	static ConcurrentMemoryPage Create(uint32_t aSize, MemoryPage::SelectionMethod aSelectionMethod = MemoryPage::SelectionMethod::TLSF);
+	// No thread may be using the page
+	static void Destroy(ConcurrentMemoryPage& aPage);
+
+	static uint32_t GetSizeClass(uint32_t aSize);
+	static uint32_t GetSizeClassSize(uint32_t aSizeClass);
+
+	// Dummy constructor, does nothing
+	ConcurrentMemoryPage() = default;
+
+	// Returns nullptr if ourMaxThreadCacheCount caches are already acquired. Released caches are handed out
+	// again with the spans they own, so blocks still alive when a thread stops can be freed later
+	ThreadCache* AcquireThreadCache();
+	void ReleaseThreadCache(ThreadCache& aCache);
+
+	// Same as MemoryPage::Allocate, aCache must be acquired by the calling thread
+	uint32_t Allocate(ThreadCache& aCache, uint32_t aSize, uint32_t anAlignment = 1u);
+	// Blocks owned by another cache are queued to it and checked when it drains them, so Free returns true for them
+	bool Free(ThreadCache& aCache, uint32_t anOffset);
+
+	// Processes the frees other threads queued to aCache, also done when a size class runs out of blocks
+	void DrainRemoteFrees(ThreadCache& aCache);
+
+	// Stats of the shared page, spans count as in use memory
+	MemoryPageStats GetStats() const;
+
+private:
+	struct Span;
+
+	ConcurrentMemoryPage(uint32_t aSize, MemoryPage::SelectionMethod aSelectionMethod);
+
+	bool RefillSizeClass(ThreadCache& aCache, uint32_t aSizeClass);
+	// Span release locks the shared page unless the caller already holds the lock
+	bool FreeToSpan(ThreadCache& aCache, uint32_t anOffset, bool anIsPageLocked = false);
+	void ReleaseSpan(ThreadCache& aCache, uint32_t aSpanIndex, bool anIsPageLocked);
+	// Drains the remote frees of a released cache, the page lock must be held
+	void DrainOrphanedRemoteFrees(ThreadCache& aCache);
+
+	// Guards myPage, the span ownership changes and the thread cache list
+	std::mutex* myMutex = nullptr;
+	MemoryPage myPage;
+	// One per ourSpanSize window of the page, owned by a thread cache while it is a span
+	Span* mySpans = nullptr;
+	uint32_t mySpanCount = 0u;
+	// Fixed size so other threads can look up the owner of a span while caches are being acquired
+	ThreadCache* myThreadCaches[ourMaxThreadCacheCount] = {};
+	uint32_t myThreadCacheCount = 0u;
+
+#if IS_DEVELOPMENT_BUILD
+public:
+	void Print(std::ostream& anOutputStream) const;
+#endif // IS_DEVELOPMENT_BUILD
+};
+
+}
@@ -0,0 +1,81 @@
+#include "FrameArena.h"
+
+#include "AllocationTracker.h"
+
+namespace dbz
+{
+
+FrameArena FrameArena::Create(size_t aCapacity)
+{
+	return FrameArena{ new uint8_t[aCapacity], aCapacity };
+}
+
+void FrameArena::Destroy(FrameArena& anArena)
+{
+#if IS_ALLOCATION_TRACKING_BUILD
+	// Arena allocations are released in bulk, they do not leak
+	if (anArena.myAllocationTracker != nullptr)
+		anArena.myAllocationTracker->RecordFreeRange(&anArena, 0u, UINT64_MAX);
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	delete[] anArena.myMemory;
+	anArena.myMemory = nullptr;
+	anArena.myCapacity = 0u;
+	anArena.myOffset = 0u;
+	anArena.myHighWaterMark = 0u;
+}
+
+void* FrameArena::Allocate(size_t aSize, size_t anAlignment)
+{
+	uintptr_t address = reinterpret_cast<uintptr_t>(myMemory) + myOffset;
+	size_t padding = (anAlignment - (address & (anAlignment - 1u))) & (anAlignment - 1u);
+
+	if (myCapacity - myOffset < padding || myCapacity - myOffset - padding < aSize)
+		return nullptr;
+
+	void* allocation = myMemory + myOffset + padding;
+	myOffset += padding + aSize;
+	myHighWaterMark = myOffset > myHighWaterMark ? myOffset : myHighWaterMark;
+
+#if IS_ALLOCATION_TRACKING_BUILD
+	if (myAllocationTracker != nullptr)
+		myAllocationTracker->RecordAllocate(this, reinterpret_cast<uintptr_t>(allocation), aSize, myAllocationTag, DBZ_RETURN_ADDRESS());
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	return allocation;
+}
+
+void FrameArena::Reset()
+{
+	Rewind(0u);
+}
+
+void FrameArena::Rewind(Marker aMarker)
+{
+	// Markers taken after the current position are not valid anymore
+	if (aMarker > myOffset)
+		return;
+
+#if IS_ALLOCATION_TRACKING_BUILD
+	if (myAllocationTracker != nullptr)
+		myAllocationTracker->RecordFreeRange(this, reinterpret_cast<uintptr_t>(myMemory + aMarker), reinterpret_cast<uintptr_t>(myMemory + myOffset));
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	myOffset = aMarker;
+}
+
+FrameArena::FrameArena(uint8_t* someMemory, size_t aCapacity)
+	: myMemory(someMemory)
+	, myCapacity(aCapacity)
+{ }
+
+#if IS_DEVELOPMENT_BUILD
+
+void FrameArena::Print(std::ostream& anOutputStream) const
+{
+	anOutputStream << "Frame arena: [Used: " << myOffset << ", High water mark: " << myHighWaterMark << ", Capacity: " << myCapacity << "]\n";
+}
+
+#endif // IS_DEVELOPMENT_BUILD
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "GlobalDefines.h"
+
+#include <cstddef>
+#include <stdint.h>
+
+#if IS_DEVELOPMENT_BUILD
+#include <iostream>
+#endif // IS_DEVELOPMENT_BUILD
+
+namespace dbz
+{
+
+class AllocationTracker;
+
+// Linear allocator for scratch memory. Allocations are never freed one by one, the whole
+// arena is reset once per frame or rewound to a previously taken marker
+class FrameArena
+{
+public:
+	using Marker = size_t;
+
+	// Rewinds the arena to where it was when the scope was created
+	class Scope
+	{
+	public:
+		explicit Scope(FrameArena& anArena)
+			: myArena(anArena)
+			, myMarker(anArena.GetMarker())
+		{ }
+
+		~Scope() { myArena.Rewind(myMarker); }
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		FrameArena& myArena;
+		Marker myMarker;
+	};
+
+	static FrameArena Create(size_t aCapacity);
+	static void Destroy(FrameArena& anArena);
+
+	// Dummy constructor, does nothing
+	FrameArena() = default;
+
+	// Returns nullptr if there is not enough capacity left. anAlignment must be a power of two
+	DBZ_TRACKED_NOINLINE void* Allocate(size_t aSize, size_t anAlignment = alignof(std::max_align_t));
+
+	template <typename T>
+	T* AllocateArray(size_t aCount) { return static_cast<T*>(Allocate(sizeof(T) * aCount, alignof(T))); }
+
+	// Releases every allocation, meant to be called once per frame
+	void Reset();
+
+	Marker GetMarker() const { return myOffset; }
+	void Rewind(Marker aMarker);
+
+	size_t GetCapacity() const { return myCapacity; }
+	size_t GetUsedSize() const { return myOffset; }
+	// Most memory the arena has had in use at once since it was created
+	size_t GetHighWaterMark() const { return myHighWaterMark; }
+
+	// Live allocations are reported with aTag until the tracker is set back to nullptr, Reset and Rewind
+	// free them. Does nothing in builds without allocation tracking
+#if IS_ALLOCATION_TRACKING_BUILD
+	void SetAllocationTracker(AllocationTracker* aTracker, const char* aTag) { myAllocationTracker = aTracker; myAllocationTag = aTag; }
+#else
+	void SetAllocationTracker(AllocationTracker*, const char*) { }
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+private:
+	FrameArena(uint8_t* someMemory, size_t aCapacity);
+
+	uint8_t* myMemory = nullptr;
+	size_t myCapacity = 0u;
+	size_t myOffset = 0u;
+	size_t myHighWaterMark = 0u;
+
+#if IS_ALLOCATION_TRACKING_BUILD
+	AllocationTracker* myAllocationTracker = nullptr;
+	const char* myAllocationTag = nullptr;
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+#if IS_DEVELOPMENT_BUILD
+public:
+	void Print(std::ostream& anOutputStream) const;
+#endif // IS_DEVELOPMENT_BUILD
+};
+
+}
@@ -0,0 +1,149 @@
+#include "MemoryHeap.h"
+
+namespace dbz
+{
+
+constexpr MemoryHeap::Handle MemoryHeap::ourInvalidHandle;
+
+MemoryHeap MemoryHeap::Create(uint32_t aPageSize, uint32_t anEmptyPageReleaseDelay, MemoryPage::SelectionMethod aSelectionMethod)
+{
+	return MemoryHeap{ aPageSize, anEmptyPageReleaseDelay, aSelectionMethod };
+}
+
+void MemoryHeap::Destroy(MemoryHeap& aHeap)
+{
+	for (Page& page : aHeap.myPages)
+	{
+		if (page.myIsCreated)
+			MemoryPage::Destroy(page.myPage);
+	}
+
+	aHeap.myPages.clear();
+	aHeap.myReleasedPageIndices.clear();
+}
+
+MemoryHeap::Handle MemoryHeap::Allocate(uint32_t aSize, uint32_t anAlignment)
+{
+	// Checked here so invalid requests do not create pages
+	if (aSize == 0u || aSize > myPageSize || anAlignment == 0u || (anAlignment & (anAlignment - 1u)) != 0u)
+		return ourInvalidHandle;
+
+	// Worst case padding is added to the size, so the picked page has room for the allocation. Aligned blocks start
+	// at most at the page size minus the allocation size, so the padding is capped there and an empty page always fits
+	uint32_t maxPadding = anAlignment - 1u < myPageSize - aSize ? anAlignment - 1u : myPageSize - aSize;
+	uint32_t searchSize = aSize + maxPadding;
+
+	// Page with the smallest largest free block that fits, keeps big blocks for big allocations
+	uint32_t pageIndex = UINT32_MAX;
+	for (uint32_t index = 0u; index < myPages.size(); ++index)
+	{
+		const Page& page = myPages[index];
+		if (page.myIsCreated && page.myLargestFreeBlockSize >= searchSize && (pageIndex == UINT32_MAX || page.myLargestFreeBlockSize < myPages[pageIndex].myLargestFreeBlockSize))
+			pageIndex = index;
+	}
+
+	uint32_t offset = pageIndex != UINT32_MAX ? myPages[pageIndex].myPage.Allocate(aSize, anAlignment) : UINT32_MAX;
+	if (offset == UINT32_MAX)
+	{
+		pageIndex = CreatePage();
+		offset = myPages[pageIndex].myPage.Allocate(aSize, anAlignment);
+		if (offset == UINT32_MAX)
+			return ourInvalidHandle;
+	}
+
+	myPages[pageIndex].myEmptyUpdateCount = 0u;
+	UpdatePageSummary(pageIndex);
+
+	return (static_cast<Handle>(pageIndex) << 32u) | offset;
+}
+
+bool MemoryHeap::Free(Handle aHandle)
+{
+	uint32_t pageIndex = GetPageIndex(aHandle);
+	if (pageIndex >= myPages.size() || myPages[pageIndex].myIsCreated == false)
+		return false;
+
+	if (myPages[pageIndex].myPage.Free(GetOffset(aHandle)) == false)
+		return false;
+
+	UpdatePageSummary(pageIndex);
+	return true;
+}
+
+void MemoryHeap::Update()
+{
+	for (uint32_t index = 0u; index < myPages.size(); ++index)
+	{
+		Page& page = myPages[index];
+		if (page.myIsCreated == false)
+			continue;
+
+		if (page.myPage.GetStats().myInUseBytes != 0u)
+		{
+			page.myEmptyUpdateCount = 0u;
+			continue;
+		}
+
+		// Keep empty pages around for a while so allocation spikes do not create and release pages every frame
+		if (++page.myEmptyUpdateCount >= myEmptyPageReleaseDelay)
+		{
+			MemoryPage::Destroy(page.myPage);
+			page.myIsCreated = false;
+			page.myLargestFreeBlockSize = 0u;
+			page.myEmptyUpdateCount = 0u;
+			myReleasedPageIndices.push_back(index);
+		}
+	}
+}
+
+MemoryHeap::MemoryHeap(uint32_t aPageSize, uint32_t anEmptyPageReleaseDelay, MemoryPage::SelectionMethod aSelectionMethod)
+	: myPageSize(aPageSize)
+	, myEmptyPageReleaseDelay(anEmptyPageReleaseDelay)
+	, mySelectionMethod(aSelectionMethod)
+{ }
+
+uint32_t MemoryHeap::CreatePage()
+{
+	uint32_t index = static_cast<uint32_t>(myPages.size());
+	if (myReleasedPageIndices.empty())
+	{
+		myPages.emplace_back();
+	}
+	else
+	{
+		index = myReleasedPageIndices.back();
+		myReleasedPageIndices.pop_back();
+	}
+
+	Page& page = myPages[index];
+	page.myPage = MemoryPage::Create(myPageSize, mySelectionMethod);
+	page.myEmptyUpdateCount = 0u;
+	page.myIsCreated = true;
+	UpdatePageSummary(index);
+
+	return index;
+}
+
+void MemoryHeap::UpdatePageSummary(uint32_t aPageIndex)
+{
+	Page& page = myPages[aPageIndex];
+	page.myLargestFreeBlockSize = page.myPage.GetStats().myLargestFreeBlockSize;
+}
+
+#if IS_DEVELOPMENT_BUILD
+
+void MemoryHeap::Print(std::ostream& anOutputStream) const
+{
+	for (uint32_t index = 0u; index < myPages.size(); ++index)
+	{
+		if (myPages[index].myIsCreated == false)
+			continue;
+
+		anOutputStream << "Page " << index << ":\n";
+		myPages[index].myPage.Print(anOutputStream);
+	}
+}
+
+#endif // IS_DEVELOPMENT_BUILD
+
+}
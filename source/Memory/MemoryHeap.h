@@ -0,0 +1,71 @@
+#pragma once
+
+#include "GlobalDefines.h"
+#include "MemoryPage.h"
+
+#include <stdint.h>
+#include <vector>
+
+#if IS_DEVELOPMENT_BUILD
+#include <iostream>
+#endif // IS_DEVELOPMENT_BUILD
+
+namespace dbz
+{
+
+// Chain of equally sized memory pages, created when no page has room for an allocation and
+// released once they have been empty for a number of updates
+class MemoryHeap
+{
+public:
+	// Page index in the high 32 bits, offset in the page in the low 32 bits
+	using Handle = uint64_t;
+	constexpr static Handle ourInvalidHandle = UINT64_MAX;
+
+	static MemoryHeap Create(uint32_t aPageSize, uint32_t anEmptyPageReleaseDelay, MemoryPage::SelectionMethod aSelectionMethod = MemoryPage::SelectionMethod::TLSF);
+	static void Destroy(MemoryHeap& aHeap);
+
+	static uint32_t GetPageIndex(Handle aHandle) { return static_cast<uint32_t>(aHandle >> 32u); }
+	static uint32_t GetOffset(Handle aHandle) { return static_cast<uint32_t>(aHandle); }
+
+	// Dummy constructor, does nothing
+	MemoryHeap() = default;
+
+	// Returns ourInvalidHandle if aSize is 0 or the allocation does not fit in a page
+	Handle Allocate(uint32_t aSize, uint32_t anAlignment = 1u);
+	bool Free(Handle aHandle);
+
+	// Meant to be called once per frame, releases the pages that stayed empty for the release delay
+	void Update();
+
+	// Pages currently created, released page indices are reused by new pages
+	uint32_t GetPageCount() const { return static_cast<uint32_t>(myPages.size() - myReleasedPageIndices.size()); }
+
+private:
+	struct Page
+	{
+		MemoryPage myPage;
+		// Lower bound of the largest free block, used to pick a page without asking each one
+		uint32_t myLargestFreeBlockSize = 0u;
+		uint32_t myEmptyUpdateCount = 0u;
+		bool myIsCreated = false;
+	};
+
+	MemoryHeap(uint32_t aPageSize, uint32_t anEmptyPageReleaseDelay, MemoryPage::SelectionMethod aSelectionMethod);
+
+	uint32_t CreatePage();
+	void UpdatePageSummary(uint32_t aPageIndex);
+
+	std::vector<Page> myPages;
+	std::vector<uint32_t> myReleasedPageIndices;
+	uint32_t myPageSize = 0u;
+	uint32_t myEmptyPageReleaseDelay = 0u;
+	MemoryPage::SelectionMethod mySelectionMethod = MemoryPage::SelectionMethod::TLSF;
+
+#if IS_DEVELOPMENT_BUILD
+public:
+	void Print(std::ostream& anOutputStream) const;
+#endif // IS_DEVELOPMENT_BUILD
+};
+
+}
@@ -1,8 +1,48 @@
 #include "MemoryPage.h"
 
+#include "AllocationTrace.h"
+#include "AllocationTracker.h"
+#include "BitOperations.h"
+
+#include <algorithm>
+
 namespace dbz
 {
 
+namespace
+{
+	// Maps a size to the TLSF class holding the free blocks of that size
+	template <uint32_t SecondLevelLog2>
+	void MapTLSFClass(uint32_t aSize, uint32_t& aFirstLevelOut, uint32_t& aSecondLevelOut)
+	{
+		constexpr uint32_t secondLevelCount = 1u << SecondLevelLog2;
+		if (aSize < secondLevelCount)
+		{
+			// Small sizes get a class each
+			aFirstLevelOut = 0u;
+			aSecondLevelOut = aSize;
+		}
+		else
+		{
+			uint32_t lastSetBit = FindLastSetBit(aSize);
+			aFirstLevelOut = lastSetBit - SecondLevelLog2 + 1u;
+			aSecondLevelOut = (aSize >> (lastSetBit - SecondLevelLog2)) - secondLevelCount;
+		}
+	}
+
+	// Bytes needed in front of anOffset to align it to anAlignment
+	inline uint32_t AlignmentPadding(uint32_t anOffset, uint32_t anAlignment)
+	{
+		return (anAlignment - (anOffset & (anAlignment - 1u))) & (anAlignment - 1u);
+	}
+
+	// Whether a block can hold aSize bytes once its offset is aligned
+	inline bool FitsAligned(uint32_t aBlockOffset, uint32_t aBlockSize, uint32_t aSize, uint32_t anAlignment)
+	{
+		return static_cast<uint64_t>(AlignmentPadding(aBlockOffset, anAlignment)) + aSize <= aBlockSize;
+	}
+}
+
 MemoryPage MemoryPage::Create(uint32_t aSize, SelectionMethod aSelectionMethod)
 {
 	SelectionMethodFn selectionMethod = nullptr;
@@ -10,253 +50,810 @@ MemoryPage MemoryPage::Create(uint32_t aSize, SelectionMethod aSelectionMethod)
 	switch (aSelectionMethod)
 	{
 	case SelectionMethod::FIRST_FIT:
-		selectionMethod = &FirstFit;
+		selectionMethod = &MemoryPage::FirstFit;
 		break;
 	case SelectionMethod::BEST_FIT:
-		selectionMethod = &BestFit;
+		selectionMethod = &MemoryPage::BestFit;
+		break;
+	case SelectionMethod::TLSF:
+		selectionMethod = &MemoryPage::TLSFFit;
+		break;
+	case SelectionMethod::BUDDY:
+		// Buddy page handles allocations on its own
 		break;
 	}
 
-	return MemoryPage{ aSize, selectionMethod };
+	return MemoryPage{ aSize, aSelectionMethod, selectionMethod };
 }
 
 void MemoryPage::Destroy(MemoryPage& aMemoryPage)
 {
+	aMemoryPage.myFirstBlockIndex = UINT32_MAX;
 	aMemoryPage.myFreeBlockIndex = UINT32_MAX;
-	aMemoryPage.myInUseBlockIndex = UINT32_MAX;
 	aMemoryPage.myUnusedBlockIndices = UINT32_MAX;
+	aMemoryPage.ResetDefragmentCursor();
 	aMemoryPage.myBlocks.clear();
+	aMemoryPage.myInUseBlockIndices.clear();
+	aMemoryPage.myTLSFFirstLevelBitmap = 0u;
+	std::fill(std::begin(aMemoryPage.myTLSFSecondLevelBitmaps), std::end(aMemoryPage.myTLSFSecondLevelBitmaps), 0u);
+	aMemoryPage.myStats = MemoryPageStats{};
+	aMemoryPage.myFreeBlockClassFirstLevelBitmap = 0u;
+	std::fill(std::begin(aMemoryPage.myFreeBlockClassSecondLevelBitmaps), std::end(aMemoryPage.myFreeBlockClassSecondLevelBitmaps), 0u);
+	std::fill(&aMemoryPage.myFreeBlockClassCounts[0][0], &aMemoryPage.myFreeBlockClassCounts[0][0] + ourTLSFFirstLevelCount * ourTLSFSecondLevelCount, 0u);
+	BuddyPage::Destroy(aMemoryPage.myBuddyPage);
+
+#if IS_ALLOCATION_TRACKING_BUILD
+	if (aMemoryPage.myAllocationTracker != nullptr)
+		aMemoryPage.myAllocationTracker->RecordAllocatorDestroyed(&aMemoryPage);
+#endif // IS_ALLOCATION_TRACKING_BUILD
 }
 
-uint32_t MemoryPage::Allocate(uint32_t aSize)
+uint32_t MemoryPage::Allocate(uint32_t aSize, uint32_t anAlignment)
 {
-	uint32_t allocationOffset = UINT32_MAX;
+	uint32_t offset = mySelectionMethod == SelectionMethod::BUDDY ? myBuddyPage.Allocate(aSize, anAlignment) : AllocateBlock(aSize, anAlignment);
+	if (offset != UINT32_MAX)
+		ResetDefragmentCursor();
+	if (myAllocationTrace != nullptr)
+		myAllocationTrace->RecordAllocate(aSize, anAlignment, offset);
+
+#if IS_ALLOCATION_TRACKING_BUILD
+	if (myAllocationTracker != nullptr && offset != UINT32_MAX)
+		myAllocationTracker->RecordAllocate(this, offset, aSize, myAllocationTag, DBZ_RETURN_ADDRESS());
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	return offset;
+}
 
-	uint32_t parentIndex = UINT32_MAX;
-	uint32_t index = (this->*mySelectionMethodFn)(aSize, parentIndex);
-	if (index != UINT32_MAX)
-	{
-		allocationOffset = myBlocks[index].myOffset;
+bool MemoryPage::Free(uint32_t anOffset)
+{
+	bool succeeded = mySelectionMethod == SelectionMethod::BUDDY ? myBuddyPage.Free(anOffset) : FreeBlock(anOffset);
+	if (succeeded)
+		ResetDefragmentCursor();
+	if (myAllocationTrace != nullptr)
+		myAllocationTrace->RecordFree(anOffset, succeeded);
+
+#if IS_ALLOCATION_TRACKING_BUILD
+	if (myAllocationTracker != nullptr && succeeded)
+		myAllocationTracker->RecordFree(this, anOffset);
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	return succeeded;
+}
 
-		if (myBlocks[index].mySize == aSize)
-		{
-			uint32_t* toUpdate = parentIndex != UINT32_MAX ? &myBlocks[parentIndex].myNext : &myFreeBlockIndex;
-			*toUpdate = myBlocks[index].myNext;
-			myBlocks[index].myNext = myInUseBlockIndex;
-			myInUseBlockIndex = index;
-		}
-		else
+uint32_t MemoryPage::AllocateBatch(uint32_t aSize, uint32_t aCount, uint32_t* someOffsetsOut, uint32_t anAlignment)
+{
+	uint32_t allocatedCount = 0u;
+	if (mySelectionMethod == SelectionMethod::BUDDY)
+	{
+		// Buddy blocks are split by powers of two already, nothing to gain by carving them by hand
+		while (allocatedCount < aCount)
 		{
-			// Update new block
-			uint32_t blockIndex = GetUnusedBlockIndex();
-			myBlocks[blockIndex].myOffset = myBlocks[index].myOffset;
-			myBlocks[blockIndex].mySize = aSize;
-			myBlocks[blockIndex].myNext = myInUseBlockIndex;
-
-			// Update head of used blocks
-			myInUseBlockIndex = blockIndex;
-
-			// Update existing block
-			myBlocks[index].myOffset += aSize;
-			myBlocks[index].mySize -= aSize;
+			uint32_t offset = myBuddyPage.Allocate(aSize, anAlignment);
+			if (offset == UINT32_MAX)
+				break;
+
+			someOffsetsOut[allocatedCount++] = offset;
 		}
 	}
+	else
+	{
+		allocatedCount = AllocateBlockBatch(aSize, aCount, someOffsetsOut, anAlignment);
+	}
 
-	return allocationOffset;
+	if (allocatedCount != 0u)
+		ResetDefragmentCursor();
+
+	if (myAllocationTrace != nullptr)
+	{
+		for (uint32_t i = 0u; i < aCount; ++i)
+			myAllocationTrace->RecordAllocate(aSize, anAlignment, i < allocatedCount ? someOffsetsOut[i] : UINT32_MAX);
+	}
+
+#if IS_ALLOCATION_TRACKING_BUILD
+	if (myAllocationTracker != nullptr)
+	{
+		for (uint32_t i = 0u; i < allocatedCount; ++i)
+			myAllocationTracker->RecordAllocate(this, someOffsetsOut[i], aSize, myAllocationTag, DBZ_RETURN_ADDRESS());
+	}
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	return allocatedCount;
 }
 
-bool MemoryPage::Free(uint32_t anOffset)
+uint32_t MemoryPage::FreeBatch(uint32_t* someOffsets, uint32_t aCount)
 {
-	// Find block
-	uint32_t toFreeIndex = UINT32_MAX;
-	uint32_t parentIndex = UINT32_MAX;
-	uint32_t index = myInUseBlockIndex;
-	while (index != UINT32_MAX)
+	// In offset order each freed block can only merge with the one freed before it or with blocks already free
+	std::sort(someOffsets, someOffsets + aCount);
+
+	uint32_t freedCount = 0u;
+	uint32_t pendingIndex = UINT32_MAX;
+	for (uint32_t i = 0u; i < aCount; ++i)
 	{
-		const Block& block = myBlocks[index];
-		if (block.myOffset == anOffset)
-		{
-			toFreeIndex = index;
-			uint32_t* toUpdateIndex = parentIndex != UINT32_MAX ? &myBlocks[parentIndex].myNext : &myInUseBlockIndex;
-			*toUpdateIndex = block.myNext;
-			break;
-		}
+		bool succeeded = mySelectionMethod == SelectionMethod::BUDDY ? myBuddyPage.Free(someOffsets[i]) : FreeBlockInBatch(someOffsets[i], pendingIndex);
+		if (myAllocationTrace != nullptr)
+			myAllocationTrace->RecordFree(someOffsets[i], succeeded);
 
-		parentIndex = index;
-		index = block.myNext;
+#if IS_ALLOCATION_TRACKING_BUILD
+		if (myAllocationTracker != nullptr && succeeded)
+			myAllocationTracker->RecordFree(this, someOffsets[i]);
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+		freedCount += succeeded ? 1u : 0u;
+	}
+
+	if (pendingIndex != UINT32_MAX)
+		InsertPendingFreeBlock(pendingIndex);
+
+	if (freedCount != 0u)
+		ResetDefragmentCursor();
+
+	return freedCount;
+}
+
+uint32_t MemoryPage::GetAllocationSize(uint32_t anOffset) const
+{
+	if (mySelectionMethod == SelectionMethod::BUDDY)
+		return myBuddyPage.GetAllocationSize(anOffset);
+
+	auto it = myInUseBlockIndices.find(anOffset);
+	return it != myInUseBlockIndices.end() ? myBlocks[it->second].mySize : 0u;
+}
+
+uint32_t MemoryPage::AllocateBlock(uint32_t aSize, uint32_t anAlignment)
+{
+	// Zero sized blocks would share their offset with the next block
+	if (aSize == 0u || anAlignment == 0u || (anAlignment & (anAlignment - 1u)) != 0u)
+	{
+		++myStats.myFailedAllocationCount;
+		return UINT32_MAX;
+	}
+
+	uint32_t index = (this->*mySelectionMethodFn)(aSize, anAlignment);
+	if (index == UINT32_MAX)
+	{
+		++myStats.myFailedAllocationCount;
+		return UINT32_MAX;
 	}
 
+	// Give padding back to the page as its own free block
+	uint32_t padding = AlignmentPadding(myBlocks[index].myOffset, anAlignment);
+	if (padding != 0u)
+		InsertFreeBlock(SplitFreeBlock(index, padding));
+
+	if (myBlocks[index].mySize == aSize)
+		RemoveFreeBlock(index);
+	else
+		index = SplitFreeBlock(index, aSize);
+
+	myBlocks[index].myAlignment = anAlignment;
+	uint32_t allocationOffset = myBlocks[index].myOffset;
+	myInUseBlockIndices.emplace(allocationOffset, index);
+
+	++myStats.myAllocationCount;
+	myStats.myInUseBytes += aSize;
+	return allocationOffset;
+}
+
+bool MemoryPage::FreeBlock(uint32_t anOffset)
+{
+	auto it = myInUseBlockIndices.find(anOffset);
+
 	// Requested offset does not belong to this page
-	if (toFreeIndex == UINT32_MAX)
+	if (it == myInUseBlockIndices.end())
+	{
+		++myStats.myFailedFreeCount;
 		return false;
+	}
 
-	// Merge freed block with pre-existing free block if possible
-	Block& blockToFree = myBlocks[toFreeIndex];
-	uint32_t nextOffset = anOffset + blockToFree.mySize;
-	uint32_t mergedBlockParentIndex = UINT32_MAX;
-	parentIndex = UINT32_MAX;
-	index = myFreeBlockIndex;
-	bool mergedBlock = false;
-	while (index != UINT32_MAX)
+	uint32_t index = it->second;
+	myInUseBlockIndices.erase(it);
+
+	++myStats.myFreeCount;
+	myStats.myInUseBytes -= myBlocks[index].mySize;
+
+	// Merge with physical neighbours, previous block absorbs the freed one
+	uint32_t previousIndex = myBlocks[index].myPreviousPhysical;
+	if (previousIndex != UINT32_MAX && myBlocks[previousIndex].myIsFree)
 	{
-		Block& block = myBlocks[index];
+		RemoveFreeBlock(previousIndex);
+		MergeWithNextPhysicalBlock(previousIndex);
+		index = previousIndex;
+	}
 
-		// Merge to existing block
-		if (block.myOffset + block.mySize == anOffset)
-		{
-			if (mergedBlock)
-			{
-				uint32_t* toUpdateIndex = mergedBlockParentIndex != UINT32_MAX ? &myBlocks[mergedBlockParentIndex].myNext : &myFreeBlockIndex;
-				Block& blockToFree = myBlocks[*toUpdateIndex];
-				block.mySize += blockToFree.mySize;
-				*toUpdateIndex = blockToFree.myNext;
+	uint32_t nextIndex = myBlocks[index].myNextPhysical;
+	if (nextIndex != UINT32_MAX && myBlocks[nextIndex].myIsFree)
+	{
+		RemoveFreeBlock(nextIndex);
+		MergeWithNextPhysicalBlock(index);
+	}
 
-				// Release block
-				blockToFree.myNext = myUnusedBlockIndices;
-				myUnusedBlockIndices = *toUpdateIndex;
+	InsertFreeBlock(index);
+	return true;
+}
 
-				break;
-			}
+uint32_t MemoryPage::AllocateBlockBatch(uint32_t aSize, uint32_t aCount, uint32_t* someOffsetsOut, uint32_t anAlignment)
+{
+	if (aSize == 0u || anAlignment == 0u || (anAlignment & (anAlignment - 1u)) != 0u)
+	{
+		myStats.myFailedAllocationCount += aCount;
+		return 0u;
+	}
 
-			block.mySize += blockToFree.mySize;
-			mergedBlock = true;
-			mergedBlockParentIndex = parentIndex;
-		}
+	uint32_t allocatedCount = 0u;
+	while (allocatedCount < aCount)
+	{
+		uint32_t index = (this->*mySelectionMethodFn)(aSize, anAlignment);
+		if (index == UINT32_MAX)
+			break;
 
-		// Merge existing block to freed one
-		if (block.myOffset == nextOffset)
+		// The block is taken out of the free lists once and carved from the front, the selection
+		// method guarantees the first allocation fits
+		RemoveFreeBlock(index);
+		while (allocatedCount < aCount)
 		{
-			if (mergedBlock)
-			{
-				uint32_t* toUpdateIndex = mergedBlockParentIndex != UINT32_MAX ? &myBlocks[mergedBlockParentIndex].myNext : &myFreeBlockIndex;
-				Block& blockToFree = myBlocks[*toUpdateIndex];
-				block.mySize += blockToFree.mySize;
-				block.myOffset = blockToFree.myOffset;
-				*toUpdateIndex = blockToFree.myNext;
+			uint32_t padding = AlignmentPadding(myBlocks[index].myOffset, anAlignment);
+			if (static_cast<uint64_t>(padding) + aSize > myBlocks[index].mySize)
+				break;
 
-				// Release block
-				blockToFree.myNext = myUnusedBlockIndices;
-				myUnusedBlockIndices = *toUpdateIndex;
+			// Blocks in front are in use, so the padding has no free neighbour to merge with
+			if (padding != 0u)
+				InsertFreeBlock(SplitBlockFront(index, padding));
 
-				break;
-			}
+			uint32_t blockIndex = index;
+			if (myBlocks[index].mySize == aSize)
+				index = UINT32_MAX;
+			else
+				blockIndex = SplitBlockFront(index, aSize);
+
+			myBlocks[blockIndex].myAlignment = anAlignment;
+			uint32_t allocationOffset = myBlocks[blockIndex].myOffset;
+			myInUseBlockIndices.emplace(allocationOffset, blockIndex);
+			someOffsetsOut[allocatedCount++] = allocationOffset;
 
-			block.myOffset -= blockToFree.mySize;
-			block.mySize += blockToFree.mySize;
-			mergedBlock = true;
-			mergedBlockParentIndex = parentIndex;
+			if (index == UINT32_MAX)
+				break;
 		}
 
-		parentIndex = index;
-		index = block.myNext;
+		// Whatever is left goes back once, its next block is in use as free blocks are always merged
+		if (index != UINT32_MAX)
+			InsertFreeBlock(index);
 	}
 
-	if (mergedBlock)
+	myStats.myAllocationCount += allocatedCount;
+	myStats.myFailedAllocationCount += aCount - allocatedCount;
+	myStats.myInUseBytes += aSize * allocatedCount;
+	return allocatedCount;
+}
+
+bool MemoryPage::FreeBlockInBatch(uint32_t anOffset, uint32_t& aPendingIndex)
+{
+	auto it = myInUseBlockIndices.find(anOffset);
+	if (it == myInUseBlockIndices.end())
 	{
-		blockToFree.myNext = myUnusedBlockIndices;
-		myUnusedBlockIndices = toFreeIndex;
+		++myStats.myFailedFreeCount;
+		return false;
 	}
-	else
+
+	uint32_t index = it->second;
+	myInUseBlockIndices.erase(it);
+
+	++myStats.myFreeCount;
+	myStats.myInUseBytes -= myBlocks[index].mySize;
+
+	// Merge with the free block in front first, it may sit between the freed block and the pending one
+	uint32_t previousIndex = myBlocks[index].myPreviousPhysical;
+	if (previousIndex != UINT32_MAX && previousIndex != aPendingIndex && myBlocks[previousIndex].myIsFree)
 	{
-		// Could not merge blocks, so we just push it to the front
-		blockToFree.myNext = myFreeBlockIndex;
-		myFreeBlockIndex = toFreeIndex;
+		RemoveFreeBlock(previousIndex);
+		MergeWithNextPhysicalBlock(previousIndex);
+		index = previousIndex;
+		previousIndex = myBlocks[index].myPreviousPhysical;
 	}
 
+	if (previousIndex != UINT32_MAX && previousIndex == aPendingIndex)
+	{
+		// Grow the pending block without touching the free lists
+		MergeWithNextPhysicalBlock(aPendingIndex);
+		return true;
+	}
+
+	if (aPendingIndex != UINT32_MAX)
+		InsertPendingFreeBlock(aPendingIndex);
+
+	aPendingIndex = index;
 	return true;
 }
 
-uint32_t MemoryPage::FirstFit(uint32_t aSize, uint32_t& aParentIndexOut) const
+void MemoryPage::InsertPendingFreeBlock(uint32_t anIndex)
+{
+	uint32_t nextIndex = myBlocks[anIndex].myNextPhysical;
+	if (nextIndex != UINT32_MAX && myBlocks[nextIndex].myIsFree)
+	{
+		RemoveFreeBlock(nextIndex);
+		MergeWithNextPhysicalBlock(anIndex);
+	}
+
+	InsertFreeBlock(anIndex);
+}
+
+bool MemoryPage::Defragment(uint32_t aMaxBytesPerStep, const RelocateCallback& aRelocateCallback)
+{
+	if (mySelectionMethod == SelectionMethod::BUDDY || myIsDefragmented)
+		return true;
+
+	uint32_t index = myDefragmentCursor != UINT32_MAX ? myDefragmentCursor : myFirstBlockIndex;
+	uint32_t movedBytes = 0u;
+	uint32_t visitedBlockCount = 0u;
+	while (index != UINT32_MAX)
+	{
+		// Checked after the first move, so a zero budget still makes progress
+		if ((movedBytes != 0u && movedBytes >= aMaxBytesPerStep) || visitedBlockCount == ourMaxDefragmentVisitedBlocks)
+		{
+			myDefragmentCursor = index;
+			return false;
+		}
+		++visitedBlockCount;
+
+		// Compaction goes from hole to hole
+		if (myBlocks[index].myIsFree == false)
+		{
+			index = myBlocks[index].myNextPhysical;
+			continue;
+		}
+
+		// Free blocks are always merged, so the next block is in use
+		uint32_t inUseIndex = myBlocks[index].myNextPhysical;
+		if (inUseIndex == UINT32_MAX)
+			break;
+
+		const Block& inUseBlock = myBlocks[inUseIndex];
+		uint32_t newOffset = myBlocks[index].myOffset + AlignmentPadding(myBlocks[index].myOffset, inUseBlock.myAlignment);
+		if (newOffset == inUseBlock.myOffset)
+		{
+			// Hole is too small to move the block and keep it aligned, carry on after the block
+			index = inUseIndex;
+			continue;
+		}
+
+		uint32_t oldOffset = inUseBlock.myOffset;
+		uint32_t size = inUseBlock.mySize;
+		MoveInUseBlockToFront(index, inUseIndex, newOffset);
+
+		myInUseBlockIndices.erase(oldOffset);
+		myInUseBlockIndices.emplace(newOffset, inUseIndex);
+		aRelocateCallback(oldOffset, newOffset, size);
+		if (myAllocationTrace != nullptr)
+			myAllocationTrace->RecordMove(oldOffset, newOffset);
+
+#if IS_ALLOCATION_TRACKING_BUILD
+		if (myAllocationTracker != nullptr)
+			myAllocationTracker->RecordMove(this, oldOffset, newOffset);
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+		// The hole is now behind the moved block
+		movedBytes += size;
+	}
+
+	myDefragmentCursor = UINT32_MAX;
+	myIsDefragmented = true;
+	return true;
+}
+
+MemoryPageStats MemoryPage::GetStats() const
+{
+	if (mySelectionMethod == SelectionMethod::BUDDY)
+		return myBuddyPage.GetStats();
+
+	MemoryPageStats stats = myStats;
+	if (myFreeBlockClassFirstLevelBitmap != 0u)
+	{
+		uint32_t firstLevel = FindLastSetBit(myFreeBlockClassFirstLevelBitmap);
+		uint32_t secondLevel = FindLastSetBit(myFreeBlockClassSecondLevelBitmaps[firstLevel]);
+		stats.myLargestFreeBlockSize = firstLevel == 0u ? secondLevel : (ourTLSFSecondLevelCount + secondLevel) << (firstLevel - 1u);
+	}
+
+	return stats;
+}
+
+uint32_t MemoryPage::FirstFit(uint32_t aSize, uint32_t anAlignment) const
 {
 	uint32_t index = myFreeBlockIndex;
-	uint32_t parentIndex = UINT32_MAX;
 
 	while (index != UINT32_MAX)
 	{
 		const Block& block = myBlocks[index];
-		if (block.mySize >= aSize)
+		if (FitsAligned(block.myOffset, block.mySize, aSize, anAlignment))
 			break;
 
-		parentIndex = index;
 		index = block.myNext;
 	}
 
-	aParentIndexOut = parentIndex;
 	return index;
 }
 
-uint32_t MemoryPage::BestFit(uint32_t aSize, uint32_t& aParentIndexOut) const
+uint32_t MemoryPage::BestFit(uint32_t aSize, uint32_t anAlignment) const
 {
 	uint32_t minSpareMemory = UINT32_MAX;
 	uint32_t bestBlockIndex = UINT32_MAX;
 	uint32_t index = myFreeBlockIndex;
-	uint32_t parentIndex = UINT32_MAX;
 
 	while (index != UINT32_MAX)
 	{
 		const Block& block = myBlocks[index];
-		if (block.mySize >= aSize && minSpareMemory > (block.mySize - aSize))
+		if (block.mySize >= aSize && minSpareMemory > (block.mySize - aSize) && FitsAligned(block.myOffset, block.mySize, aSize, anAlignment))
 		{
 			bestBlockIndex = index;
-			aParentIndexOut = parentIndex;
 			minSpareMemory = block.mySize - aSize;
 		}
 
-		parentIndex = index;
 		index = block.myNext;
 	}
 
 	return bestBlockIndex;
 }
 
+uint32_t MemoryPage::TLSFFit(uint32_t aSize, uint32_t anAlignment) const
+{
+	// Worst case padding is added to the size, so any block in the found list fits the request once aligned
+	uint64_t searchSize = static_cast<uint64_t>(aSize) + anAlignment - 1u;
+	if (searchSize > UINT32_MAX)
+		return TLSFScanFit(aSize, anAlignment);
+
+	// Round size up to the next class so any block in the found list fits the request
+	if (searchSize >= ourTLSFSecondLevelCount)
+		searchSize += (1ull << (FindLastSetBit(static_cast<uint32_t>(searchSize)) - ourTLSFSecondLevelLog2)) - 1u;
+
+	if (searchSize > UINT32_MAX)
+		return TLSFScanFit(aSize, anAlignment);
+
+	uint32_t firstLevel = 0u;
+	uint32_t secondLevel = 0u;
+	MapTLSFClass<ourTLSFSecondLevelLog2>(static_cast<uint32_t>(searchSize), firstLevel, secondLevel);
+
+	uint32_t secondLevelBitmap = myTLSFSecondLevelBitmaps[firstLevel] & (UINT32_MAX << secondLevel);
+	if (secondLevelBitmap == 0u)
+	{
+		// Nothing left in this first level class, take the smallest bigger one
+		uint32_t firstLevelBitmap = firstLevel + 1u < ourTLSFFirstLevelCount ? myTLSFFirstLevelBitmap & (UINT32_MAX << (firstLevel + 1u)) : 0u;
+		if (firstLevelBitmap == 0u)
+			return TLSFScanFit(aSize, anAlignment);
+
+		firstLevel = FindFirstSetBit(firstLevelBitmap);
+		secondLevelBitmap = myTLSFSecondLevelBitmaps[firstLevel];
+	}
+
+	secondLevel = FindFirstSetBit(secondLevelBitmap);
+	return myTLSFFreeBlockIndices[firstLevel][secondLevel];
+}
+
+uint32_t MemoryPage::TLSFScanFit(uint32_t aSize, uint32_t anAlignment) const
+{
+	// Padding below the class granularity of aSize only costs the rounding TLSF already accepts, so those requests
+	// fail in constant time like unaligned ones. Bigger alignments, such as a full page at full page alignment, may
+	// still fit a block the class lookup skipped
+	uint32_t classGranularity = aSize >= ourTLSFSecondLevelCount ? 1u << (FindLastSetBit(aSize) - ourTLSFSecondLevelLog2) : 1u;
+	if (anAlignment <= classGranularity)
+		return UINT32_MAX;
+
+	// Blocks of the class holding aSize and up may fit once aligned
+	uint32_t firstLevel = 0u;
+	uint32_t secondLevel = 0u;
+	MapTLSFClass<ourTLSFSecondLevelLog2>(aSize, firstLevel, secondLevel);
+
+	uint32_t visitedBlockCount = 0u;
+	uint32_t firstLevelBitmap = myTLSFFirstLevelBitmap & (UINT32_MAX << firstLevel);
+	while (firstLevelBitmap != 0u)
+	{
+		uint32_t level = FindFirstSetBit(firstLevelBitmap);
+		firstLevelBitmap &= firstLevelBitmap - 1u;
+
+		uint32_t secondLevelBitmap = myTLSFSecondLevelBitmaps[level] & (level == firstLevel ? UINT32_MAX << secondLevel : UINT32_MAX);
+		while (secondLevelBitmap != 0u)
+		{
+			uint32_t index = myTLSFFreeBlockIndices[level][FindFirstSetBit(secondLevelBitmap)];
+			secondLevelBitmap &= secondLevelBitmap - 1u;
+
+			for (; index != UINT32_MAX; index = myBlocks[index].myNext)
+			{
+				if (FitsAligned(myBlocks[index].myOffset, myBlocks[index].mySize, aSize, anAlignment))
+					return index;
+
+				if (++visitedBlockCount == ourMaxTLSFScannedBlocks)
+					return UINT32_MAX;
+			}
+		}
+	}
+
+	return UINT32_MAX;
+}
+
+void MemoryPage::InsertFreeBlock(uint32_t anIndex)
+{
+	Block& block = myBlocks[anIndex];
+	block.myIsFree = true;
+	block.myPrevious = UINT32_MAX;
+	AddFreeBlockStats(block.mySize);
+
+	if (mySelectionMethod != SelectionMethod::TLSF)
+	{
+		// Could not merge blocks, so we just push it to the front
+		block.myNext = myFreeBlockIndex;
+		if (myFreeBlockIndex != UINT32_MAX)
+			myBlocks[myFreeBlockIndex].myPrevious = anIndex;
+		myFreeBlockIndex = anIndex;
+		return;
+	}
+
+	uint32_t firstLevel = 0u;
+	uint32_t secondLevel = 0u;
+	MapTLSFClass<ourTLSFSecondLevelLog2>(block.mySize, firstLevel, secondLevel);
+
+	uint32_t& head = myTLSFFreeBlockIndices[firstLevel][secondLevel];
+	block.myNext = head;
+	if (head != UINT32_MAX)
+		myBlocks[head].myPrevious = anIndex;
+	head = anIndex;
+
+	myTLSFFirstLevelBitmap |= 1u << firstLevel;
+	myTLSFSecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+}
+
+void MemoryPage::RemoveFreeBlock(uint32_t anIndex)
+{
+	Block& block = myBlocks[anIndex];
+
+	uint32_t firstLevel = 0u;
+	uint32_t secondLevel = 0u;
+	uint32_t* head = &myFreeBlockIndex;
+	if (mySelectionMethod == SelectionMethod::TLSF)
+	{
+		MapTLSFClass<ourTLSFSecondLevelLog2>(block.mySize, firstLevel, secondLevel);
+		head = &myTLSFFreeBlockIndices[firstLevel][secondLevel];
+	}
+
+	if (block.myPrevious != UINT32_MAX)
+		myBlocks[block.myPrevious].myNext = block.myNext;
+	else
+		*head = block.myNext;
+
+	if (block.myNext != UINT32_MAX)
+		myBlocks[block.myNext].myPrevious = block.myPrevious;
+
+	// Update bitmaps if the list became empty
+	if (mySelectionMethod == SelectionMethod::TLSF && *head == UINT32_MAX)
+	{
+		myTLSFSecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+		if (myTLSFSecondLevelBitmaps[firstLevel] == 0u)
+			myTLSFFirstLevelBitmap &= ~(1u << firstLevel);
+	}
+
+	block.myIsFree = false;
+	block.myPrevious = UINT32_MAX;
+	block.myNext = UINT32_MAX;
+	RemoveFreeBlockStats(block.mySize);
+}
+
+uint32_t MemoryPage::SplitFreeBlock(uint32_t anIndex, uint32_t aSize)
+{
+	// TLSF blocks change class when shrinking, linear free lists keep the block where it is
+	bool relinkFreeBlock = mySelectionMethod == SelectionMethod::TLSF;
+	if (relinkFreeBlock)
+		RemoveFreeBlock(anIndex);
+	else
+		RemoveFreeBlockStats(myBlocks[anIndex].mySize);
+
+	uint32_t blockIndex = SplitBlockFront(anIndex, aSize);
+
+	if (relinkFreeBlock)
+		InsertFreeBlock(anIndex);
+	else
+		AddFreeBlockStats(myBlocks[anIndex].mySize);
+
+	return blockIndex;
+}
+
+uint32_t MemoryPage::SplitBlockFront(uint32_t anIndex, uint32_t aSize)
+{
+	uint32_t blockIndex = GetUnusedBlockIndex();
+	Block& block = myBlocks[blockIndex];
+	Block& splitBlock = myBlocks[anIndex];
+
+	// New block takes the front of the split block
+	block.myOffset = splitBlock.myOffset;
+	block.mySize = aSize;
+	block.myPreviousPhysical = splitBlock.myPreviousPhysical;
+	block.myNextPhysical = anIndex;
+	if (splitBlock.myPreviousPhysical != UINT32_MAX)
+		myBlocks[splitBlock.myPreviousPhysical].myNextPhysical = blockIndex;
+	else
+		myFirstBlockIndex = blockIndex;
+
+	splitBlock.myOffset += aSize;
+	splitBlock.mySize -= aSize;
+	splitBlock.myPreviousPhysical = blockIndex;
+
+	return blockIndex;
+}
+
+void MemoryPage::MergeWithNextPhysicalBlock(uint32_t anIndex)
+{
+	Block& block = myBlocks[anIndex];
+	uint32_t nextIndex = block.myNextPhysical;
+	Block& nextBlock = myBlocks[nextIndex];
+
+	block.mySize += nextBlock.mySize;
+	block.myNextPhysical = nextBlock.myNextPhysical;
+	if (nextBlock.myNextPhysical != UINT32_MAX)
+		myBlocks[nextBlock.myNextPhysical].myPreviousPhysical = anIndex;
+
+	ReleaseBlockIndex(nextIndex);
+}
+
+void MemoryPage::MoveInUseBlockToFront(uint32_t aFreeIndex, uint32_t anInUseIndex, uint32_t aNewOffset)
+{
+	RemoveFreeBlock(aFreeIndex);
+
+	uint32_t freeOffset = myBlocks[aFreeIndex].myOffset;
+	uint32_t padding = aNewOffset - freeOffset;
+	uint32_t previousIndex = myBlocks[aFreeIndex].myPreviousPhysical;
+	uint32_t nextIndex = myBlocks[anInUseIndex].myNextPhysical;
+
+	// Alignment padding stays in front of the moved block as its own free block
+	uint32_t paddingIndex = UINT32_MAX;
+	if (padding != 0u)
+	{
+		paddingIndex = GetUnusedBlockIndex();
+		myBlocks[paddingIndex].myOffset = freeOffset;
+		myBlocks[paddingIndex].mySize = padding;
+	}
+
+	// Relink as previous -> [padding] -> in use -> free -> next
+	uint32_t frontIndex = paddingIndex != UINT32_MAX ? paddingIndex : anInUseIndex;
+	myBlocks[frontIndex].myPreviousPhysical = previousIndex;
+	if (previousIndex != UINT32_MAX)
+		myBlocks[previousIndex].myNextPhysical = frontIndex;
+	else
+		myFirstBlockIndex = frontIndex;
+
+	if (paddingIndex != UINT32_MAX)
+	{
+		myBlocks[paddingIndex].myNextPhysical = anInUseIndex;
+		myBlocks[anInUseIndex].myPreviousPhysical = paddingIndex;
+	}
+
+	Block& inUseBlock = myBlocks[anInUseIndex];
+	Block& freeBlock = myBlocks[aFreeIndex];
+	inUseBlock.myOffset = aNewOffset;
+	inUseBlock.myNextPhysical = aFreeIndex;
+	freeBlock.myOffset = aNewOffset + inUseBlock.mySize;
+	freeBlock.mySize -= padding;
+	freeBlock.myPreviousPhysical = anInUseIndex;
+	freeBlock.myNextPhysical = nextIndex;
+	if (nextIndex != UINT32_MAX)
+		myBlocks[nextIndex].myPreviousPhysical = aFreeIndex;
+
+	if (nextIndex != UINT32_MAX && myBlocks[nextIndex].myIsFree)
+	{
+		RemoveFreeBlock(nextIndex);
+		MergeWithNextPhysicalBlock(aFreeIndex);
+	}
+
+	InsertFreeBlock(aFreeIndex);
+	if (paddingIndex != UINT32_MAX)
+		InsertFreeBlock(paddingIndex);
+}
+
 uint32_t MemoryPage::GetUnusedBlockIndex()
 {
 	uint32_t index = myUnusedBlockIndices;
 	if (myUnusedBlockIndices == UINT32_MAX)
 	{
-		index = myBlocks.size();
+		index = static_cast<uint32_t>(myBlocks.size());
 		myBlocks.emplace_back();
 	}
 	else
 	{
 		myUnusedBlockIndices = myBlocks[index].myNext;
+		myBlocks[index] = Block{};
 	}
 
 	return index;
 }
 
-MemoryPage::MemoryPage(uint32_t aSize, SelectionMethodFn aSelectionMethodFn)
-	: mySelectionMethodFn(aSelectionMethodFn)
-	, myFreeBlockIndex(0)
+void MemoryPage::ReleaseBlockIndex(uint32_t anIndex)
+{
+	myBlocks[anIndex].myNext = myUnusedBlockIndices;
+	myUnusedBlockIndices = anIndex;
+}
+
+void MemoryPage::AddFreeBlockStats(uint32_t aSize)
+{
+	uint32_t firstLevel = 0u;
+	uint32_t secondLevel = 0u;
+	MapTLSFClass<ourTLSFSecondLevelLog2>(aSize, firstLevel, secondLevel);
+
+	if (myFreeBlockClassCounts[firstLevel][secondLevel]++ == 0u)
+	{
+		myFreeBlockClassFirstLevelBitmap |= 1u << firstLevel;
+		myFreeBlockClassSecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+	}
+
+	myStats.myFreeBytes += aSize;
+	++myStats.myFreeBlockCount;
+	++myStats.myFreeBlockSizeHistogram[FindLastSetBit(aSize)];
+}
+
+void MemoryPage::RemoveFreeBlockStats(uint32_t aSize)
+{
+	uint32_t firstLevel = 0u;
+	uint32_t secondLevel = 0u;
+	MapTLSFClass<ourTLSFSecondLevelLog2>(aSize, firstLevel, secondLevel);
+
+	if (--myFreeBlockClassCounts[firstLevel][secondLevel] == 0u)
+	{
+		myFreeBlockClassSecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+		if (myFreeBlockClassSecondLevelBitmaps[firstLevel] == 0u)
+			myFreeBlockClassFirstLevelBitmap &= ~(1u << firstLevel);
+	}
+
+	myStats.myFreeBytes -= aSize;
+	--myStats.myFreeBlockCount;
+	--myStats.myFreeBlockSizeHistogram[FindLastSetBit(aSize)];
+}
+
+MemoryPage::MemoryPage(uint32_t aSize, SelectionMethod aSelectionMethod, SelectionMethodFn aSelectionMethodFn)
+	: mySelectionMethod(aSelectionMethod)
+	, mySelectionMethodFn(aSelectionMethodFn)
+	, myFirstBlockIndex(0)
 {
-	myBlocks.emplace_back(Block{ 0, aSize, UINT32_MAX });
+	std::fill(&myTLSFFreeBlockIndices[0][0], &myTLSFFreeBlockIndices[0][0] + ourTLSFFirstLevelCount * ourTLSFSecondLevelCount, UINT32_MAX);
+
+	if (aSelectionMethod == SelectionMethod::BUDDY)
+	{
+		myBuddyPage = BuddyPage::Create(aSize);
+		return;
+	}
+
+	// Empty pages hold no blocks, a zero size free block has no size class
+	if (aSize == 0u)
+	{
+		myFirstBlockIndex = UINT32_MAX;
+		return;
+	}
+
+	myBlocks.emplace_back(Block{ 0, aSize });
+	InsertFreeBlock(0);
 }
 
 #if IS_DEVELOPMENT_BUILD
 
 void MemoryPage::Print(std::ostream& anOutputStream) const
 {
+	if (mySelectionMethod == SelectionMethod::BUDDY)
+	{
+		myBuddyPage.Print(anOutputStream);
+		return;
+	}
+
 	anOutputStream << "In use blocks:\n";
 	anOutputStream << "Head";
-	uint32_t index = myInUseBlockIndex;
-	while (index != UINT32_MAX)
+	for (uint32_t index = myFirstBlockIndex; index != UINT32_MAX; index = myBlocks[index].myNextPhysical)
 	{
-		anOutputStream << " -> [Offset: " << myBlocks[index].myOffset << ", Size: " << myBlocks[index].mySize << "]";
-		index = myBlocks[index].myNext;
+		if (myBlocks[index].myIsFree == false)
+			anOutputStream << " -> [Offset: " << myBlocks[index].myOffset << ", Size: " << myBlocks[index].mySize << "]";
 	}
 	anOutputStream << " -> nullptr\n";
 
 	anOutputStream << "Free blocks:\n";
 	anOutputStream << "Head";
-	index = myFreeBlockIndex;
-	while (index != UINT32_MAX)
+	for (uint32_t index = myFirstBlockIndex; index != UINT32_MAX; index = myBlocks[index].myNextPhysical)
 	{
-		anOutputStream << " -> [Offset: " << myBlocks[index].myOffset << ", Size: " << myBlocks[index].mySize << "]";
-		index = myBlocks[index].myNext;
+		if (myBlocks[index].myIsFree)
+			anOutputStream << " -> [Offset: " << myBlocks[index].myOffset << ", Size: " << myBlocks[index].mySize << "]";
 	}
 	anOutputStream << " -> nullptr\n";
 }
 
-#endif // IS_DEBUG_BUILD
+#endif // IS_DEVELOPMENT_BUILD
 
 }
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "BuddyPage.h"
 #include "GlobalDefines.h"
+#include "MemoryPageStats.h"
 
+#include <functional>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 #if IS_DEVELOPMENT_BUILD
@@ -12,45 +16,162 @@
 namespace dbz
 {
 
+class AllocationTrace;
+class AllocationTracker;
+
 class MemoryPage
 {
 public:
 	enum class SelectionMethod
 	{
 		FIRST_FIT = 0,
-		BEST_FIT
+		BEST_FIT,
+		// Two level segregated fit, constant time Allocate and Free regardless of fragmentation. Requests aligned
+		// past their size class granularity that no class guarantees to hold check up to ourMaxTLSFScannedBlocks blocks
+		TLSF,
+		// Buddy system, sizes are rounded up to powers of two of at least BuddyPage::ourDefaultMinBlockSize
+		BUDDY
 	};
 
+	// Called for every block moved by Defragment, the page memory itself must be copied by the owner
+	using RelocateCallback = std::function<void(uint32_t anOldOffset, uint32_t aNewOffset, uint32_t aSize)>;
+
 	static MemoryPage Create(uint32_t aSize, SelectionMethod aSelectionMethod = SelectionMethod::FIRST_FIT);
 	static void Destroy(MemoryPage& aPage);
 
 	// Dummy constructor, does nothing
 	MemoryPage() = default;
 
-	uint32_t Allocate(uint32_t aSize);
+	// Returns an offset multiple of anAlignment, which must be a power of two. Padding needed
+	// in front of the allocation stays in the page as a free block
+	// Returns UINT32_MAX if there is no room for the allocation or aSize is 0
+	DBZ_TRACKED_NOINLINE uint32_t Allocate(uint32_t aSize, uint32_t anAlignment = 1u);
 	bool Free(uint32_t anOffset);
 
+	// Same as aCount Allocate calls, but each free block found is split into as many allocations as fit in it
+	// before searching again. Returns the number of allocations made, stored in order in someOffsetsOut
+	DBZ_TRACKED_NOINLINE uint32_t AllocateBatch(uint32_t aSize, uint32_t aCount, uint32_t* someOffsetsOut, uint32_t anAlignment = 1u);
+	// Sorts someOffsets in place and frees them in a single sweep, so neighbouring allocations are merged
+	// once instead of per Free. Returns the number of offsets freed
+	uint32_t FreeBatch(uint32_t* someOffsets, uint32_t aCount);
+
+	// Size of the allocation at anOffset, 0 if nothing is allocated there. Buddy pages return the whole block size
+	uint32_t GetAllocationSize(uint32_t anOffset) const;
+
+	// Moves in use blocks towards the start of the page, keeping their alignment, until at least
+	// aMaxBytesPerStep bytes are moved or ourMaxDefragmentVisitedBlocks blocks are looked at. At least one
+	// block is moved per call if one can be moved within the visited blocks. Calls resume where the last one
+	// stopped until an Allocate or Free changes the page
+	// Returns true once there is nothing left to compact. Buddy pages are never compacted
+	bool Defragment(uint32_t aMaxBytesPerStep, const RelocateCallback& aRelocateCallback);
+
+	// Constant time. The largest free block size is rounded down to its TLSF class, which is
+	// within 1/16 of the real size
+	MemoryPageStats GetStats() const;
+
+	// Every Allocate and Free call is recorded to the trace until it is set back to nullptr
+	void SetAllocationTrace(AllocationTrace* aTrace) { myAllocationTrace = aTrace; }
+
+	// Live allocations are reported with aTag until the tracker is set back to nullptr, the page must not be
+	// moved meanwhile. Does nothing in builds without allocation tracking
+#if IS_ALLOCATION_TRACKING_BUILD
+	void SetAllocationTracker(AllocationTracker* aTracker, const char* aTag) { myAllocationTracker = aTracker; myAllocationTag = aTag; }
+#else
+	void SetAllocationTracker(AllocationTracker*, const char*) { }
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
 private:
 	struct Block
 	{
 		uint32_t myOffset = 0u;
 		uint32_t mySize = 0u;
+		// Requested alignment, so blocks keep it when moved
+		uint32_t myAlignment = 1u;
+
+		// Free list links, next is also used to chain unused blocks
 		uint32_t myNext = UINT32_MAX;
+		uint32_t myPrevious = UINT32_MAX;
+
+		// Neighbour blocks in the page, used to merge free blocks without searching for them
+		uint32_t myPreviousPhysical = UINT32_MAX;
+		uint32_t myNextPhysical = UINT32_MAX;
+		bool myIsFree = false;
 	};
 
-	uint32_t FirstFit(uint32_t aSize, uint32_t& aParentNodeOut) const;
-	uint32_t BestFit(uint32_t aSize, uint32_t& aParentNodeOut) const;
+	// Bounds the work of a Defragment step when blocks cannot be moved, which costs nothing of the byte budget
+	constexpr static uint32_t ourMaxDefragmentVisitedBlocks = 256u;
+	// Bounds the slow path of TLSF for big aligned requests
+	constexpr static uint32_t ourMaxTLSFScannedBlocks = 64u;
+
+	// First level classes split sizes in powers of two, second level classes split each of those linearly
+	constexpr static uint32_t ourTLSFSecondLevelLog2 = 4u;
+	constexpr static uint32_t ourTLSFSecondLevelCount = 1u << ourTLSFSecondLevelLog2;
+	constexpr static uint32_t ourTLSFFirstLevelCount = 32u - ourTLSFSecondLevelLog2 + 1u;
+
+	uint32_t AllocateBlock(uint32_t aSize, uint32_t anAlignment);
+	bool FreeBlock(uint32_t anOffset);
+	uint32_t AllocateBlockBatch(uint32_t aSize, uint32_t aCount, uint32_t* someOffsetsOut, uint32_t anAlignment);
+	// Merges the freed block with aPendingIndex, the free block being built by the batch and not yet in a free list
+	bool FreeBlockInBatch(uint32_t anOffset, uint32_t& aPendingIndex);
+	void InsertPendingFreeBlock(uint32_t anIndex);
+
+	uint32_t FirstFit(uint32_t aSize, uint32_t anAlignment) const;
+	uint32_t BestFit(uint32_t aSize, uint32_t anAlignment) const;
+	uint32_t TLSFFit(uint32_t aSize, uint32_t anAlignment) const;
+	// Slow path of TLSFFit for big alignments, checks free blocks of the classes that may hold the request
+	uint32_t TLSFScanFit(uint32_t aSize, uint32_t anAlignment) const;
+
+	void InsertFreeBlock(uint32_t anIndex);
+	void RemoveFreeBlock(uint32_t anIndex);
+	uint32_t SplitFreeBlock(uint32_t anIndex, uint32_t aSize);
+	// Moves the front aSize bytes of a block to a new block, returns the new block index. Free lists are not touched
+	uint32_t SplitBlockFront(uint32_t anIndex, uint32_t aSize);
+	void MergeWithNextPhysicalBlock(uint32_t anIndex);
+	// Swaps an in use block with the free block in front of it
+	void MoveInUseBlockToFront(uint32_t aFreeIndex, uint32_t anInUseIndex, uint32_t aNewOffset);
+
+	// Blocks in front of the cursor are compacted as far as they go, until the page changes
+	void ResetDefragmentCursor() { myDefragmentCursor = UINT32_MAX; myIsDefragmented = false; }
 
 	uint32_t GetUnusedBlockIndex();
+	void ReleaseBlockIndex(uint32_t anIndex);
 
-	using SelectionMethodFn = uint32_t (MemoryPage::*)(uint32_t, uint32_t&) const;
-	MemoryPage(uint32_t aSize, SelectionMethodFn aSelectionMethod);
+	void AddFreeBlockStats(uint32_t aSize);
+	void RemoveFreeBlockStats(uint32_t aSize);
 
+	using SelectionMethodFn = uint32_t (MemoryPage::*)(uint32_t, uint32_t) const;
+	MemoryPage(uint32_t aSize, SelectionMethod aSelectionMethod, SelectionMethodFn aSelectionMethodFn);
+
+	SelectionMethod mySelectionMethod = SelectionMethod::FIRST_FIT;
 	SelectionMethodFn mySelectionMethodFn = nullptr;
 	std::vector<Block> myBlocks;
+	std::unordered_map<uint32_t, uint32_t> myInUseBlockIndices;
+	uint32_t myFirstBlockIndex = UINT32_MAX;
 	uint32_t myFreeBlockIndex = UINT32_MAX;
-	uint32_t myInUseBlockIndex = UINT32_MAX;
 	uint32_t myUnusedBlockIndices = UINT32_MAX;
+	// Block Defragment resumes from, UINT32_MAX to start from the first block
+	uint32_t myDefragmentCursor = UINT32_MAX;
+	bool myIsDefragmented = false;
+
+	// TLSF free lists, a set bit in the bitmaps means the matching list is not empty
+	uint32_t myTLSFFirstLevelBitmap = 0u;
+	uint32_t myTLSFSecondLevelBitmaps[ourTLSFFirstLevelCount] = {};
+	uint32_t myTLSFFreeBlockIndices[ourTLSFFirstLevelCount][ourTLSFSecondLevelCount];
+
+	// Free blocks per TLSF class for every selection method, so the largest free block is found without searching
+	MemoryPageStats myStats;
+	uint32_t myFreeBlockClassFirstLevelBitmap = 0u;
+	uint32_t myFreeBlockClassSecondLevelBitmaps[ourTLSFFirstLevelCount] = {};
+	uint32_t myFreeBlockClassCounts[ourTLSFFirstLevelCount][ourTLSFSecondLevelCount] = {};
+
+	AllocationTrace* myAllocationTrace = nullptr;
+#if IS_ALLOCATION_TRACKING_BUILD
+	AllocationTracker* myAllocationTracker = nullptr;
+	const char* myAllocationTag = nullptr;
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	// Does the bookkeeping when the buddy selection method is used
+	BuddyPage myBuddyPage;
 
 #if IS_DEVELOPMENT_BUILD
 public:
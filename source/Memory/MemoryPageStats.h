@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace dbz
+{
+
+// Occupancy and fragmentation counters, kept up to date in every build type
+struct MemoryPageStats
+{
+	constexpr static uint32_t ourHistogramBucketCount = 32u;
+
+	uint32_t myInUseBytes = 0u;
+	uint32_t myFreeBytes = 0u;
+	// May be rounded down to the size class of the block, see the owning page
+	uint32_t myLargestFreeBlockSize = 0u;
+	uint32_t myFreeBlockCount = 0u;
+	// Bucket i counts the free blocks with a size in [2^i, 2^(i + 1))
+	uint32_t myFreeBlockSizeHistogram[ourHistogramBucketCount] = {};
+
+	uint64_t myAllocationCount = 0u;
+	uint64_t myFailedAllocationCount = 0u;
+	uint64_t myFreeCount = 0u;
+	uint64_t myFailedFreeCount = 0u;
+};
+
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+#include "AlignedAllocation.h"
+
+#if IS_ALLOCATION_TRACKING_BUILD
+#include "AllocationTracker.h"
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+#include <stdint.h>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dbz
+{
+
+class AllocationTracker;
+
+// Fixed size object allocator. Objects live in cache line aligned slabs that are never moved,
+// the pool grows a slab at a time and free slots are chained through an intrusive free list
+template <typename T>
+class PoolAllocator
+{
+public:
+	struct Stats
+	{
+		uint32_t mySlabCount = 0u;
+		uint32_t myCapacity = 0u;
+		uint32_t myLiveObjectCount = 0u;
+		uint32_t myPeakLiveObjectCount = 0u;
+	};
+
+	// Slabs hold at least one object, 0 is treated as 1
+	static PoolAllocator Create(uint32_t anObjectsPerSlab);
+	// Releases all slabs, objects still alive are not destructed
+	static void Destroy(PoolAllocator& aPool);
+
+	// Dummy constructor, does nothing
+	PoolAllocator() = default;
+
+	// Uninitialized memory for a single object, returns nullptr if a new slab could not be allocated
+	DBZ_TRACKED_NOINLINE T* Allocate();
+	void Free(T* anObject);
+
+	template <typename ... ARGS>
+	DBZ_TRACKED_NOINLINE T* Construct(ARGS&&... someArgs);
+	void Destruct(T* anObject);
+
+	// Constructs aCount copies of the arguments growing the pool at most once. Returns the number constructed
+	template <typename ... ARGS>
+	DBZ_TRACKED_NOINLINE uint32_t ConstructBatch(T** someObjectsOut, uint32_t aCount, const ARGS&... someArgs);
+	void DestructBatch(T* const* someObjects, uint32_t aCount);
+
+	const Stats& GetStats() const { return myStats; }
+
+	// Live objects are reported with aTag until the tracker is set back to nullptr, the pool must not be
+	// moved meanwhile. Does nothing in builds without allocation tracking
+#if IS_ALLOCATION_TRACKING_BUILD
+	void SetAllocationTracker(AllocationTracker* aTracker, const char* aTag) { myAllocationTracker = aTracker; myAllocationTag = aTag; }
+#else
+	void SetAllocationTracker(AllocationTracker*, const char*) { }
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+private:
+	union Slot
+	{
+		Slot* myNext;
+		alignas(T) unsigned char myStorage[sizeof(T)];
+	};
+
+	explicit PoolAllocator(uint32_t anObjectsPerSlab);
+
+	bool Grow(uint32_t aSlabCount);
+	// Allocate and Free without reporting to the tracker, so public functions report their own callsite
+	T* AllocateSlot();
+	void FreeSlot(T* anObject);
+
+#if IS_ALLOCATION_TRACKING_BUILD
+	void TrackAllocate(T* anObject, const void* aCallsite)
+	{
+		if (myAllocationTracker != nullptr)
+			myAllocationTracker->RecordAllocate(this, reinterpret_cast<uintptr_t>(anObject), sizeof(T), myAllocationTag, aCallsite);
+	}
+
+	void TrackFree(T* anObject)
+	{
+		if (myAllocationTracker != nullptr)
+			myAllocationTracker->RecordFree(this, reinterpret_cast<uintptr_t>(anObject));
+	}
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	std::vector<Slot*> mySlabs;
+	Slot* myFreeSlots = nullptr;
+	uint32_t myObjectsPerSlab = 0u;
+	Stats myStats;
+
+#if IS_ALLOCATION_TRACKING_BUILD
+	AllocationTracker* myAllocationTracker = nullptr;
+	const char* myAllocationTag = nullptr;
+#endif // IS_ALLOCATION_TRACKING_BUILD
+};
+
+template <typename T>
+PoolAllocator<T> PoolAllocator<T>::Create(uint32_t anObjectsPerSlab)
+{
+	return PoolAllocator{ anObjectsPerSlab };
+}
+
+template <typename T>
+void PoolAllocator<T>::Destroy(PoolAllocator& aPool)
+{
+#if IS_ALLOCATION_TRACKING_BUILD
+	if (aPool.myAllocationTracker != nullptr)
+		aPool.myAllocationTracker->RecordAllocatorDestroyed(&aPool);
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	for (Slot* slab : aPool.mySlabs)
+		FreeAligned(slab);
+
+	aPool.mySlabs.clear();
+	aPool.myFreeSlots = nullptr;
+	aPool.myStats = Stats{};
+}
+
+template <typename T>
+T* PoolAllocator<T>::Allocate()
+{
+	T* object = AllocateSlot();
+
+#if IS_ALLOCATION_TRACKING_BUILD
+	if (object != nullptr)
+		TrackAllocate(object, DBZ_RETURN_ADDRESS());
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	return object;
+}
+
+template <typename T>
+void PoolAllocator<T>::Free(T* anObject)
+{
+#if IS_ALLOCATION_TRACKING_BUILD
+	TrackFree(anObject);
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+	FreeSlot(anObject);
+}
+
+template <typename T>
+template <typename ... ARGS>
+T* PoolAllocator<T>::Construct(ARGS&&... someArgs)
+{
+	T* object = AllocateSlot();
+	if (object != nullptr)
+	{
+		new (object) T(std::forward<ARGS>(someArgs)...);
+
+#if IS_ALLOCATION_TRACKING_BUILD
+		TrackAllocate(object, DBZ_RETURN_ADDRESS());
+#endif // IS_ALLOCATION_TRACKING_BUILD
+	}
+
+	return object;
+}
+
+template <typename T>
+void PoolAllocator<T>::Destruct(T* anObject)
+{
+	anObject->~T();
+	Free(anObject);
+}
+
+template <typename T>
+template <typename ... ARGS>
+uint32_t PoolAllocator<T>::ConstructBatch(T** someObjectsOut, uint32_t aCount, const ARGS&... someArgs)
+{
+	// Grow all needed slabs up front instead of one at a time
+	uint32_t freeSlotCount = myStats.myCapacity - myStats.myLiveObjectCount;
+	if (freeSlotCount < aCount)
+		Grow((aCount - freeSlotCount + myObjectsPerSlab - 1u) / myObjectsPerSlab);
+
+	uint32_t constructedCount = 0u;
+	while (constructedCount < aCount && myFreeSlots != nullptr)
+	{
+		Slot* slot = myFreeSlots;
+		myFreeSlots = slot->myNext;
+
+		someObjectsOut[constructedCount] = new (slot->myStorage) T(someArgs...);
+
+#if IS_ALLOCATION_TRACKING_BUILD
+		TrackAllocate(someObjectsOut[constructedCount], DBZ_RETURN_ADDRESS());
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+		++constructedCount;
+	}
+
+	myStats.myLiveObjectCount += constructedCount;
+	myStats.myPeakLiveObjectCount = myStats.myLiveObjectCount > myStats.myPeakLiveObjectCount ? myStats.myLiveObjectCount : myStats.myPeakLiveObjectCount;
+
+	return constructedCount;
+}
+
+template <typename T>
+void PoolAllocator<T>::DestructBatch(T* const* someObjects, uint32_t aCount)
+{
+	for (uint32_t i = 0; i < aCount; ++i)
+	{
+		someObjects[i]->~T();
+
+#if IS_ALLOCATION_TRACKING_BUILD
+		TrackFree(someObjects[i]);
+#endif // IS_ALLOCATION_TRACKING_BUILD
+
+		Slot* slot = reinterpret_cast<Slot*>(someObjects[i]);
+		slot->myNext = myFreeSlots;
+		myFreeSlots = slot;
+	}
+
+	myStats.myLiveObjectCount -= aCount;
+}
+
+template <typename T>
+PoolAllocator<T>::PoolAllocator(uint32_t anObjectsPerSlab)
+	: myObjectsPerSlab(anObjectsPerSlab > 0u ? anObjectsPerSlab : 1u)
+{ }
+
+template <typename T>
+T* PoolAllocator<T>::AllocateSlot()
+{
+	if (myFreeSlots == nullptr && Grow(1u) == false)
+		return nullptr;
+
+	Slot* slot = myFreeSlots;
+	myFreeSlots = slot->myNext;
+
+	++myStats.myLiveObjectCount;
+	myStats.myPeakLiveObjectCount = myStats.myLiveObjectCount > myStats.myPeakLiveObjectCount ? myStats.myLiveObjectCount : myStats.myPeakLiveObjectCount;
+
+	return reinterpret_cast<T*>(slot->myStorage);
+}
+
+template <typename T>
+void PoolAllocator<T>::FreeSlot(T* anObject)
+{
+	Slot* slot = reinterpret_cast<Slot*>(anObject);
+	slot->myNext = myFreeSlots;
+	myFreeSlots = slot;
+
+	--myStats.myLiveObjectCount;
+}
+
+template <typename T>
+bool PoolAllocator<T>::Grow(uint32_t aSlabCount)
+{
+	for (uint32_t i = 0; i < aSlabCount; ++i)
+	{
+		size_t alignment = alignof(Slot) > CACHE_LINE_SIZE ? alignof(Slot) : CACHE_LINE_SIZE;
+		Slot* slab = static_cast<Slot*>(AllocateAligned(sizeof(Slot) * myObjectsPerSlab, alignment));
+		if (slab == nullptr)
+			return false;
+
+		// Chain slots so they are handed out in address order
+		for (uint32_t j = 0; j + 1u < myObjectsPerSlab; ++j)
+			slab[j].myNext = &slab[j + 1u];
+		slab[myObjectsPerSlab - 1u].myNext = myFreeSlots;
+		myFreeSlots = slab;
+
+		mySlabs.push_back(slab);
+		++myStats.mySlabCount;
+		myStats.myCapacity += myObjectsPerSlab;
+	}
+
+	return true;
+}
+
+}
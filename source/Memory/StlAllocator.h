@@ -0,0 +1,135 @@
+#pragma once
+
+#include "AlignedAllocation.h"
+#include "FrameArena.h"
+#include "PoolAllocator.h"
+#include "VirtualMemoryPage.h"
+
+#include <cstddef>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+
+namespace dbz
+{
+
+// How StlAllocator allocates from an engine allocator. The default works for allocators with
+// void* Allocate(size, alignment) returning nullptr on failure and Free(void*), specialize it for others
+template <typename ALLOCATOR>
+struct StlAllocatorTraits
+{
+	static void* Allocate(ALLOCATOR& anAllocator, size_t aSize, size_t anAlignment) { return anAllocator.Allocate(aSize, anAlignment); }
+	static void Free(ALLOCATOR& anAllocator, void* aPointer, size_t, size_t) { anAllocator.Free(aPointer); }
+};
+
+// Frame arenas release memory on Reset, containers using them must not outlive the frame
+template <>
+struct StlAllocatorTraits<FrameArena>
+{
+	static void* Allocate(FrameArena& anArena, size_t aSize, size_t anAlignment) { return anArena.Allocate(aSize, anAlignment); }
+	static void Free(FrameArena&, void*, size_t, size_t) { }
+};
+
+template <>
+struct StlAllocatorTraits<VirtualMemoryPage>
+{
+	static void* Allocate(VirtualMemoryPage& aPage, size_t aSize, size_t anAlignment)
+	{
+		return aSize <= UINT32_MAX ? aPage.Allocate(static_cast<uint32_t>(aSize), static_cast<uint32_t>(anAlignment)) : nullptr;
+	}
+
+	static void Free(VirtualMemoryPage& aPage, void* aPointer, size_t, size_t) { aPage.Free(aPointer); }
+};
+
+// Single objects that fit a slot come from the pool, meant for node based containers such as std::list.
+// Anything else, like arrays or bookkeeping objects some standard libraries allocate, goes to the aligned heap
+template <typename T>
+struct StlAllocatorTraits<PoolAllocator<T>>
+{
+	static bool FitsSlot(size_t aSize, size_t anAlignment) { return aSize <= sizeof(T) && anAlignment <= alignof(T); }
+
+	static void* Allocate(PoolAllocator<T>& aPool, size_t aSize, size_t anAlignment)
+	{
+		return FitsSlot(aSize, anAlignment) ? static_cast<void*>(aPool.Allocate()) : AllocateAligned(aSize, anAlignment);
+	}
+
+	static void Free(PoolAllocator<T>& aPool, void* aPointer, size_t aSize, size_t anAlignment)
+	{
+		if (FitsSlot(aSize, anAlignment))
+			aPool.Free(static_cast<T*>(aPointer));
+		else
+			FreeAligned(aPointer);
+	}
+};
+
+// Standard allocator routing container allocations to an engine allocator, so containers can be moved
+// off the global heap without changing the code using them. It only holds a pointer to the engine
+// allocator, which must outlive the containers. Move assignment and swap carry the allocator along with
+// the memory; copies keep the allocator they were created with
+template <typename T, typename ALLOCATOR>
+class StlAllocator
+{
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	template <typename U>
+	struct rebind
+	{
+		using other = StlAllocator<U, ALLOCATOR>;
+	};
+
+	explicit StlAllocator(ALLOCATOR& anAllocator)
+		: myAllocator(&anAllocator)
+	{ }
+
+	template <typename U>
+	StlAllocator(const StlAllocator<U, ALLOCATOR>& anOther)
+		: myAllocator(anOther.GetAllocator())
+	{ }
+
+	// Throws std::bad_alloc if the engine allocator runs out of memory, as containers expect
+	T* allocate(size_t aCount);
+	void deallocate(T* aPointer, size_t aCount);
+
+	ALLOCATOR* GetAllocator() const { return myAllocator; }
+
+private:
+	ALLOCATOR* myAllocator = nullptr;
+};
+
+template <typename T, typename U, typename ALLOCATOR>
+bool operator==(const StlAllocator<T, ALLOCATOR>& aLeft, const StlAllocator<U, ALLOCATOR>& aRight)
+{
+	return aLeft.GetAllocator() == aRight.GetAllocator();
+}
+
+template <typename T, typename U, typename ALLOCATOR>
+bool operator!=(const StlAllocator<T, ALLOCATOR>& aLeft, const StlAllocator<U, ALLOCATOR>& aRight)
+{
+	return aLeft.GetAllocator() != aRight.GetAllocator();
+}
+
+template <typename T, typename ALLOCATOR>
+T* StlAllocator<T, ALLOCATOR>::allocate(size_t aCount)
+{
+	if (aCount > SIZE_MAX / sizeof(T))
+		throw std::bad_alloc{};
+
+	void* memory = StlAllocatorTraits<ALLOCATOR>::Allocate(*myAllocator, sizeof(T) * aCount, alignof(T));
+	if (memory == nullptr)
+		throw std::bad_alloc{};
+
+	return static_cast<T*>(memory);
+}
+
+template <typename T, typename ALLOCATOR>
+void StlAllocator<T, ALLOCATOR>::deallocate(T* aPointer, size_t aCount)
+{
+	StlAllocatorTraits<ALLOCATOR>::Free(*myAllocator, aPointer, sizeof(T) * aCount, alignof(T));
+}
+
+}
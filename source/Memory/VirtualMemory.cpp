@@ -0,0 +1,82 @@
+#include "VirtualMemory.h"
+
+#if IS_WINDOWS_PLATFORM
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#else
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#endif // IS_WINDOWS_PLATFORM
+
+namespace dbz
+{
+
+#if IS_WINDOWS_PLATFORM
+
+size_t GetVirtualMemoryPageSize()
+{
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	return systemInfo.dwPageSize;
+}
+
+void* ReserveVirtualMemory(size_t aSize)
+{
+	return VirtualAlloc(nullptr, aSize, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+void ReleaseVirtualMemory(void* anAddress, size_t)
+{
+	VirtualFree(anAddress, 0u, MEM_RELEASE);
+}
+
+bool CommitVirtualMemory(void* anAddress, size_t aSize)
+{
+	return VirtualAlloc(anAddress, aSize, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void DecommitVirtualMemory(void* anAddress, size_t aSize)
+{
+	VirtualFree(anAddress, aSize, MEM_DECOMMIT);
+}
+
+#else
+
+size_t GetVirtualMemoryPageSize()
+{
+	return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+void* ReserveVirtualMemory(size_t aSize)
+{
+	// No swap is reserved either, reserving far more than the physical memory is fine
+	void* address = mmap(nullptr, aSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return address != MAP_FAILED ? address : nullptr;
+}
+
+void ReleaseVirtualMemory(void* anAddress, size_t aSize)
+{
+	munmap(anAddress, aSize);
+}
+
+bool CommitVirtualMemory(void* anAddress, size_t aSize)
+{
+	return mprotect(anAddress, aSize, PROT_READ | PROT_WRITE) == 0;
+}
+
+void DecommitVirtualMemory(void* anAddress, size_t aSize)
+{
+	// Drops the pages from the resident set, touching them again would map zeroed pages
+	madvise(anAddress, aSize, MADV_DONTNEED);
+	mprotect(anAddress, aSize, PROT_NONE);
+}
+
+#endif // IS_WINDOWS_PLATFORM
+
+}
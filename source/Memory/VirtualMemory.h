@@ -0,0 +1,23 @@
+#pragma once
+
+#include "GlobalDefines.h"
+
+#include <cstddef>
+
+namespace dbz
+{
+
+// Granularity of Commit and Decommit, addresses and sizes passed to them must be multiples of it
+size_t GetVirtualMemoryPageSize();
+
+// Reserves address space without backing it with memory. Returns nullptr on failure
+void* ReserveVirtualMemory(size_t aSize);
+// Releases a whole range returned by ReserveVirtualMemory, committed or not
+void ReleaseVirtualMemory(void* anAddress, size_t aSize);
+
+// Makes a reserved range readable and writable. The OS backs each page with zeroed memory the first time it is touched
+bool CommitVirtualMemory(void* anAddress, size_t aSize);
+// Gives the memory of a committed range back to the OS, the range stays reserved and is not accessible until committed again
+void DecommitVirtualMemory(void* anAddress, size_t aSize);
+
+}
@@ -0,0 +1,160 @@
+#include "VirtualMemoryPage.h"
+
+#include "VirtualMemory.h"
+
+#include <algorithm>
+
+namespace dbz
+{
+
+constexpr uint32_t VirtualMemoryPage::ourDefaultCommitGranularity;
+
+VirtualMemoryPage VirtualMemoryPage::Create(uint32_t aSize, uint32_t aDecommitDelay, MemoryPage::SelectionMethod aSelectionMethod, uint32_t aCommitGranularity)
+{
+	uint32_t commitGranularity = std::max(aCommitGranularity, static_cast<uint32_t>(GetVirtualMemoryPageSize()));
+	size_t reservedSize = (static_cast<size_t>(aSize) + commitGranularity - 1u) & ~static_cast<size_t>(commitGranularity - 1u);
+
+	uint8_t* memory = static_cast<uint8_t*>(ReserveVirtualMemory(reservedSize));
+	if (memory == nullptr)
+		return VirtualMemoryPage{};
+
+	VirtualMemoryPage page{ memory, reservedSize, commitGranularity, aDecommitDelay };
+	page.myPage = MemoryPage::Create(aSize, aSelectionMethod);
+	return page;
+}
+
+void VirtualMemoryPage::Destroy(VirtualMemoryPage& aPage)
+{
+	if (aPage.myMemory == nullptr)
+		return;
+
+	MemoryPage::Destroy(aPage.myPage);
+	ReleaseVirtualMemory(aPage.myMemory, aPage.myReservedSize);
+	aPage.myMemory = nullptr;
+	aPage.myReservedSize = 0u;
+	aPage.myCommittedSize = 0u;
+	aPage.myGranules.clear();
+	aPage.myEmptyGranuleIndices.clear();
+}
+
+void* VirtualMemoryPage::Allocate(uint32_t aSize, uint32_t anAlignment)
+{
+	if (myMemory == nullptr)
+		return nullptr;
+
+	uint32_t offset = myPage.Allocate(aSize, anAlignment);
+	if (offset == UINT32_MAX)
+		return nullptr;
+
+	// Buddy pages hand out whole blocks, so the whole block is backed
+	uint32_t size = myPage.GetAllocationSize(offset);
+	uint32_t firstIndex = GetFirstGranuleIndex(offset);
+	uint32_t lastIndex = GetLastGranuleIndex(offset, size);
+	for (uint32_t index = firstIndex; index <= lastIndex; ++index)
+	{
+		Granule& granule = myGranules[index];
+		if (granule.myIsCommitted)
+			continue;
+
+		if (CommitVirtualMemory(myMemory + static_cast<size_t>(index) * myCommitGranularity, myCommitGranularity) == false)
+		{
+			// Granules committed so far are left empty, Update decommits them
+			for (uint32_t committedIndex = firstIndex; committedIndex < index; ++committedIndex)
+			{
+				if (myGranules[committedIndex].myAllocationCount == 0u)
+					ListEmptyGranule(committedIndex);
+			}
+
+			myPage.Free(offset);
+			return nullptr;
+		}
+
+		granule.myIsCommitted = true;
+		myCommittedSize += myCommitGranularity;
+	}
+
+	for (uint32_t index = firstIndex; index <= lastIndex; ++index)
+		++myGranules[index].myAllocationCount;
+
+	return myMemory + offset;
+}
+
+bool VirtualMemoryPage::Free(void* aPointer)
+{
+	uint8_t* pointer = static_cast<uint8_t*>(aPointer);
+	if (pointer < myMemory || pointer >= myMemory + myReservedSize)
+		return false;
+
+	uint32_t offset = static_cast<uint32_t>(pointer - myMemory);
+	uint32_t size = myPage.GetAllocationSize(offset);
+	if (myPage.Free(offset) == false)
+		return false;
+
+	uint32_t lastIndex = GetLastGranuleIndex(offset, size);
+	for (uint32_t index = GetFirstGranuleIndex(offset); index <= lastIndex; ++index)
+	{
+		if (--myGranules[index].myAllocationCount == 0u)
+			ListEmptyGranule(index);
+	}
+
+	return true;
+}
+
+void VirtualMemoryPage::Update()
+{
+	for (size_t i = 0u; i < myEmptyGranuleIndices.size();)
+	{
+		uint32_t index = myEmptyGranuleIndices[i];
+		Granule& granule = myGranules[index];
+
+		// Granules that got allocations again, or that have not been empty for long enough, keep their memory
+		bool isUsed = granule.myAllocationCount != 0u;
+		if (isUsed == false && ++granule.myEmptyUpdateCount < myDecommitDelay)
+		{
+			++i;
+			continue;
+		}
+
+		if (isUsed == false)
+		{
+			DecommitVirtualMemory(myMemory + static_cast<size_t>(index) * myCommitGranularity, myCommitGranularity);
+			granule.myIsCommitted = false;
+			myCommittedSize -= myCommitGranularity;
+		}
+
+		granule.myIsListedEmpty = false;
+		myEmptyGranuleIndices[i] = myEmptyGranuleIndices.back();
+		myEmptyGranuleIndices.pop_back();
+	}
+}
+
+VirtualMemoryPage::VirtualMemoryPage(uint8_t* someMemory, size_t aReservedSize, uint32_t aCommitGranularity, uint32_t aDecommitDelay)
+	: myMemory(someMemory)
+	, myReservedSize(aReservedSize)
+	, myCommitGranularity(aCommitGranularity)
+	, myDecommitDelay(aDecommitDelay)
+	, myGranules(aReservedSize / aCommitGranularity)
+{ }
+
+void VirtualMemoryPage::ListEmptyGranule(uint32_t anIndex)
+{
+	Granule& granule = myGranules[anIndex];
+	granule.myEmptyUpdateCount = 0u;
+	if (granule.myIsListedEmpty == false)
+	{
+		granule.myIsListedEmpty = true;
+		myEmptyGranuleIndices.push_back(anIndex);
+	}
+}
+
+#if IS_DEVELOPMENT_BUILD
+
+void VirtualMemoryPage::Print(std::ostream& anOutputStream) const
+{
+	anOutputStream << "Virtual memory page: [Reserved: " << myReservedSize << ", Committed: " << myCommittedSize << ", Granularity: " << myCommitGranularity << "]\n";
+	myPage.Print(anOutputStream);
+}
+
+#endif // IS_DEVELOPMENT_BUILD
+
+}
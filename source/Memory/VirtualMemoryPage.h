@@ -0,0 +1,79 @@
+#pragma once
+
+#include "GlobalDefines.h"
+#include "MemoryPage.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+#if IS_DEVELOPMENT_BUILD
+#include <iostream>
+#endif // IS_DEVELOPMENT_BUILD
+
+namespace dbz
+{
+
+// Memory page backed by a reserved virtual address range. Memory is committed in granules the first
+// time an allocation covers them, and granules left without allocations for a number of updates are
+// given back to the OS, so resident memory follows the live allocations instead of the page size
+class VirtualMemoryPage
+{
+public:
+	constexpr static uint32_t ourDefaultCommitGranularity = 64u * 1024u;
+
+	// aCommitGranularity must be a power of two, it is raised to the OS page size if smaller.
+	// aSize is rounded up to the granularity
+	static VirtualMemoryPage Create(uint32_t aSize, uint32_t aDecommitDelay, MemoryPage::SelectionMethod aSelectionMethod = MemoryPage::SelectionMethod::TLSF, uint32_t aCommitGranularity = ourDefaultCommitGranularity);
+	static void Destroy(VirtualMemoryPage& aPage);
+
+	// Dummy constructor, does nothing
+	VirtualMemoryPage() = default;
+
+	// Returns nullptr if there is no room for the allocation, aSize is 0 or memory could not be committed
+	void* Allocate(uint32_t aSize, uint32_t anAlignment = 1u);
+	bool Free(void* aPointer);
+
+	// Meant to be called once per frame, decommits the granules that stayed empty for the decommit delay
+	void Update();
+
+	// nullptr if the address range could not be reserved
+	uint8_t* GetMemory() const { return myMemory; }
+	const MemoryPage& GetPage() const { return myPage; }
+	size_t GetReservedSize() const { return myReservedSize; }
+	size_t GetCommittedSize() const { return myCommittedSize; }
+
+private:
+	struct Granule
+	{
+		// Allocations overlapping the granule, it can be decommitted once this gets to 0
+		uint32_t myAllocationCount = 0u;
+		uint32_t myEmptyUpdateCount = 0u;
+		bool myIsCommitted = false;
+		// Listed in myEmptyGranuleIndices
+		bool myIsListedEmpty = false;
+	};
+
+	VirtualMemoryPage(uint8_t* someMemory, size_t aReservedSize, uint32_t aCommitGranularity, uint32_t aDecommitDelay);
+
+	uint32_t GetFirstGranuleIndex(uint32_t anOffset) const { return anOffset / myCommitGranularity; }
+	uint32_t GetLastGranuleIndex(uint32_t anOffset, uint32_t aSize) const { return (anOffset + aSize - 1u) / myCommitGranularity; }
+	void ListEmptyGranule(uint32_t anIndex);
+
+	MemoryPage myPage;
+	uint8_t* myMemory = nullptr;
+	size_t myReservedSize = 0u;
+	size_t myCommittedSize = 0u;
+	uint32_t myCommitGranularity = 0u;
+	uint32_t myDecommitDelay = 0u;
+	std::vector<Granule> myGranules;
+	// Committed granules that were left without allocations, checked by Update
+	std::vector<uint32_t> myEmptyGranuleIndices;
+
+#if IS_DEVELOPMENT_BUILD
+public:
+	void Print(std::ostream& anOutputStream) const;
+#endif // IS_DEVELOPMENT_BUILD
+};
+
+}
@@ -0,0 +1,231 @@
+#include <catch/catch.hpp>
+
+#include "Memory/AllocationTrace.h"
+#include "Memory/MemoryPage.h"
+
+#include <cstdio>
+#include <fstream>
+
+#define DBZ_KB (1 << 10)
+#define DBZ_MB (1 << 20)
+
+namespace
+{
+	// Every free refers to a live allocation made before it
+	bool IsConsistent(const dbz::AllocationTrace& aTrace)
+	{
+		std::vector<bool> isLive(aTrace.GetAllocationCount(), false);
+		for (const dbz::AllocationTrace::Event& event : aTrace.GetEvents())
+		{
+			if (event.myType == dbz::AllocationTrace::Event::Type::ALLOCATE)
+			{
+				isLive[event.myAllocationIndex] = true;
+			}
+			else
+			{
+				if (event.myAllocationIndex >= isLive.size() || isLive[event.myAllocationIndex] == false)
+					return false;
+				isLive[event.myAllocationIndex] = false;
+			}
+		}
+
+		return true;
+	}
+
+	// Trace file with a single event, bytes are written as given
+	void WriteSingleEventTrace(const char* aPath, uint8_t aTypeByte, const std::vector<uint32_t>& someValues)
+	{
+		std::vector<uint32_t> values = { 1u, DBZ_MB, 1u };
+		values.insert(values.end(), someValues.begin(), someValues.end());
+
+		std::ofstream file(aPath, std::ios::binary);
+		file.write("DBZT", 4);
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			if (i == 3u)
+				file.put(static_cast<char>(aTypeByte));
+			for (uint32_t j = 0u; j < 4u; ++j)
+				file.put(static_cast<char>(values[i] >> (8u * j)));
+		}
+	}
+}
+
+TEST_CASE("AllocationTrace_TraceLifeTimeManagedThroughStaticFunctions", "[Memory], [AllocationTrace]")
+{
+	dbz::AllocationTrace trace = dbz::AllocationTrace::Create(DBZ_MB);
+	dbz::AllocationTrace::Destroy(trace);
+}
+
+TEST_CASE("AllocationTrace_RecordsMemoryPageCalls", "[Memory], [AllocationTrace]")
+{
+	dbz::AllocationTrace trace = dbz::AllocationTrace::Create(DBZ_MB);
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+	page.SetAllocationTrace(&trace);
+
+	uint32_t offset = page.Allocate(DBZ_KB);
+	uint32_t offset2 = page.Allocate(100u, 256u);
+	REQUIRE(page.Allocate(2 * DBZ_MB) == UINT32_MAX);
+	REQUIRE(page.Free(offset));
+	REQUIRE(page.Free(offset) == false);
+
+	// Calls made after the trace is unset are not recorded
+	page.SetAllocationTrace(nullptr);
+	REQUIRE(page.Free(offset2));
+
+	const std::vector<dbz::AllocationTrace::Event>& events = trace.GetEvents();
+	REQUIRE(events.size() == 5u);
+	REQUIRE(trace.GetAllocationCount() == 3u);
+
+	REQUIRE(events[0].myType == dbz::AllocationTrace::Event::Type::ALLOCATE);
+	REQUIRE(events[0].mySize == DBZ_KB);
+	REQUIRE(events[0].myOffset == offset);
+	REQUIRE(events[1].myAlignment == 256u);
+	REQUIRE(events[1].myAllocationIndex == 1u);
+	REQUIRE(events[2].mySucceeded == false);
+
+	REQUIRE(events[3].myType == dbz::AllocationTrace::Event::Type::FREE);
+	REQUIRE(events[3].myAllocationIndex == 0u);
+	REQUIRE(events[3].mySucceeded);
+	REQUIRE(events[4].myAllocationIndex == UINT32_MAX);
+	REQUIRE(events[4].mySucceeded == false);
+
+	dbz::MemoryPage::Destroy(page);
+	dbz::AllocationTrace::Destroy(trace);
+}
+
+TEST_CASE("AllocationTrace_CanBeSavedAndLoaded", "[Memory], [AllocationTrace]")
+{
+	dbz::AllocationTrace trace = dbz::AllocationTrace::Create(DBZ_MB);
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+	page.SetAllocationTrace(&trace);
+
+	uint32_t offset = page.Allocate(DBZ_KB, 64u);
+	page.Allocate(2 * DBZ_MB);
+	// Biggest alignment a call can ask for
+	page.Allocate(DBZ_KB, 1u << 31u);
+	page.Free(offset);
+	page.Free(offset);
+
+	const char* path = "AllocationTrace_CanBeSavedAndLoaded.dbztrace";
+	REQUIRE(trace.Save(path));
+
+	dbz::AllocationTrace loadedTrace;
+	REQUIRE(dbz::AllocationTrace::Load(path, loadedTrace));
+	std::remove(path);
+
+	REQUIRE(loadedTrace.GetPageSize() == DBZ_MB);
+	REQUIRE(loadedTrace.GetAllocationCount() == trace.GetAllocationCount());
+	REQUIRE(loadedTrace.GetEvents().size() == trace.GetEvents().size());
+	for (size_t i = 0; i < trace.GetEvents().size(); ++i)
+	{
+		const dbz::AllocationTrace::Event& event = trace.GetEvents()[i];
+		const dbz::AllocationTrace::Event& loadedEvent = loadedTrace.GetEvents()[i];
+		REQUIRE(loadedEvent.myType == event.myType);
+		REQUIRE(loadedEvent.mySize == event.mySize);
+		REQUIRE(loadedEvent.myAlignment == event.myAlignment);
+		REQUIRE(loadedEvent.myAllocationIndex == event.myAllocationIndex);
+		REQUIRE(loadedEvent.myOffset == event.myOffset);
+		REQUIRE(loadedEvent.mySucceeded == event.mySucceeded);
+	}
+	REQUIRE(loadedTrace.GetEvents()[2].myAlignment == 1u << 31u);
+
+	REQUIRE(dbz::AllocationTrace::Load("FileThatDoesNotExist.dbztrace", loadedTrace) == false);
+
+	dbz::MemoryPage::Destroy(page);
+	dbz::AllocationTrace::Destroy(trace);
+}
+
+TEST_CASE("AllocationTrace_LoadRejectsMalformedTraces", "[Memory], [AllocationTrace]")
+{
+	const char* path = "AllocationTrace_LoadRejectsMalformedTraces.dbztrace";
+	dbz::AllocationTrace loadedTrace;
+
+	WriteSingleEventTrace(path, 31u << 1u, { DBZ_KB, 0u });
+	REQUIRE(dbz::AllocationTrace::Load(path, loadedTrace));
+	REQUIRE(loadedTrace.GetEvents()[0].myAlignment == 1u << 31u);
+
+	// Alignment does not fit in 32 bits
+	WriteSingleEventTrace(path, 32u << 1u, { DBZ_KB, 0u });
+	REQUIRE(dbz::AllocationTrace::Load(path, loadedTrace) == false);
+	WriteSingleEventTrace(path, 127u << 1u, { DBZ_KB, 0u });
+	REQUIRE(dbz::AllocationTrace::Load(path, loadedTrace) == false);
+
+	// Free of an allocation that was never recorded
+	WriteSingleEventTrace(path, 1u, { 0u });
+	REQUIRE(dbz::AllocationTrace::Load(path, loadedTrace) == false);
+	WriteSingleEventTrace(path, 1u, { UINT32_MAX });
+	REQUIRE(dbz::AllocationTrace::Load(path, loadedTrace));
+
+	// Truncated event
+	WriteSingleEventTrace(path, 0u, { DBZ_KB });
+	REQUIRE(dbz::AllocationTrace::Load(path, loadedTrace) == false);
+
+	std::remove(path);
+}
+
+TEST_CASE("AllocationTrace_FollowsDefragmentedAllocations", "[Memory], [AllocationTrace]")
+{
+	dbz::AllocationTrace trace = dbz::AllocationTrace::Create(DBZ_MB);
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+	page.SetAllocationTrace(&trace);
+
+	uint32_t offset = page.Allocate(DBZ_KB);
+	uint32_t offset2 = page.Allocate(DBZ_KB);
+	REQUIRE(page.Free(offset));
+
+	uint32_t newOffset = UINT32_MAX;
+	REQUIRE(page.Defragment(UINT32_MAX, [&newOffset](uint32_t, uint32_t aNewOffset, uint32_t) { newOffset = aNewOffset; }));
+	REQUIRE(newOffset == offset);
+	REQUIRE(newOffset != offset2);
+	REQUIRE(page.Free(newOffset));
+
+	// Free of the moved block refers to the second allocation
+	const std::vector<dbz::AllocationTrace::Event>& events = trace.GetEvents();
+	REQUIRE(events.size() == 4u);
+	REQUIRE(events[3].myAllocationIndex == 1u);
+	REQUIRE(events[3].mySucceeded);
+	REQUIRE(IsConsistent(trace));
+
+	dbz::MemoryPage::Destroy(page);
+	dbz::AllocationTrace::Destroy(trace);
+}
+
+TEST_CASE("AllocationTrace_GeneratedTracesAreConsistent", "[Memory], [AllocationTrace]")
+{
+	const dbz::AllocationTrace traces[] =
+	{
+		dbz::AllocationTrace::GenerateChurn(16 * DBZ_MB, 8 * DBZ_MB, 20000u, 1u),
+		dbz::AllocationTrace::GenerateStackLike(16 * DBZ_MB, 8 * DBZ_MB, 20000u, 1u),
+		dbz::AllocationTrace::GenerateBimodal(16 * DBZ_MB, 8 * DBZ_MB, 20000u, 1u)
+	};
+
+	for (const dbz::AllocationTrace& trace : traces)
+	{
+		REQUIRE(trace.GetEvents().size() == 20000u);
+		REQUIRE(IsConsistent(trace));
+
+		// Live bytes stay under the budget, so a best fit page never runs out of memory
+		dbz::MemoryPage page = dbz::MemoryPage::Create(trace.GetPageSize(), dbz::MemoryPage::SelectionMethod::BEST_FIT);
+		std::vector<uint32_t> offsets(trace.GetAllocationCount(), UINT32_MAX);
+		for (const dbz::AllocationTrace::Event& event : trace.GetEvents())
+		{
+			if (event.myType == dbz::AllocationTrace::Event::Type::ALLOCATE)
+			{
+				offsets[event.myAllocationIndex] = page.Allocate(event.mySize, event.myAlignment);
+				REQUIRE(offsets[event.myAllocationIndex] != UINT32_MAX);
+			}
+			else
+			{
+				REQUIRE(page.Free(offsets[event.myAllocationIndex]));
+			}
+		}
+
+		dbz::MemoryPage::Destroy(page);
+	}
+
+	// Same seed gives the same trace
+	dbz::AllocationTrace trace = dbz::AllocationTrace::GenerateChurn(16 * DBZ_MB, 8 * DBZ_MB, 1000u, 7u);
+	dbz::AllocationTrace trace2 = dbz::AllocationTrace::GenerateChurn(16 * DBZ_MB, 8 * DBZ_MB, 1000u, 7u);
+	for (size_t i = 0; i < trace.GetEvents().size(); ++i)
+		REQUIRE(trace.GetEvents()[i].mySize == trace2.GetEvents()[i].mySize);
+}
@@ -0,0 +1,295 @@
+#include <catch/catch.hpp>
+
+#include "Memory/AllocationTracker.h"
+#include "Memory/FrameArena.h"
+#include "Memory/MemoryPage.h"
+#include "Memory/PoolAllocator.h"
+
+#include <cstring>
+#include <vector>
+
+#define DBZ_KB (1 << 10)
+#define DBZ_MB (1 << 20)
+
+#if IS_ALLOCATION_TRACKING_BUILD
+
+namespace
+{
+	DBZ_TRACKED_NOINLINE void AllocateSmallBlock(dbz::MemoryPage& aPage, std::vector<uint32_t>& someOffsetsOut)
+	{
+		someOffsetsOut.push_back(aPage.Allocate(DBZ_KB));
+	}
+
+	DBZ_TRACKED_NOINLINE void AllocateBigBlock(dbz::MemoryPage& aPage, std::vector<uint32_t>& someOffsetsOut)
+	{
+		someOffsetsOut.push_back(aPage.Allocate(8 * DBZ_KB));
+	}
+}
+
+TEST_CASE("AllocationTracker_TrackerLifeTimeManagedThroughStaticFunctions", "[Memory], [AllocationTracker]")
+{
+	dbz::AllocationTracker tracker = dbz::AllocationTracker::Create();
+	REQUIRE(tracker.IsEnabled() == false);
+	dbz::AllocationTracker::Destroy(tracker);
+}
+
+TEST_CASE("AllocationTracker_NothingIsRecordedWhileDisabled", "[Memory], [AllocationTracker]")
+{
+	dbz::AllocationTracker tracker = dbz::AllocationTracker::Create();
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+	page.SetAllocationTracker(&tracker, "Renderer");
+
+	uint32_t offset = page.Allocate(DBZ_KB);
+	REQUIRE(tracker.GetLiveAllocations().empty());
+	REQUIRE(tracker.GetTagStats().empty());
+
+	// Frees are still processed after disabling, so nothing shows up as leaked
+	tracker.SetEnabled(true);
+	uint32_t offset2 = page.Allocate(DBZ_KB);
+	tracker.SetEnabled(false);
+	REQUIRE(page.Free(offset2));
+	REQUIRE(tracker.GetLiveAllocations().empty());
+
+	REQUIRE(page.Free(offset));
+	dbz::MemoryPage::Destroy(page);
+	REQUIRE(tracker.GetLeakedAllocations().empty());
+	dbz::AllocationTracker::Destroy(tracker);
+}
+
+TEST_CASE("AllocationTracker_StatsArePerTag", "[Memory], [AllocationTracker]")
+{
+	dbz::AllocationTracker tracker = dbz::AllocationTracker::Create();
+	tracker.SetEnabled(true);
+
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+	page.SetAllocationTracker(&tracker, "Renderer");
+	dbz::MemoryPage page2 = dbz::MemoryPage::Create(DBZ_MB);
+	page2.SetAllocationTracker(&tracker, "Audio");
+
+	uint32_t offset = page.Allocate(4 * DBZ_KB);
+	uint32_t offset2 = page.Allocate(4 * DBZ_KB);
+	uint32_t offset3 = page2.Allocate(DBZ_KB);
+
+	// Scope tag wins over the allocator tag, same names are merged even if the strings differ
+	char audioTag[] = "Audio";
+	uint32_t offset4 = 0u;
+	{
+		dbz::AllocationTracker::TagScope scope(tracker, audioTag);
+		offset4 = page.Allocate(2 * DBZ_KB);
+	}
+
+	REQUIRE(page.Free(offset2));
+
+	std::vector<dbz::AllocationTracker::TagStats> tagStats = tracker.GetTagStats();
+	REQUIRE(tagStats.size() == 2u);
+	REQUIRE(std::strcmp(tagStats[0].myTag, "Renderer") == 0);
+	REQUIRE(tagStats[0].myLiveBytes == 4u * DBZ_KB);
+	REQUIRE(tagStats[0].myLiveCount == 1u);
+	REQUIRE(tagStats[0].myAllocatedBytes == 8u * DBZ_KB);
+	REQUIRE(tagStats[0].myAllocationCount == 2u);
+	REQUIRE(std::strcmp(tagStats[1].myTag, "Audio") == 0);
+	REQUIRE(tagStats[1].myLiveBytes == 3u * DBZ_KB);
+	REQUIRE(tagStats[1].myLiveCount == 2u);
+
+	REQUIRE(page.Free(offset));
+	REQUIRE(page.Free(offset4));
+	REQUIRE(page2.Free(offset3));
+	REQUIRE(tracker.GetLiveAllocations().empty());
+
+	dbz::MemoryPage::Destroy(page);
+	dbz::MemoryPage::Destroy(page2);
+	dbz::AllocationTracker::Destroy(tracker);
+}
+
+TEST_CASE("AllocationTracker_TopCallsitesHaveMostLiveBytes", "[Memory], [AllocationTracker]")
+{
+	dbz::AllocationTracker tracker = dbz::AllocationTracker::Create();
+	tracker.SetEnabled(true);
+
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+	page.SetAllocationTracker(&tracker, "Renderer");
+
+	// Each helper holds a single call to Allocate, so the callsites do not depend on how the optimizer lays out the test
+	std::vector<uint32_t> offsets;
+	AllocateSmallBlock(page, offsets);
+	AllocateSmallBlock(page, offsets);
+	AllocateSmallBlock(page, offsets);
+	AllocateSmallBlock(page, offsets);
+	AllocateBigBlock(page, offsets);
+	AllocateBigBlock(page, offsets);
+
+	std::vector<dbz::AllocationTracker::CallsiteStats> callsites = tracker.GetTopCallsites(10u);
+	REQUIRE(callsites.size() == 2u);
+	REQUIRE(callsites[0].myCallsite != nullptr);
+	REQUIRE(callsites[0].myLiveBytes == 16u * DBZ_KB);
+	REQUIRE(callsites[0].myLiveCount == 2u);
+	REQUIRE(callsites[1].myLiveBytes == 4u * DBZ_KB);
+	REQUIRE(callsites[1].myAllocationCount == 4u);
+	REQUIRE(tracker.GetTopCallsites(1u).size() == 1u);
+
+	for (uint32_t offset : offsets)
+		REQUIRE(page.Free(offset));
+
+	dbz::MemoryPage::Destroy(page);
+	dbz::AllocationTracker::Destroy(tracker);
+}
+
+TEST_CASE("AllocationTracker_PoolCallsitesAreInTheCallingCode", "[Memory], [AllocationTracker]")
+{
+	dbz::AllocationTracker tracker = dbz::AllocationTracker::Create();
+	tracker.SetEnabled(true);
+
+	dbz::PoolAllocator<uint64_t> pool = dbz::PoolAllocator<uint64_t>::Create(64u);
+	pool.SetAllocationTracker(&tracker, "Gameplay");
+
+	// Pool functions are templates defined in the header, each call still reports its own callsite
+	uint64_t* object = pool.Construct(7u);
+	uint64_t* object2 = pool.Construct(8u);
+	uint64_t* objects[2];
+	REQUIRE(pool.ConstructBatch(objects, 2u, 9u) == 2u);
+
+	std::vector<dbz::AllocationTracker::CallsiteStats> callsites = tracker.GetTopCallsites(10u);
+	REQUIRE(callsites.size() == 3u);
+	REQUIRE(callsites[0].myLiveCount == 2u);
+	REQUIRE(callsites[1].myLiveCount == 1u);
+	REQUIRE(callsites[2].myLiveCount == 1u);
+
+	pool.Destruct(object);
+	pool.Destruct(object2);
+	pool.DestructBatch(objects, 2u);
+	dbz::PoolAllocator<uint64_t>::Destroy(pool);
+	dbz::AllocationTracker::Destroy(tracker);
+}
+
+TEST_CASE("AllocationTracker_LiveAllocationsAreLeakedWhenAllocatorIsDestroyed", "[Memory], [AllocationTracker]")
+{
+	dbz::AllocationTracker tracker = dbz::AllocationTracker::Create();
+	tracker.SetEnabled(true);
+
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+	page.SetAllocationTracker(&tracker, "Renderer");
+	dbz::PoolAllocator<uint64_t> pool = dbz::PoolAllocator<uint64_t>::Create(64u);
+	pool.SetAllocationTracker(&tracker, "Gameplay");
+	dbz::FrameArena arena = dbz::FrameArena::Create(DBZ_KB);
+	arena.SetAllocationTracker(&tracker, "Scratch");
+
+	uint32_t offset = page.Allocate(DBZ_KB);
+	page.Free(page.Allocate(DBZ_KB));
+	uint64_t* object = pool.Construct(7u);
+	pool.Destruct(pool.Construct(8u));
+	arena.Allocate(100u);
+
+	dbz::MemoryPage::Destroy(page);
+	dbz::PoolAllocator<uint64_t>::Destroy(pool);
+	// Arena memory is released in bulk, not leaked
+	dbz::FrameArena::Destroy(arena);
+
+	const std::vector<dbz::AllocationTracker::Allocation>& leakedAllocations = tracker.GetLeakedAllocations();
+	REQUIRE(leakedAllocations.size() == 2u);
+	for (const dbz::AllocationTracker::Allocation& allocation : leakedAllocations)
+	{
+		if (allocation.myAllocator == &page)
+		{
+			REQUIRE(allocation.myAllocation == offset);
+			REQUIRE(allocation.mySize == DBZ_KB);
+			REQUIRE(std::strcmp(allocation.myTag, "Renderer") == 0);
+		}
+		else
+		{
+			REQUIRE(allocation.myAllocator == &pool);
+			REQUIRE(allocation.myAllocation == reinterpret_cast<uintptr_t>(object));
+			REQUIRE(allocation.mySize == sizeof(uint64_t));
+		}
+	}
+
+	REQUIRE(tracker.GetLiveAllocations().empty());
+	dbz::AllocationTracker::Destroy(tracker);
+}
+
+TEST_CASE("AllocationTracker_FrameArenaRewindFreesAllocations", "[Memory], [AllocationTracker]")
+{
+	dbz::AllocationTracker tracker = dbz::AllocationTracker::Create();
+	tracker.SetEnabled(true);
+
+	dbz::FrameArena arena = dbz::FrameArena::Create(DBZ_KB);
+	arena.SetAllocationTracker(&tracker, "Scratch");
+
+	arena.Allocate(100u);
+	{
+		dbz::FrameArena::Scope scope(arena);
+		arena.Allocate(100u);
+		arena.Allocate(100u);
+		REQUIRE(tracker.GetLiveAllocations().size() == 3u);
+	}
+
+	REQUIRE(tracker.GetLiveAllocations().size() == 1u);
+	arena.Reset();
+	REQUIRE(tracker.GetLiveAllocations().empty());
+
+	dbz::FrameArena::Destroy(arena);
+	dbz::AllocationTracker::Destroy(tracker);
+}
+
+TEST_CASE("AllocationTracker_FreeRangeOnlyRemovesAllocationsOfTheAllocatorInRange", "[Memory], [AllocationTracker]")
+{
+	dbz::AllocationTracker tracker = dbz::AllocationTracker::Create();
+	tracker.SetEnabled(true);
+
+	int allocator = 0;
+	int allocator2 = 0;
+	for (uint64_t allocation = 0u; allocation < 10u; ++allocation)
+	{
+		tracker.RecordAllocate(&allocator, allocation * 16u, 16u, "Scratch", nullptr);
+		tracker.RecordAllocate(&allocator2, allocation * 16u, 16u, "Scratch", nullptr);
+	}
+
+	// Range end is exclusive
+	tracker.RecordFreeRange(&allocator, 32u, 96u);
+	REQUIRE(tracker.GetLiveAllocations().size() == 16u);
+	REQUIRE(tracker.GetTagStats()[0].myLiveBytes == 16u * 16u);
+
+	tracker.RecordFreeRange(&allocator, 0u, UINT64_MAX);
+	for (const dbz::AllocationTracker::Allocation& allocation : tracker.GetLiveAllocations())
+		REQUIRE(allocation.myAllocator == &allocator2);
+	REQUIRE(tracker.GetLiveAllocations().size() == 10u);
+
+	// Allocators without live allocations are ignored
+	tracker.RecordFreeRange(&allocator, 0u, UINT64_MAX);
+	tracker.RecordAllocatorDestroyed(&allocator);
+	REQUIRE(tracker.GetLeakedAllocations().empty());
+
+	tracker.RecordAllocatorDestroyed(&allocator2);
+	REQUIRE(tracker.GetLeakedAllocations().size() == 10u);
+	REQUIRE(tracker.GetLiveAllocations().empty());
+	REQUIRE(tracker.GetTagStats()[0].myLiveBytes == 0u);
+
+	dbz::AllocationTracker::Destroy(tracker);
+}
+
+TEST_CASE("AllocationTracker_DefragmentUpdatesTrackedOffsets", "[Memory], [AllocationTracker]")
+{
+	dbz::AllocationTracker tracker = dbz::AllocationTracker::Create();
+	tracker.SetEnabled(true);
+
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+	page.SetAllocationTracker(&tracker, "Renderer");
+
+	uint32_t offset = page.Allocate(DBZ_KB);
+	uint32_t offset2 = page.Allocate(DBZ_KB);
+	REQUIRE(page.Free(offset));
+
+	while (page.Defragment(DBZ_MB, [&offset2](uint32_t anOldOffset, uint32_t aNewOffset, uint32_t) { if (anOldOffset == offset2) offset2 = aNewOffset; }) == false)
+	{ }
+
+	std::vector<dbz::AllocationTracker::Allocation> liveAllocations = tracker.GetLiveAllocations();
+	REQUIRE(liveAllocations.size() == 1u);
+	REQUIRE(liveAllocations[0].myAllocation == offset2);
+
+	REQUIRE(page.Free(offset2));
+	REQUIRE(tracker.GetLiveAllocations().empty());
+
+	dbz::MemoryPage::Destroy(page);
+	dbz::AllocationTracker::Destroy(tracker);
+}
+
+#endif // IS_ALLOCATION_TRACKING_BUILD
@@ -0,0 +1,181 @@
+#include <catch/catch.hpp>
+
+#include "Memory/BuddyPage.h"
+
+#include <algorithm>
+#include <utility>
+
+#define DBZ_KB (1 << 10)
+#define DBZ_MB (1 << 20)
+
+TEST_CASE("BuddyPage_PageLifeTimeManagedThroughStaticFunctions", "[Memory], [BuddyPage]")
+{
+	dbz::BuddyPage page = dbz::BuddyPage::Create(DBZ_MB);
+	dbz::BuddyPage::Destroy(page);
+}
+
+TEST_CASE("BuddyPage_SizesAreRoundedUpToPowersOfTwo", "[Memory], [BuddyPage]")
+{
+	dbz::BuddyPage page = dbz::BuddyPage::Create(DBZ_MB);
+
+	REQUIRE(page.Allocate(DBZ_KB) == 0u);
+	REQUIRE(page.Allocate(DBZ_KB) == DBZ_KB);
+	REQUIRE(page.Allocate(300u) == 2 * DBZ_KB);
+	REQUIRE(page.Allocate(1u) == 2 * DBZ_KB + 512u);
+	REQUIRE(page.Allocate(0u) == UINT32_MAX);
+	REQUIRE(page.Allocate(2 * DBZ_MB) == UINT32_MAX);
+
+	REQUIRE(page.GetAllocationSize(2 * DBZ_KB) == 512u);
+	REQUIRE(page.GetAllocationSize(2 * DBZ_KB + 512u) == 256u);
+	REQUIRE(page.GetAllocationSize(3 * DBZ_KB) == 0u);
+
+	dbz::BuddyPage::Destroy(page);
+}
+
+TEST_CASE("BuddyPage_BuddiesWhenFreedAreMerged", "[Memory], [BuddyPage]")
+{
+	dbz::BuddyPage page = dbz::BuddyPage::Create(4 * DBZ_KB);
+
+	uint32_t offsets[4];
+	for (uint32_t& offset : offsets)
+		offset = page.Allocate(DBZ_KB);
+	REQUIRE(page.Allocate(DBZ_KB) == UINT32_MAX);
+
+	REQUIRE(page.Free(offsets[1]));
+	REQUIRE(page.Free(offsets[2]));
+	// Freed blocks are not buddies, so there is no 2KB block yet
+	REQUIRE(page.Allocate(2 * DBZ_KB) == UINT32_MAX);
+
+	REQUIRE(page.Free(offsets[0]));
+	REQUIRE(page.Allocate(2 * DBZ_KB) == 0u);
+	REQUIRE(page.Free(0u));
+
+	REQUIRE(page.Free(offsets[3]));
+	REQUIRE(page.Allocate(4 * DBZ_KB) == 0u);
+
+	dbz::BuddyPage::Destroy(page);
+}
+
+TEST_CASE("BuddyPage_CanAllocateAlignedMemory", "[Memory], [BuddyPage]")
+{
+	dbz::BuddyPage page = dbz::BuddyPage::Create(DBZ_MB);
+
+	REQUIRE(page.Allocate(256u) == 0u);
+	uint32_t alignedOffset = page.Allocate(256u, 64 * DBZ_KB);
+	REQUIRE(alignedOffset == 64 * DBZ_KB);
+	REQUIRE(page.Allocate(256u, 3u) == UINT32_MAX);
+
+	dbz::BuddyPage::Destroy(page);
+}
+
+TEST_CASE("BuddyPage_MemoryPastTheLastPowerOfTwoIsUsed", "[Memory], [BuddyPage]")
+{
+	dbz::BuddyPage page = dbz::BuddyPage::Create(3 * DBZ_KB + 100u);
+
+	for (int i = 0; i < 2; ++i)
+	{
+		REQUIRE(page.Allocate(2 * DBZ_KB) == 0u);
+		REQUIRE(page.Allocate(DBZ_KB) == 2 * DBZ_KB);
+		// Trailing bytes are smaller than the minimum block size
+		REQUIRE(page.Allocate(1u) == UINT32_MAX);
+
+		REQUIRE(page.Free(2 * DBZ_KB));
+		REQUIRE(page.Free(0u));
+		REQUIRE(page.Allocate(4 * DBZ_KB) == UINT32_MAX);
+	}
+
+	dbz::BuddyPage::Destroy(page);
+}
+
+TEST_CASE("BuddyPage_FreeFailsForOffsetsNotAllocated", "[Memory], [BuddyPage]")
+{
+	dbz::BuddyPage page = dbz::BuddyPage::Create(DBZ_MB);
+
+	REQUIRE(page.Free(0u) == false);
+
+	REQUIRE(page.Allocate(DBZ_KB) == 0u);
+	REQUIRE(page.Free(256u) == false);
+	REQUIRE(page.Free(1u) == false);
+	REQUIRE(page.Free(DBZ_MB) == false);
+	REQUIRE(page.Free(0u));
+	REQUIRE(page.Free(0u) == false);
+
+	dbz::BuddyPage::Destroy(page);
+}
+
+TEST_CASE("BuddyPage_AllocationDeallocation_StressTest", "[Memory], [BuddyPage], [StressTest]")
+{
+	constexpr uint32_t minBlockSize = 64u;
+	dbz::BuddyPage page = dbz::BuddyPage::Create(DBZ_MB, minBlockSize);
+
+	std::vector<std::pair<uint32_t, uint32_t>> allocations;
+	for (int i = 0; i < 100000; ++i)
+	{
+		if (allocations.empty() || rand() % 2)
+		{
+			uint32_t size = 1u + static_cast<uint32_t>(rand()) % (4 * DBZ_KB);
+			uint32_t offset = page.Allocate(size);
+			if (offset != UINT32_MAX)
+			{
+				REQUIRE(offset % minBlockSize == 0u);
+				allocations.emplace_back(offset, size);
+			}
+		}
+		else
+		{
+			uint32_t index = static_cast<uint32_t>(rand()) % allocations.size();
+			REQUIRE(page.Free(allocations[index].first));
+			allocations[index] = allocations.back();
+			allocations.pop_back();
+		}
+	}
+
+	// Live allocations must not overlap
+	std::sort(allocations.begin(), allocations.end());
+	for (size_t i = 1; i < allocations.size(); ++i)
+		REQUIRE(allocations[i - 1].first + allocations[i - 1].second <= allocations[i].first);
+
+	for (const std::pair<uint32_t, uint32_t>& allocation : allocations)
+		REQUIRE(page.Free(allocation.first));
+
+	// Everything merged back into a single block
+	REQUIRE(page.Allocate(DBZ_MB) == 0u);
+
+	dbz::BuddyPage::Destroy(page);
+}
+
+TEST_CASE("BuddyPage_StatsTrackOccupancyAndFragmentation", "[Memory], [BuddyPage]")
+{
+	dbz::BuddyPage page = dbz::BuddyPage::Create(4 * DBZ_KB);
+
+	dbz::MemoryPageStats stats = page.GetStats();
+	REQUIRE(stats.myFreeBytes == 4 * DBZ_KB);
+	REQUIRE(stats.myLargestFreeBlockSize == 4 * DBZ_KB);
+	REQUIRE(stats.myFreeBlockCount == 1u);
+
+	uint32_t offset = page.Allocate(300u);
+	REQUIRE(page.Free(offset + 1u) == false);
+	REQUIRE(page.Allocate(8 * DBZ_KB) == UINT32_MAX);
+
+	// Split leaves a free buddy at each order below the page size
+	stats = page.GetStats();
+	REQUIRE(stats.myInUseBytes == 512u);
+	REQUIRE(stats.myFreeBytes == 4 * DBZ_KB - 512u);
+	REQUIRE(stats.myLargestFreeBlockSize == 2 * DBZ_KB);
+	REQUIRE(stats.myFreeBlockCount == 3u);
+	REQUIRE(stats.myFreeBlockSizeHistogram[9] == 1u);
+	REQUIRE(stats.myFreeBlockSizeHistogram[10] == 1u);
+	REQUIRE(stats.myFreeBlockSizeHistogram[11] == 1u);
+	REQUIRE(stats.myAllocationCount == 1u);
+	REQUIRE(stats.myFailedAllocationCount == 1u);
+	REQUIRE(stats.myFailedFreeCount == 1u);
+
+	REQUIRE(page.Free(offset));
+
+	stats = page.GetStats();
+	REQUIRE(stats.myInUseBytes == 0u);
+	REQUIRE(stats.myFreeBlockCount == 1u);
+	REQUIRE(stats.myFreeCount == 1u);
+
+	dbz::BuddyPage::Destroy(page);
+}
@@ -0,0 +1,117 @@
+#include <catch/catch.hpp>
+
+#include "Engine/Renderer/Camera.h"
+
+namespace
+{
+	float RandomFloat()
+	{
+		return static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0f - 1.0f;
+	}
+
+	void RequireApproxEqual(const Matrix44& aLeft, const Matrix44& aRight)
+	{
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			for (unsigned int j = 0; j < 4; ++j)
+				REQUIRE(aLeft[i][j] == Approx(aRight[i][j]).margin(1e-4f));
+		}
+	}
+}
+
+TEST_CASE("Camera_ViewMatrixIsTheInverseOfThePose_StressTest", "[Engine], [Camera], [StressTest]")
+{
+	Camera camera;
+	for (int i = 0; i < 1000; ++i)
+	{
+		Quaternion orientation{ Vector3{ RandomFloat(), RandomFloat(), RandomFloat() + 2.0f }, Math::Radian(RandomFloat() * Math::PI) };
+		Vector3 position{ RandomFloat() * 100.0f, RandomFloat() * 100.0f, RandomFloat() * 100.0f };
+		camera.SetOrientation(orientation);
+		camera.SetPosition(position);
+
+		// Default constructed matrices are the identity
+		Matrix44 pose = Matrix44::Translate(position.x, position.y, position.z) * orientation.GetMatrix();
+		RequireApproxEqual(camera.ViewMatrix() * pose, Matrix44{});
+	}
+}
+
+TEST_CASE("Camera_ViewProjectionMatchesItsParts", "[Engine], [Camera]")
+{
+	Camera camera;
+	camera.SetOrientation(Quaternion{ Vector3{ 0.3f, -0.5f, 2.0f }, Math::Radian{ 1.3f } });
+	camera.SetPosition(Vector3{ 3.0f, -2.0f, 7.0f });
+	camera.SetAspectRatio(1.5f);
+	camera.SetFieldOfViewY(Math::Degree{ 75.0f });
+	camera.SetNearPlane(0.5f);
+	camera.SetFarPlane(500.0f);
+
+	RequireApproxEqual(camera.ProjectionMatrix(), Matrix44::Perspective(Math::DegreeToRadian(75.0f), 1.5f, 0.5f, 500.0f));
+	RequireApproxEqual(camera.ViewProjectionMatrix(), camera.ProjectionMatrix() * camera.ViewMatrix());
+
+	// A point in front of the camera is seen, the same point behind it is not
+	Matrix44 pose = Matrix44::Translate(3.0f, -2.0f, 7.0f) * camera.GetOrientation().GetMatrix();
+	Vector4 front = pose * Vector4{ 0.0f, 0.0f, -10.0f, 1.0f };
+	Vector4 back = pose * Vector4{ 0.0f, 0.0f, 10.0f, 1.0f };
+	REQUIRE(camera.ViewFrustum().IsSphereVisible(Vector3{ front.x, front.y, front.z }, 1.0f));
+	REQUIRE(camera.ViewFrustum().IsSphereVisible(Vector3{ back.x, back.y, back.z }, 1.0f) == false);
+}
+
+#if IS_DEVELOPMENT_BUILD
+
+TEST_CASE("Camera_MatricesAreOnlyRebuiltAfterChanges", "[Engine], [Camera]")
+{
+	Camera camera;
+	camera.ViewFrustum();
+	REQUIRE(camera.GetRebuildCount() == 3u);
+
+	// Cached matrices are returned until something changes
+	camera.ViewProjectionMatrix();
+	camera.ViewMatrix();
+	camera.ProjectionMatrix();
+	REQUIRE(camera.GetRebuildCount() == 3u);
+
+	// View setters rebuild the view and the view projection, projection setters the projection and the view projection
+	uint32_t rebuildCount = camera.GetRebuildCount();
+	camera.SetPosition(Vector3{ 1.0f, 2.0f, 3.0f });
+	camera.ViewFrustum();
+	REQUIRE(camera.GetRebuildCount() == (rebuildCount += 2u));
+
+	camera.SetOrientation(Quaternion{ Vector3{ 0.0f, 1.0f, 0.0f }, Math::Radian{ 0.5f } });
+	camera.ViewFrustum();
+	REQUIRE(camera.GetRebuildCount() == (rebuildCount += 2u));
+
+	camera.SetAspectRatio(2.0f);
+	camera.ViewFrustum();
+	REQUIRE(camera.GetRebuildCount() == (rebuildCount += 2u));
+
+	camera.SetFieldOfViewY(Math::Radian{ 1.0f });
+	camera.ViewFrustum();
+	REQUIRE(camera.GetRebuildCount() == (rebuildCount += 2u));
+
+	camera.SetNearPlane(1.0f);
+	camera.ViewFrustum();
+	REQUIRE(camera.GetRebuildCount() == (rebuildCount += 2u));
+
+	camera.SetFarPlane(50.0f);
+	camera.ViewFrustum();
+	REQUIRE(camera.GetRebuildCount() == (rebuildCount += 2u));
+
+	// Only what is asked for is rebuilt
+	camera.SetPosition(Vector3{ 0.0f, 0.0f, 0.0f });
+	camera.ViewMatrix();
+	REQUIRE(camera.GetRebuildCount() == (rebuildCount += 1u));
+
+	// Setting the current values changes nothing
+	camera.ViewFrustum();
+	rebuildCount = camera.GetRebuildCount();
+	camera.SetPosition(Vector3{ 0.0f, 0.0f, 0.0f });
+	camera.SetOrientation(Quaternion{ Vector3{ 0.0f, 1.0f, 0.0f }, Math::Radian{ 0.5f } });
+	camera.SetAspectRatio(2.0f);
+	camera.SetFieldOfViewY(Math::Radian{ 1.0f });
+	camera.SetNearPlane(1.0f);
+	camera.SetFarPlane(50.0f);
+	camera.ViewFrustum();
+	REQUIRE(camera.GetRebuildCount() == rebuildCount);
+}
+
+#endif // IS_DEVELOPMENT_BUILD
@@ -0,0 +1,289 @@
+#include <catch/catch.hpp>
+
+#include "Memory/ConcurrentMemoryPage.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define DBZ_KB (1 << 10)
+#define DBZ_MB (1 << 20)
+
+namespace
+{
+	bool AreDisjoint(std::vector<std::pair<uint32_t, uint32_t>> someRanges)
+	{
+		std::sort(someRanges.begin(), someRanges.end());
+		for (size_t i = 1; i < someRanges.size(); ++i)
+		{
+			if (someRanges[i - 1].first + someRanges[i - 1].second > someRanges[i].first)
+				return false;
+		}
+
+		return true;
+	}
+}
+
+TEST_CASE("ConcurrentMemoryPage_PageLifeTimeManagedThroughStaticFunctions", "[Memory], [ConcurrentMemoryPage]")
+{
+	dbz::ConcurrentMemoryPage page = dbz::ConcurrentMemoryPage::Create(DBZ_MB);
+	dbz::ConcurrentMemoryPage::ThreadCache* cache = page.AcquireThreadCache();
+	REQUIRE(cache != nullptr);
+	page.ReleaseThreadCache(*cache);
+	dbz::ConcurrentMemoryPage::Destroy(page);
+}
+
+TEST_CASE("ConcurrentMemoryPage_SizeClassesFitTheirSizes", "[Memory], [ConcurrentMemoryPage]")
+{
+	REQUIRE(dbz::ConcurrentMemoryPage::GetSizeClassSize(0u) == 16u);
+	REQUIRE(dbz::ConcurrentMemoryPage::GetSizeClassSize(dbz::ConcurrentMemoryPage::ourSizeClassCount - 1u) == dbz::ConcurrentMemoryPage::ourMaxCachedSize);
+
+	for (uint32_t size = 1u; size <= dbz::ConcurrentMemoryPage::ourMaxCachedSize; ++size)
+	{
+		uint32_t sizeClass = dbz::ConcurrentMemoryPage::GetSizeClass(size);
+		REQUIRE(sizeClass < dbz::ConcurrentMemoryPage::ourSizeClassCount);
+		REQUIRE(dbz::ConcurrentMemoryPage::GetSizeClassSize(sizeClass) >= size);
+		if (sizeClass != 0u)
+			REQUIRE(dbz::ConcurrentMemoryPage::GetSizeClassSize(sizeClass - 1u) < size);
+	}
+}
+
+TEST_CASE("ConcurrentMemoryPage_SmallAllocationsComeFromSpans", "[Memory], [ConcurrentMemoryPage]")
+{
+	dbz::ConcurrentMemoryPage page = dbz::ConcurrentMemoryPage::Create(DBZ_MB);
+	dbz::ConcurrentMemoryPage::ThreadCache* cache = page.AcquireThreadCache();
+
+	uint32_t offset = page.Allocate(*cache, 100u);
+	uint32_t offset2 = page.Allocate(*cache, 100u);
+	uint32_t offset3 = page.Allocate(*cache, 24u, 64u);
+	REQUIRE(offset2 == offset + dbz::ConcurrentMemoryPage::GetSizeClassSize(dbz::ConcurrentMemoryPage::GetSizeClass(100u)));
+	REQUIRE(offset3 % 64u == 0u);
+
+	// Only whole spans are taken from the shared page
+	REQUIRE(page.GetStats().myInUseBytes == 2u * dbz::ConcurrentMemoryPage::ourSpanSize);
+
+	REQUIRE(page.Free(*cache, offset));
+	REQUIRE(page.Free(*cache, offset) == false);
+	REQUIRE(page.Free(*cache, offset2 + 1u) == false);
+	REQUIRE(page.Free(*cache, offset2));
+	REQUIRE(page.Free(*cache, offset3));
+
+	// Freed block is handed out again
+	REQUIRE(page.Allocate(*cache, 100u) == offset2);
+
+	page.ReleaseThreadCache(*cache);
+	dbz::ConcurrentMemoryPage::Destroy(page);
+}
+
+TEST_CASE("ConcurrentMemoryPage_LargeAllocationsUseTheSharedPage", "[Memory], [ConcurrentMemoryPage]")
+{
+	dbz::ConcurrentMemoryPage page = dbz::ConcurrentMemoryPage::Create(DBZ_MB);
+	dbz::ConcurrentMemoryPage::ThreadCache* cache = page.AcquireThreadCache();
+
+	uint32_t offset = page.Allocate(*cache, 100 * DBZ_KB);
+	REQUIRE(offset != UINT32_MAX);
+	REQUIRE(page.GetStats().myInUseBytes == 100u * DBZ_KB);
+	REQUIRE(page.Allocate(*cache, 2 * DBZ_MB) == UINT32_MAX);
+	REQUIRE(page.Allocate(*cache, 0u) == UINT32_MAX);
+
+	REQUIRE(page.Free(*cache, offset + 1u) == false);
+	REQUIRE(page.Free(*cache, offset));
+	REQUIRE(page.Free(*cache, offset) == false);
+
+	page.ReleaseThreadCache(*cache);
+	dbz::ConcurrentMemoryPage::Destroy(page);
+}
+
+TEST_CASE("ConcurrentMemoryPage_EmptySpansAreGivenBack", "[Memory], [ConcurrentMemoryPage]")
+{
+	dbz::ConcurrentMemoryPage page = dbz::ConcurrentMemoryPage::Create(4 * DBZ_MB);
+	dbz::ConcurrentMemoryPage::ThreadCache* cache = page.AcquireThreadCache();
+
+	// Four spans worth of blocks
+	std::vector<uint32_t> offsets;
+	for (uint32_t i = 0; i < 4u * dbz::ConcurrentMemoryPage::ourSpanSize / DBZ_KB; ++i)
+		offsets.push_back(page.Allocate(*cache, DBZ_KB));
+	REQUIRE(page.GetStats().myInUseBytes == 4u * dbz::ConcurrentMemoryPage::ourSpanSize);
+
+	for (uint32_t offset : offsets)
+		REQUIRE(page.Free(*cache, offset));
+
+	// One span is kept for the size class
+	REQUIRE(page.GetStats().myInUseBytes == dbz::ConcurrentMemoryPage::ourSpanSize);
+
+	page.ReleaseThreadCache(*cache);
+	dbz::ConcurrentMemoryPage::Destroy(page);
+}
+
+TEST_CASE("ConcurrentMemoryPage_FreesFromOtherThreadsAreQueuedToTheOwner", "[Memory], [ConcurrentMemoryPage]")
+{
+	dbz::ConcurrentMemoryPage page = dbz::ConcurrentMemoryPage::Create(DBZ_MB);
+	dbz::ConcurrentMemoryPage::ThreadCache* cache = page.AcquireThreadCache();
+
+	std::vector<uint32_t> offsets;
+	for (int i = 0; i < 10000; ++i)
+		offsets.push_back(page.Allocate(*cache, 32u));
+
+	// More frees than the queue holds, the rest overflows
+	bool succeeded = true;
+	std::thread thread([&page, &offsets, &succeeded]()
+	{
+		dbz::ConcurrentMemoryPage::ThreadCache* otherCache = page.AcquireThreadCache();
+		for (uint32_t offset : offsets)
+			succeeded &= page.Free(*otherCache, offset);
+		page.ReleaseThreadCache(*otherCache);
+	});
+	thread.join();
+	REQUIRE(succeeded);
+
+	// Nothing is freed until the owner drains the queue
+	REQUIRE(page.GetStats().myInUseBytes > dbz::ConcurrentMemoryPage::ourSpanSize);
+	page.DrainRemoteFrees(*cache);
+	REQUIRE(page.GetStats().myInUseBytes == dbz::ConcurrentMemoryPage::ourSpanSize);
+
+	uint32_t offset = page.Allocate(*cache, 32u);
+	REQUIRE(std::find(offsets.begin(), offsets.end(), offset) != offsets.end());
+	REQUIRE(page.GetStats().myInUseBytes == dbz::ConcurrentMemoryPage::ourSpanSize);
+
+	page.ReleaseThreadCache(*cache);
+	dbz::ConcurrentMemoryPage::Destroy(page);
+}
+
+TEST_CASE("ConcurrentMemoryPage_ReleasedCachesAreReused", "[Memory], [ConcurrentMemoryPage]")
+{
+	dbz::ConcurrentMemoryPage page = dbz::ConcurrentMemoryPage::Create(DBZ_MB);
+
+	dbz::ConcurrentMemoryPage::ThreadCache* cache = page.AcquireThreadCache();
+	uint32_t offset = page.Allocate(*cache, 32u);
+	page.ReleaseThreadCache(*cache);
+
+	// Blocks of a released cache can still be freed by whoever gets it next
+	dbz::ConcurrentMemoryPage::ThreadCache* cache2 = page.AcquireThreadCache();
+	REQUIRE(cache2 == cache);
+	REQUIRE(page.Free(*cache2, offset));
+
+	std::vector<dbz::ConcurrentMemoryPage::ThreadCache*> caches;
+	for (uint32_t i = 1u; i < dbz::ConcurrentMemoryPage::ourMaxThreadCacheCount; ++i)
+		caches.push_back(page.AcquireThreadCache());
+	REQUIRE(std::find(caches.begin(), caches.end(), nullptr) == caches.end());
+	REQUIRE(page.AcquireThreadCache() == nullptr);
+
+	for (dbz::ConcurrentMemoryPage::ThreadCache* otherCache : caches)
+		page.ReleaseThreadCache(*otherCache);
+	page.ReleaseThreadCache(*cache2);
+	dbz::ConcurrentMemoryPage::Destroy(page);
+}
+
+TEST_CASE("ConcurrentMemoryPage_FreesToReleasedCachesAreNotKeptForever", "[Memory], [ConcurrentMemoryPage]")
+{
+	dbz::ConcurrentMemoryPage page = dbz::ConcurrentMemoryPage::Create(DBZ_MB);
+
+	dbz::ConcurrentMemoryPage::ThreadCache* cache = page.AcquireThreadCache();
+	dbz::ConcurrentMemoryPage::ThreadCache* cache2 = page.AcquireThreadCache();
+
+	// Several times the remote free queue capacity
+	std::vector<uint32_t> offsets;
+	for (uint32_t i = 0; i < 5u * dbz::ConcurrentMemoryPage::ourSpanSize / 16u; ++i)
+		offsets.push_back(page.Allocate(*cache, 16u));
+	page.ReleaseThreadCache(*cache);
+	REQUIRE(page.GetStats().myInUseBytes == 5u * dbz::ConcurrentMemoryPage::ourSpanSize);
+
+	// Nobody owns the cache, full queues are drained by the freeing thread
+	for (uint32_t offset : offsets)
+		REQUIRE(page.Free(*cache2, offset));
+	REQUIRE(page.GetStats().myInUseBytes <= 2u * dbz::ConcurrentMemoryPage::ourSpanSize);
+
+	// Frees still queued are processed when the cache is acquired again
+	page.ReleaseThreadCache(*cache2);
+	REQUIRE(page.AcquireThreadCache() == cache);
+	REQUIRE(page.GetStats().myInUseBytes == dbz::ConcurrentMemoryPage::ourSpanSize);
+
+	page.ReleaseThreadCache(*cache);
+	dbz::ConcurrentMemoryPage::Destroy(page);
+}
+
+TEST_CASE("ConcurrentMemoryPage_AllocationDeallocation_StressTest", "[Memory], [ConcurrentMemoryPage], [StressTest]")
+{
+	constexpr uint32_t threadCount = 4u;
+	dbz::ConcurrentMemoryPage page = dbz::ConcurrentMemoryPage::Create(64 * DBZ_MB);
+
+	// Allocations handed between threads, so some are freed by a thread that does not own them
+	std::mutex sharedMutex;
+	std::vector<std::pair<uint32_t, uint32_t>> sharedAllocations;
+
+	std::vector<std::vector<std::pair<uint32_t, uint32_t>>> liveAllocations(threadCount);
+	// Catch assertions are not thread safe, failures are counted and checked once threads are done
+	std::vector<uint32_t> failureCounts(threadCount, 0u);
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0u; t < threadCount; ++t)
+	{
+		threads.emplace_back([&, t]()
+		{
+			dbz::ConcurrentMemoryPage::ThreadCache* cache = page.AcquireThreadCache();
+			std::vector<std::pair<uint32_t, uint32_t>>& allocations = liveAllocations[t];
+			uint32_t random = t * 7919u + 1u;
+			for (int i = 0; i < 50000; ++i)
+			{
+				random = random * 1664525u + 1013904223u;
+				uint32_t choice = random >> 24u;
+				if (allocations.empty() || choice < 128u)
+				{
+					uint32_t size = choice < 4u ? 16u * DBZ_KB : (random >> 8u) % 512u + 1u;
+					uint32_t offset = page.Allocate(*cache, size);
+					if (offset == UINT32_MAX)
+					{
+						++failureCounts[t];
+						continue;
+					}
+					allocations.emplace_back(offset, size);
+				}
+				else if (choice < 160u)
+				{
+					std::lock_guard<std::mutex> lock(sharedMutex);
+					sharedAllocations.push_back(allocations.back());
+					allocations.pop_back();
+				}
+				else if (choice < 192u)
+				{
+					std::pair<uint32_t, uint32_t> allocation;
+					{
+						std::lock_guard<std::mutex> lock(sharedMutex);
+						if (sharedAllocations.empty())
+							continue;
+						allocation = sharedAllocations.back();
+						sharedAllocations.pop_back();
+					}
+					failureCounts[t] += page.Free(*cache, allocation.first) ? 0u : 1u;
+				}
+				else
+				{
+					uint32_t index = (random >> 4u) % allocations.size();
+					failureCounts[t] += page.Free(*cache, allocations[index].first) ? 0u : 1u;
+					allocations[index] = allocations.back();
+					allocations.pop_back();
+				}
+			}
+			page.ReleaseThreadCache(*cache);
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	for (uint32_t failureCount : failureCounts)
+		REQUIRE(failureCount == 0u);
+
+	std::vector<std::pair<uint32_t, uint32_t>> allAllocations = sharedAllocations;
+	for (const std::vector<std::pair<uint32_t, uint32_t>>& allocations : liveAllocations)
+		allAllocations.insert(allAllocations.end(), allocations.begin(), allocations.end());
+	REQUIRE(AreDisjoint(allAllocations));
+
+	dbz::ConcurrentMemoryPage::ThreadCache* cache = page.AcquireThreadCache();
+	for (const std::pair<uint32_t, uint32_t>& allocation : allAllocations)
+		REQUIRE(page.Free(*cache, allocation.first));
+	page.ReleaseThreadCache(*cache);
+
+	dbz::ConcurrentMemoryPage::Destroy(page);
+}
@@ -0,0 +1,77 @@
+#include <catch/catch.hpp>
+
+#include "Memory/FrameArena.h"
+
+#define DBZ_KB (1 << 10)
+
+TEST_CASE("FrameArena_ArenaLifeTimeManagedThroughStaticFunctions", "[Memory], [FrameArena]")
+{
+	dbz::FrameArena arena = dbz::FrameArena::Create(DBZ_KB);
+	REQUIRE(arena.GetCapacity() == DBZ_KB);
+	dbz::FrameArena::Destroy(arena);
+}
+
+TEST_CASE("FrameArena_CanAllocateAlignedMemory", "[Memory], [FrameArena]")
+{
+	dbz::FrameArena arena = dbz::FrameArena::Create(DBZ_KB);
+
+	void* allocation = arena.Allocate(1u, 1u);
+	void* alignedAllocation = arena.Allocate(16u, 64u);
+	uint32_t* arrayAllocation = arena.AllocateArray<uint32_t>(4u);
+
+	REQUIRE(allocation != nullptr);
+	REQUIRE(reinterpret_cast<uintptr_t>(alignedAllocation) % 64u == 0u);
+	REQUIRE(reinterpret_cast<uintptr_t>(arrayAllocation) % alignof(uint32_t) == 0u);
+	REQUIRE(static_cast<uint8_t*>(alignedAllocation) > static_cast<uint8_t*>(allocation));
+
+	dbz::FrameArena::Destroy(arena);
+}
+
+TEST_CASE("FrameArena_AllocationFailsWhenOutOfCapacity", "[Memory], [FrameArena]")
+{
+	dbz::FrameArena arena = dbz::FrameArena::Create(DBZ_KB);
+
+	REQUIRE(arena.Allocate(DBZ_KB, 1u) != nullptr);
+	REQUIRE(arena.Allocate(1u, 1u) == nullptr);
+	REQUIRE(arena.GetUsedSize() == DBZ_KB);
+
+	dbz::FrameArena::Destroy(arena);
+}
+
+TEST_CASE("FrameArena_ResetReleasesAllAllocations", "[Memory], [FrameArena]")
+{
+	dbz::FrameArena arena = dbz::FrameArena::Create(DBZ_KB);
+
+	void* allocation = arena.Allocate(DBZ_KB / 2, 1u);
+	arena.Allocate(DBZ_KB / 4, 1u);
+	arena.Reset();
+
+	REQUIRE(arena.GetUsedSize() == 0u);
+	REQUIRE(arena.Allocate(DBZ_KB / 2, 1u) == allocation);
+	REQUIRE(arena.GetHighWaterMark() == 3 * DBZ_KB / 4);
+
+	dbz::FrameArena::Destroy(arena);
+}
+
+TEST_CASE("FrameArena_ScopeRewindsToMarker", "[Memory], [FrameArena]")
+{
+	dbz::FrameArena arena = dbz::FrameArena::Create(DBZ_KB);
+
+	arena.Allocate(16u, 1u);
+	dbz::FrameArena::Marker marker = arena.GetMarker();
+
+	{
+		dbz::FrameArena::Scope scope(arena);
+		arena.Allocate(DBZ_KB / 2, 1u);
+		REQUIRE(arena.GetUsedSize() == 16u + DBZ_KB / 2);
+	}
+
+	REQUIRE(arena.GetMarker() == marker);
+	REQUIRE(arena.GetHighWaterMark() == 16u + DBZ_KB / 2);
+
+	arena.Allocate(16u, 1u);
+	arena.Rewind(marker);
+	REQUIRE(arena.GetUsedSize() == 16u);
+
+	dbz::FrameArena::Destroy(arena);
+}
@@ -0,0 +1,129 @@
+#include <catch/catch.hpp>
+
+#include "Math/Frustum.h"
+#include "Math/Quaternion.h"
+
+#include <vector>
+
+namespace
+{
+	static constexpr int locStressTestCount = 100;
+	// Odd so the batches have a tail
+	static constexpr uint32_t locBoundsCount = 1027u;
+
+	float RandomFloat()
+	{
+		return static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0f - 1.0f;
+	}
+
+	// 90 degrees field of view with a square aspect ratio, so the side planes are at 45 degrees
+	Frustum CreateFrustum(const Matrix44& aView)
+	{
+		return Frustum{ Matrix44::Perspective(Math::PI * 0.5f, 1.0f, 1.0f, 10.0f) * aView };
+	}
+
+	void RequirePlane(const Vector4& aPlane, float aX, float aY, float aZ, float aW)
+	{
+		REQUIRE(aPlane.x == Approx(aX).margin(1e-6f));
+		REQUIRE(aPlane.y == Approx(aY).margin(1e-6f));
+		REQUIRE(aPlane.z == Approx(aZ).margin(1e-6f));
+		REQUIRE(aPlane.w == Approx(aW).margin(1e-5f));
+	}
+}
+
+TEST_CASE("Frustum_PlanesMatchPerspective", "[Math], [Frustum]")
+{
+	Frustum frustum = CreateFrustum(Matrix44{});
+	float diagonal = sqrtf(0.5f);
+	RequirePlane(frustum.myPlanes[0], diagonal, 0.0f, -diagonal, 0.0f);
+	RequirePlane(frustum.myPlanes[1], -diagonal, 0.0f, -diagonal, 0.0f);
+	RequirePlane(frustum.myPlanes[2], 0.0f, -diagonal, -diagonal, 0.0f);
+	RequirePlane(frustum.myPlanes[3], 0.0f, diagonal, -diagonal, 0.0f);
+	RequirePlane(frustum.myPlanes[4], 0.0f, 0.0f, -1.0f, -1.0f);
+	RequirePlane(frustum.myPlanes[5], 0.0f, 0.0f, 1.0f, 10.0f);
+
+	REQUIRE(frustum.IsSphereVisible(Vector3{ 0.0f, 0.0f, -5.0f }, 0.0f));
+	REQUIRE_FALSE(frustum.IsSphereVisible(Vector3{ 0.0f, 0.0f, -0.5f }, 0.1f));
+	REQUIRE(frustum.IsSphereVisible(Vector3{ 0.0f, 0.0f, -0.5f }, 0.6f));
+	REQUIRE_FALSE(frustum.IsSphereVisible(Vector3{ 0.0f, 0.0f, -11.0f }, 0.5f));
+	REQUIRE(frustum.IsSphereVisible(Vector3{ 0.0f, 0.0f, -11.0f }, 1.5f));
+	REQUIRE_FALSE(frustum.IsSphereVisible(Vector3{ 6.0f, 0.0f, -5.0f }, 0.5f));
+	REQUIRE(frustum.IsSphereVisible(Vector3{ 6.0f, 0.0f, -5.0f }, 1.0f));
+
+	// The nearest corner of the box is sqrt(2) * extent closer to the plane than its center
+	REQUIRE_FALSE(frustum.IsBoxVisible(Vector3{ 6.0f, 0.0f, -5.0f }, Vector3{ 0.4f, 0.4f, 0.4f }));
+	REQUIRE(frustum.IsBoxVisible(Vector3{ 6.0f, 0.0f, -5.0f }, Vector3{ 0.6f, 0.6f, 0.6f }));
+	REQUIRE_FALSE(frustum.IsBoxVisible(Vector3{ 0.0f, 7.0f, -5.0f }, Vector3{ 10.0f, 1.0f, 0.5f }));
+	REQUIRE(frustum.IsBoxVisible(Vector3{ 0.0f, 7.0f, -5.0f }, Vector3{ 0.5f, 2.5f, 0.5f }));
+
+	// The view matrix moves the world, a camera at z = 20 sees what is in front of it
+	Frustum movedFrustum = CreateFrustum(Matrix44::Translate(0.0f, 0.0f, -20.0f));
+	REQUIRE(movedFrustum.IsSphereVisible(Vector3{ 0.0f, 0.0f, 15.0f }, 0.0f));
+	REQUIRE_FALSE(movedFrustum.IsSphereVisible(Vector3{ 0.0f, 0.0f, -5.0f }, 0.0f));
+}
+
+TEST_CASE("Frustum_CullingMatchesPerObjectTests_StressTest", "[Math], [Frustum], [StressTest]")
+{
+	std::vector<float> x(locBoundsCount), y(locBoundsCount), z(locBoundsCount);
+	std::vector<float> extentX(locBoundsCount), extentY(locBoundsCount), extentZ(locBoundsCount);
+	std::vector<uint32_t> visibleIndices(locBoundsCount);
+	Frustum::SphereStream spheres{ x.data(), y.data(), z.data(), extentX.data() };
+	Frustum::BoxStream boxes{ x.data(), y.data(), z.data(), extentX.data(), extentY.data(), extentZ.data() };
+
+	for (int i = 0; i < locStressTestCount; ++i)
+	{
+		Quaternion rotation{ Vector3{ RandomFloat(), RandomFloat(), RandomFloat() + 2.0f }, Math::Radian{ RandomFloat() * Math::PI } };
+		Frustum frustum = CreateFrustum(rotation.GetMatrix() * Matrix44::Translate(RandomFloat() * 5.0f, RandomFloat() * 5.0f, RandomFloat() * 5.0f));
+
+		for (uint32_t j = 0u; j < locBoundsCount; ++j)
+		{
+			x[j] = RandomFloat() * 15.0f;
+			y[j] = RandomFloat() * 15.0f;
+			z[j] = RandomFloat() * 15.0f;
+			extentX[j] = RandomFloat() + 1.0f;
+			extentY[j] = RandomFloat() + 1.0f;
+			extentZ[j] = RandomFloat() + 1.0f;
+		}
+
+		// Some of them, but not all, have to be visible for the test to mean anything
+		uint32_t visibleCount = frustum.CullSpheres(spheres, locBoundsCount, visibleIndices.data());
+		REQUIRE(visibleCount > 0u);
+		REQUIRE(visibleCount < locBoundsCount);
+		uint32_t expectedIndex = 0u;
+		for (uint32_t j = 0u; j < locBoundsCount; ++j)
+		{
+			if (frustum.IsSphereVisible(Vector3{ x[j], y[j], z[j] }, extentX[j]))
+				REQUIRE(visibleIndices[expectedIndex++] == j);
+		}
+		REQUIRE(visibleCount == expectedIndex);
+
+		visibleCount = frustum.CullBoxes(boxes, locBoundsCount, visibleIndices.data());
+		expectedIndex = 0u;
+		for (uint32_t j = 0u; j < locBoundsCount; ++j)
+		{
+			if (frustum.IsBoxVisible(Vector3{ x[j], y[j], z[j] }, Vector3{ extentX[j], extentY[j], extentZ[j] }))
+				REQUIRE(visibleIndices[expectedIndex++] == j);
+		}
+		REQUIRE(visibleCount == expectedIndex);
+	}
+}
+
+TEST_CASE("Frustum_CanCullEmptyAndShortArrays", "[Math], [Frustum]")
+{
+	Frustum frustum = CreateFrustum(Matrix44{});
+	float x[3] = { 0.0f, 20.0f, 0.0f };
+	float y[3] = { 0.0f, 0.0f, 0.0f };
+	float z[3] = { -5.0f, -5.0f, -9.0f };
+	float radius[3] = { 1.0f, 1.0f, 1.0f };
+	uint32_t visibleIndices[3] = { 7u, 7u, 7u };
+	Frustum::SphereStream spheres{ x, y, z, radius };
+
+	REQUIRE(frustum.CullSpheres(spheres, 0u, visibleIndices) == 0u);
+	REQUIRE(visibleIndices[0] == 7u);
+	REQUIRE(frustum.CullSpheres(spheres, 3u, visibleIndices) == 2u);
+	REQUIRE(visibleIndices[0] == 0u);
+	REQUIRE(visibleIndices[1] == 2u);
+
+	// A default frustum has no planes to be outside of
+	REQUIRE(Frustum{}.CullSpheres(spheres, 3u, visibleIndices) == 3u);
+}
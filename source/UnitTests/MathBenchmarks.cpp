@@ -0,0 +1,280 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch/catch.hpp>
+
+#include "Math/Frustum.h"
+#include "Math/Matrix44.h"
+#include "Math/Quaternion.h"
+
+#include <vector>
+
+namespace
+{
+	static constexpr uint32_t locPointCount = 4096u;
+	static constexpr uint32_t locMatrixCount = 1024u;
+	static constexpr uint32_t locBoundsCount = 50000u;
+
+	float RandomFloat()
+	{
+		return static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0f - 1.0f;
+	}
+
+	Matrix44 CreateRandomMatrix()
+	{
+		return Matrix44{ RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat(),
+										 RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat(),
+										 RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat(),
+										 RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat() };
+	}
+}
+
+// Hidden by default, run with [Benchmark]
+TEST_CASE("Matrix44_TransformPoints_Benchmark", "[.], [Math], [Matrix44], [Benchmark]")
+{
+	alignas(32) static float x[locPointCount];
+	alignas(32) static float y[locPointCount];
+	alignas(32) static float z[locPointCount];
+	alignas(32) static float xOut[locPointCount];
+	alignas(32) static float yOut[locPointCount];
+	alignas(32) static float zOut[locPointCount];
+	for (uint32_t i = 0u; i < locPointCount; ++i)
+	{
+		x[i] = RandomFloat();
+		y[i] = RandomFloat();
+		z[i] = RandomFloat();
+	}
+
+	Matrix44 matrix = CreateRandomMatrix();
+
+	BENCHMARK("PerVector")
+	{
+		for (uint32_t i = 0u; i < locPointCount; ++i)
+		{
+			Vector4 result = matrix * Vector4{ x[i], y[i], z[i], 1.0f };
+			xOut[i] = result.x;
+			yOut[i] = result.y;
+			zOut[i] = result.z;
+		}
+		return xOut[0];
+	};
+
+	BENCHMARK("Batch")
+	{
+		matrix.TransformPoints(x, y, z, xOut, yOut, zOut, locPointCount);
+		return xOut[0];
+	};
+
+	BENCHMARK("BatchAligned")
+	{
+		matrix.TransformPointsAligned(x, y, z, xOut, yOut, zOut, locPointCount);
+		return xOut[0];
+	};
+}
+
+TEST_CASE("Matrix44_MultiplyBatch_Benchmark", "[.], [Math], [Matrix44], [Benchmark]")
+{
+	std::vector<Matrix44> parents(locMatrixCount);
+	std::vector<Matrix44> locals(locMatrixCount);
+	std::vector<Matrix44> results(locMatrixCount);
+	for (uint32_t i = 0u; i < locMatrixCount; ++i)
+	{
+		parents[i] = CreateRandomMatrix();
+		locals[i] = CreateRandomMatrix();
+	}
+
+	BENCHMARK("PerMatrix")
+	{
+		for (uint32_t i = 0u; i < locMatrixCount; ++i)
+			results[i] = parents[i] * locals[i];
+		return results[0].myXAxis.x;
+	};
+
+	BENCHMARK("Batch")
+	{
+		Matrix44::MultiplyBatch(parents.data(), locals.data(), results.data(), locMatrixCount);
+		return results[0].myXAxis.x;
+	};
+}
+
+TEST_CASE("Matrix44_Inverse_Benchmark", "[.], [Math], [Matrix44], [Benchmark]")
+{
+	std::vector<Matrix44> matrices(locMatrixCount);
+	std::vector<Matrix44> results(locMatrixCount);
+	for (uint32_t i = 0u; i < locMatrixCount; ++i)
+		matrices[i] = Matrix44::Translate(RandomFloat(), RandomFloat(), RandomFloat()) * Matrix44::Scale(RandomFloat() + 2.0f, RandomFloat() + 2.0f, RandomFloat() + 2.0f);
+
+	BENCHMARK("Transpose")
+	{
+		for (uint32_t i = 0u; i < locMatrixCount; ++i)
+			results[i] = matrices[i].Transpose();
+		return results[0].myXAxis.x;
+	};
+
+	BENCHMARK("Inverse")
+	{
+		for (uint32_t i = 0u; i < locMatrixCount; ++i)
+			results[i] = matrices[i].Inverse();
+		return results[0].myXAxis.x;
+	};
+
+	BENCHMARK("InverseAffine")
+	{
+		for (uint32_t i = 0u; i < locMatrixCount; ++i)
+			results[i] = matrices[i].InverseAffine();
+		return results[0].myXAxis.x;
+	};
+
+	BENCHMARK("InverseRigid")
+	{
+		for (uint32_t i = 0u; i < locMatrixCount; ++i)
+			results[i] = matrices[i].InverseRigid();
+		return results[0].myXAxis.x;
+	};
+}
+
+TEST_CASE("Quaternion_Batch_Benchmark", "[.], [Math], [Quaternion], [Benchmark]")
+{
+	std::vector<Quaternion> from(locMatrixCount);
+	std::vector<Quaternion> to(locMatrixCount);
+	std::vector<Quaternion> results(locMatrixCount);
+	std::vector<Matrix44> matrices(locMatrixCount);
+	std::vector<float> fromElements[4], toElements[4], resultElements[4];
+	for (uint32_t i = 0u; i < 4u; ++i)
+	{
+		fromElements[i].resize(locMatrixCount);
+		toElements[i].resize(locMatrixCount);
+		resultElements[i].resize(locMatrixCount);
+	}
+
+	for (uint32_t i = 0u; i < locMatrixCount; ++i)
+	{
+		from[i] = Quaternion{ Vector3{ RandomFloat(), RandomFloat(), RandomFloat() + 2.0f }, Math::Radian(RandomFloat() * Math::PI) };
+		to[i] = Quaternion{ Vector3{ RandomFloat() + 2.0f, RandomFloat(), RandomFloat() }, Math::Radian(RandomFloat() * Math::PI) };
+		const float* fromValues = &from[i].myAxis.x;
+		const float* toValues = &to[i].myAxis.x;
+		for (uint32_t j = 0u; j < 4u; ++j)
+		{
+			fromElements[j][i] = fromValues[j];
+			toElements[j][i] = toValues[j];
+		}
+	}
+
+	Quaternion::ConstStream fromStream{ fromElements[0].data(), fromElements[1].data(), fromElements[2].data(), fromElements[3].data() };
+	Quaternion::ConstStream toStream{ toElements[0].data(), toElements[1].data(), toElements[2].data(), toElements[3].data() };
+	Quaternion::Stream resultStream{ resultElements[0].data(), resultElements[1].data(), resultElements[2].data(), resultElements[3].data() };
+
+	BENCHMARK("GetMatrix")
+	{
+		for (uint32_t i = 0u; i < locMatrixCount; ++i)
+			matrices[i] = from[i].GetMatrix();
+		return matrices[0].myXAxis.x;
+	};
+
+	BENCHMARK("ToMatrices")
+	{
+		Quaternion::ToMatrices(from.data(), matrices.data(), locMatrixCount);
+		return matrices[0].myXAxis.x;
+	};
+
+	BENCHMARK("Slerp")
+	{
+		for (uint32_t i = 0u; i < locMatrixCount; ++i)
+			results[i] = Quaternion::Slerp(from[i], to[i], 0.3f);
+		return results[0].myValue;
+	};
+
+	BENCHMARK("SlerpBatch")
+	{
+		Quaternion::SlerpBatch(fromStream, toStream, 0.3f, resultStream, locMatrixCount);
+		return resultElements[3][0];
+	};
+
+	BENCHMARK("Nlerp")
+	{
+		for (uint32_t i = 0u; i < locMatrixCount; ++i)
+			results[i] = Quaternion::Nlerp(from[i], to[i], 0.3f);
+		return results[0].myValue;
+	};
+
+	BENCHMARK("NlerpBatch")
+	{
+		Quaternion::NlerpBatch(fromStream, toStream, 0.3f, resultStream, locMatrixCount);
+		return resultElements[3][0];
+	};
+}
+
+TEST_CASE("MathCommon_SinCos_Benchmark", "[.], [Math], [MathCommon], [Benchmark]")
+{
+	std::vector<float> angles(locPointCount);
+	std::vector<float> sines(locPointCount);
+	std::vector<float> cosines(locPointCount);
+	for (uint32_t i = 0u; i < locPointCount; ++i)
+		angles[i] = RandomFloat() * 100.0f;
+
+	BENCHMARK("SinCos")
+	{
+		for (uint32_t i = 0u; i < locPointCount; ++i)
+		{
+			sines[i] = Math::Sin(Math::Radian(angles[i]));
+			cosines[i] = Math::Cos(Math::Radian(angles[i]));
+		}
+		return sines[0];
+	};
+
+	BENCHMARK("Batch")
+	{
+		Math::SinCos(angles.data(), sines.data(), cosines.data(), locPointCount);
+		return sines[0];
+	};
+}
+
+TEST_CASE("Frustum_Cull_Benchmark", "[.], [Math], [Frustum], [Benchmark]")
+{
+	std::vector<float> x(locBoundsCount), y(locBoundsCount), z(locBoundsCount);
+	std::vector<float> extentX(locBoundsCount), extentY(locBoundsCount), extentZ(locBoundsCount);
+	std::vector<uint32_t> visibleIndices(locBoundsCount);
+	for (uint32_t i = 0u; i < locBoundsCount; ++i)
+	{
+		x[i] = RandomFloat() * 100.0f;
+		y[i] = RandomFloat() * 100.0f;
+		z[i] = RandomFloat() * 100.0f;
+		extentX[i] = RandomFloat() + 1.5f;
+		extentY[i] = RandomFloat() + 1.5f;
+		extentZ[i] = RandomFloat() + 1.5f;
+	}
+
+	Frustum frustum{ Matrix44::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 100.0f) };
+	Frustum::SphereStream spheres{ x.data(), y.data(), z.data(), extentX.data() };
+	Frustum::BoxStream boxes{ x.data(), y.data(), z.data(), extentX.data(), extentY.data(), extentZ.data() };
+
+	BENCHMARK("IsSphereVisible")
+	{
+		uint32_t visibleCount = 0u;
+		for (uint32_t i = 0u; i < locBoundsCount; ++i)
+		{
+			if (frustum.IsSphereVisible(Vector3{ x[i], y[i], z[i] }, extentX[i]))
+				visibleIndices[visibleCount++] = i;
+		}
+		return visibleCount;
+	};
+
+	BENCHMARK("CullSpheres")
+	{
+		return frustum.CullSpheres(spheres, locBoundsCount, visibleIndices.data());
+	};
+
+	BENCHMARK("IsBoxVisible")
+	{
+		uint32_t visibleCount = 0u;
+		for (uint32_t i = 0u; i < locBoundsCount; ++i)
+		{
+			if (frustum.IsBoxVisible(Vector3{ x[i], y[i], z[i] }, Vector3{ extentX[i], extentY[i], extentZ[i] }))
+				visibleIndices[visibleCount++] = i;
+		}
+		return visibleCount;
+	};
+
+	BENCHMARK("CullBoxes")
+	{
+		return frustum.CullBoxes(boxes, locBoundsCount, visibleIndices.data());
+	};
+}
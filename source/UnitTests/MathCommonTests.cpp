@@ -0,0 +1,106 @@
+#include <catch/catch.hpp>
+
+#include "Math/MathCommon.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	static constexpr int locStressTestCount = 10000;
+
+	float RandomAngle(float aRange)
+	{
+		return (static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0f - 1.0f) * aRange;
+	}
+
+	// Floats between aValue and the correctly rounded anExpected
+	int64_t GetUlpDistance(float aValue, double anExpected)
+	{
+		auto toOrdered = [](float aFloat) -> int64_t
+		{
+			int32_t bits;
+			std::memcpy(&bits, &aFloat, sizeof(bits));
+			return bits < 0 ? -static_cast<int64_t>(bits & 0x7FFFFFFF) : bits;
+		};
+
+		int64_t distance = toOrdered(aValue) - toOrdered(static_cast<float>(anExpected));
+		return distance < 0 ? -distance : distance;
+	}
+
+	void RequireSinCos(float anAngle, float aSine, float aCosine)
+	{
+		double expectedSine = std::sin(static_cast<double>(anAngle));
+		double expectedCosine = std::cos(static_cast<double>(anAngle));
+
+		// Ulp are meaningless next to the zeros, there the error is bound in absolute terms
+		REQUIRE(std::fabs(aSine - expectedSine) <= 1e-7);
+		REQUIRE(std::fabs(aCosine - expectedCosine) <= 1e-7);
+		if (std::fabs(expectedSine) > 1e-3)
+			REQUIRE(GetUlpDistance(aSine, expectedSine) <= 2);
+		if (std::fabs(expectedCosine) > 1e-3)
+			REQUIRE(GetUlpDistance(aCosine, expectedCosine) <= 2);
+	}
+}
+
+TEST_CASE("MathCommon_SinCosMatchesQuadrants", "[Math], [MathCommon]")
+{
+	float sine, cosine;
+	Math::SinCos(Math::Radian(0.0f), sine, cosine);
+	REQUIRE(sine == 0.0f);
+	REQUIRE(cosine == 1.0f);
+
+	Math::SinCos(Math::Degree(90.0f), sine, cosine);
+	REQUIRE(sine == Approx(1.0f));
+	REQUIRE(cosine == Approx(0.0f).margin(1e-7f));
+
+	Math::SinCos(Math::Degree(-180.0f), sine, cosine);
+	REQUIRE(sine == Approx(0.0f).margin(1e-7f));
+	REQUIRE(cosine == Approx(-1.0f));
+
+	Math::SinCos(Math::Degree(270.0f), sine, cosine);
+	REQUIRE(sine == Approx(-1.0f));
+	REQUIRE(cosine == Approx(0.0f).margin(1e-7f));
+
+	SIMD::Vector angles = SIMD::Load(Math::PI / 6.0f, Math::PI * 0.75f, -Math::PI / 3.0f, Math::PI * 1.25f);
+	SIMD::Vector tangents = Math::Tan(angles);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(tangents, 0) == Approx(std::tan(Math::PI / 6.0f)));
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(tangents, 1) == Approx(-1.0f));
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(tangents, 2) == Approx(-std::sqrt(3.0f)));
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(tangents, 3) == Approx(1.0f));
+}
+
+TEST_CASE("MathCommon_SinCosIsAccurate_StressTest", "[Math], [MathCommon], [StressTest]")
+{
+	for (int i = 0; i < locStressTestCount; ++i)
+	{
+		const float angles[4] = { RandomAngle(Math::PI), RandomAngle(100.0f), RandomAngle(8192.0f), RandomAngle(1e-3f) };
+		SIMD::Vector sines, cosines;
+		Math::SinCos(SIMD::LoadUnaligned(angles), sines, cosines);
+
+		for (unsigned int j = 0u; j < 4u; ++j)
+			RequireSinCos(angles[j], SIMD_VECTOR_INDEX_OPERATOR(sines, j), SIMD_VECTOR_INDEX_OPERATOR(cosines, j));
+	}
+}
+
+TEST_CASE("MathCommon_CanSinCosArrays", "[Math], [MathCommon]")
+{
+	// Odd so the batch has a tail
+	constexpr uint32_t count = 1027u;
+	std::vector<float> angles(count);
+	std::vector<float> sines(count);
+	std::vector<float> cosines(count);
+	for (uint32_t i = 0u; i < count; ++i)
+		angles[i] = RandomAngle(8192.0f);
+
+	Math::SinCos(angles.data(), sines.data(), cosines.data(), count);
+	for (uint32_t i = 0u; i < count; ++i)
+		RequireSinCos(angles[i], sines[i], cosines[i]);
+
+	// Sines written over the angles, with a start that is not 16 byte aligned
+	std::vector<float> expectedSines = sines;
+	Math::SinCos(angles.data() + 1, angles.data() + 1, cosines.data() + 1, count - 1u);
+	for (uint32_t i = 1u; i < count; ++i)
+		REQUIRE(angles[i] == expectedSines[i]);
+}
@@ -1,10 +1,107 @@
 #include <catch/catch.hpp>
 
 #include "Math/Matrix44.h"
+#include "Math/Quaternion.h"
+
+#include <cmath>
+#include <utility>
 
 namespace
 {
 	static constexpr int locStressTestCount = 10000;
+
+	float RandomFloat()
+	{
+		return static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0f - 1.0f;
+	}
+
+	Matrix44 CreateRandomMatrix()
+	{
+		return Matrix44{ RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat(),
+										 RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat(),
+										 RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat(),
+										 RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat() };
+	}
+
+	// Random axes plus a bigger diagonal, keeps the matrix far from singular
+	Matrix44 CreateInvertibleMatrix()
+	{
+		Matrix44 matrix = CreateRandomMatrix();
+		for (unsigned int i = 0u; i < 4u; ++i)
+			matrix[i][i] += RandomFloat() < 0.0f ? -4.0f : 4.0f;
+		return matrix;
+	}
+
+	Matrix44 CreateRigidMatrix()
+	{
+		Quaternion rotation{ Vector3{ RandomFloat(), RandomFloat(), RandomFloat() + 2.0f }, Math::Radian{ RandomFloat() * 3.0f } };
+		return Matrix44::Translate(RandomFloat() * 10.0f, RandomFloat() * 10.0f, RandomFloat() * 10.0f) * rotation.GetMatrix();
+	}
+
+	// Gauss-Jordan elimination with partial pivoting in double precision
+	void ComputeReferenceInverse(const Matrix44& aMatrix, double someInverseOut[4][4])
+	{
+		double matrix[4][4];
+		for (unsigned int i = 0u; i < 4u; ++i)
+		{
+			for (unsigned int j = 0u; j < 4u; ++j)
+			{
+				matrix[i][j] = aMatrix[i][j];
+				someInverseOut[i][j] = i == j ? 1.0 : 0.0;
+			}
+		}
+
+		for (unsigned int column = 0u; column < 4u; ++column)
+		{
+			unsigned int pivot = column;
+			for (unsigned int row = column + 1u; row < 4u; ++row)
+			{
+				if (std::abs(matrix[row][column]) > std::abs(matrix[pivot][column]))
+					pivot = row;
+			}
+
+			std::swap(matrix[pivot], matrix[column]);
+			std::swap(someInverseOut[pivot], someInverseOut[column]);
+
+			double scale = 1.0 / matrix[column][column];
+			for (unsigned int j = 0u; j < 4u; ++j)
+			{
+				matrix[column][j] *= scale;
+				someInverseOut[column][j] *= scale;
+			}
+
+			for (unsigned int row = 0u; row < 4u; ++row)
+			{
+				if (row == column)
+					continue;
+
+				double factor = matrix[row][column];
+				for (unsigned int j = 0u; j < 4u; ++j)
+				{
+					matrix[row][j] -= factor * matrix[column][j];
+					someInverseOut[row][j] -= factor * someInverseOut[column][j];
+				}
+			}
+		}
+	}
+
+	void RequireReferenceInverse(const Matrix44& aMatrix, const Matrix44& anInverse)
+	{
+		double expected[4][4];
+		ComputeReferenceInverse(aMatrix, expected);
+		for (unsigned int i = 0u; i < 4u; ++i)
+		{
+			for (unsigned int j = 0u; j < 4u; ++j)
+				REQUIRE(anInverse[i][j] == Approx(expected[i][j]).margin(1e-5));
+		}
+
+		Matrix44 identity = aMatrix * anInverse;
+		for (unsigned int i = 0u; i < 4u; ++i)
+		{
+			for (unsigned int j = 0u; j < 4u; ++j)
+				REQUIRE(identity[i][j] == Approx(i == j ? 1.0f : 0.0f).margin(1e-4f));
+		}
+	}
 }
 
 TEST_CASE("Matrix44_CanMultiplyMatrices", "[Math], [Matrix44]")
@@ -188,3 +285,171 @@ TEST_CASE("Matrix44_CanMultiplyWithVector_StressTest", "[Math], [Matrix44], [Str
 		REQUIRE(result.w == Approx(computeCoefficient(3)));
 	}
 }
+
+TEST_CASE("Matrix44_CanTransformStreamsOfPointsAndDirections", "[Math], [Matrix44]")
+{
+	// Counts around the batch widths to cover the tails, streams start one float in so the unaligned variants are used unaligned
+	const uint32_t counts[] = { 0u, 1u, 3u, 4u, 7u, 8u, 9u, 15u, 16u, 17u, 100u };
+	constexpr uint32_t maxCount = 100u;
+	alignas(32) float x[maxCount + 8u];
+	alignas(32) float y[maxCount + 8u];
+	alignas(32) float z[maxCount + 8u];
+	alignas(32) float xOut[maxCount + 8u];
+	alignas(32) float yOut[maxCount + 8u];
+	alignas(32) float zOut[maxCount + 8u];
+
+	Matrix44 matrix = CreateRandomMatrix();
+	for (uint32_t count : counts)
+	{
+		for (uint32_t offset = 0u; offset < 2u; ++offset)
+		{
+			for (uint32_t i = 0u; i < maxCount + 8u; ++i)
+			{
+				x[i] = RandomFloat();
+				y[i] = RandomFloat();
+				z[i] = RandomFloat();
+				xOut[i] = yOut[i] = zOut[i] = -100.0f;
+			}
+
+			for (uint32_t isPoint = 0u; isPoint < 2u; ++isPoint)
+			{
+				if (offset == 0u)
+					isPoint != 0u ? matrix.TransformPointsAligned(x, y, z, xOut, yOut, zOut, count) : matrix.TransformDirectionsAligned(x, y, z, xOut, yOut, zOut, count);
+				else
+					isPoint != 0u ? matrix.TransformPoints(x + 1, y + 1, z + 1, xOut + 1, yOut + 1, zOut + 1, count) : matrix.TransformDirections(x + 1, y + 1, z + 1, xOut + 1, yOut + 1, zOut + 1, count);
+
+				for (uint32_t i = 0u; i < count; ++i)
+				{
+					Vector4 expected = matrix * Vector4{ x[offset + i], y[offset + i], z[offset + i], static_cast<float>(isPoint) };
+					REQUIRE(xOut[offset + i] == Approx(expected.x).margin(1e-5f));
+					REQUIRE(yOut[offset + i] == Approx(expected.y).margin(1e-5f));
+					REQUIRE(zOut[offset + i] == Approx(expected.z).margin(1e-5f));
+				}
+
+				// Nothing written past the end
+				REQUIRE(xOut[offset + count] == -100.0f);
+				REQUIRE(yOut[offset + count] == -100.0f);
+				REQUIRE(zOut[offset + count] == -100.0f);
+			}
+		}
+	}
+}
+
+TEST_CASE("Matrix44_CanTransformStreamsInPlace", "[Math], [Matrix44]")
+{
+	alignas(32) float x[19];
+	alignas(32) float y[19];
+	alignas(32) float z[19];
+	Vector4 expected[19];
+
+	Matrix44 matrix = CreateRandomMatrix();
+	for (uint32_t i = 0u; i < 19u; ++i)
+	{
+		x[i] = RandomFloat();
+		y[i] = RandomFloat();
+		z[i] = RandomFloat();
+		expected[i] = matrix * Vector4{ x[i], y[i], z[i], 1.0f };
+	}
+
+	matrix.TransformPointsAligned(x, y, z, x, y, z, 19u);
+	for (uint32_t i = 0u; i < 19u; ++i)
+	{
+		REQUIRE(x[i] == Approx(expected[i].x).margin(1e-5f));
+		REQUIRE(y[i] == Approx(expected[i].y).margin(1e-5f));
+		REQUIRE(z[i] == Approx(expected[i].z).margin(1e-5f));
+	}
+}
+
+TEST_CASE("Matrix44_CanMultiplyMatricesInBatches", "[Math], [Matrix44]")
+{
+	constexpr uint32_t count = 33u;
+	alignas(32) Matrix44 parents[count];
+	alignas(32) Matrix44 locals[count];
+	alignas(32) Matrix44 results[count];
+	Matrix44 expected[count];
+
+	for (uint32_t i = 0u; i < count; ++i)
+	{
+		parents[i] = CreateRandomMatrix();
+		locals[i] = CreateRandomMatrix();
+		expected[i] = parents[i] * locals[i];
+	}
+
+	auto requireExpected = [&expected](const Matrix44* someResults, uint32_t aFirst)
+	{
+		for (uint32_t i = aFirst; i < count; ++i)
+		{
+			for (unsigned int row = 0u; row < 4u; ++row)
+			{
+				for (unsigned int column = 0u; column < 4u; ++column)
+					REQUIRE(someResults[i][row][column] == Approx(expected[i][row][column]).margin(1e-5f));
+			}
+		}
+	};
+
+	Matrix44::MultiplyBatchAligned(parents, locals, results, count);
+	requireExpected(results, 0u);
+
+	// Odd start so the arrays are only 16 byte aligned
+	Matrix44::MultiplyBatch(parents + 1, locals + 1, results + 1, count - 1u);
+	requireExpected(results, 1u);
+
+	// Written over the local matrices
+	Matrix44::MultiplyBatch(parents, locals, locals, count);
+	requireExpected(locals, 0u);
+}
+
+TEST_CASE("Matrix44_CanTranspose", "[Math], [Matrix44]")
+{
+	Matrix44 matrix = CreateRandomMatrix();
+	Matrix44 transposed = matrix.Transpose();
+
+	for (unsigned int i = 0u; i < 4u; ++i)
+	{
+		for (unsigned int j = 0u; j < 4u; ++j)
+			REQUIRE(transposed[i][j] == matrix[j][i]);
+	}
+}
+
+TEST_CASE("Matrix44_CanInvert", "[Math], [Matrix44]")
+{
+	Matrix44 matrix{ 2.0f, 0.0f, 0.0f, 0.0f,
+									 0.0f, 4.0f, 0.0f, 0.0f,
+									 0.0f, 0.0f, 8.0f, 0.0f,
+									 1.0f, 2.0f, 3.0f, 1.0f };
+	Matrix44 inverse = matrix.Inverse();
+
+	REQUIRE(inverse.myXAxis.x == Approx(0.5f));
+	REQUIRE(inverse.myYAxis.y == Approx(0.25f));
+	REQUIRE(inverse.myZAxis.z == Approx(0.125f));
+	REQUIRE(inverse.myPosition.x == Approx(-0.5f));
+	REQUIRE(inverse.myPosition.y == Approx(-0.5f));
+	REQUIRE(inverse.myPosition.z == Approx(-0.375f));
+	REQUIRE(inverse.myPosition.w == Approx(1.0f));
+	RequireReferenceInverse(matrix, inverse);
+
+	Matrix44 perspective = Matrix44::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+	RequireReferenceInverse(perspective, perspective.Inverse());
+}
+
+TEST_CASE("Matrix44_CanInvert_StressTest", "[Math], [Matrix44], [StressTest]")
+{
+	for (int i = 0; i < locStressTestCount; ++i)
+	{
+		Matrix44 matrix = CreateInvertibleMatrix();
+		RequireReferenceInverse(matrix, matrix.Inverse());
+	}
+}
+
+TEST_CASE("Matrix44_CanInvertRigidAndAffine_StressTest", "[Math], [Matrix44], [StressTest]")
+{
+	for (int i = 0; i < locStressTestCount; ++i)
+	{
+		Matrix44 rigid = CreateRigidMatrix();
+		RequireReferenceInverse(rigid, rigid.InverseRigid());
+		RequireReferenceInverse(rigid, rigid.InverseAffine());
+
+		Matrix44 affine = rigid * Matrix44::Scale(RandomFloat() + 2.0f, RandomFloat() + 2.0f, -RandomFloat() - 2.0f);
+		RequireReferenceInverse(affine, affine.InverseAffine());
+	}
+}
@@ -0,0 +1,302 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch/catch.hpp>
+
+#include "Memory/AllocationTracker.h"
+#include "Memory/ConcurrentMemoryPage.h"
+#include "Memory/MemoryPage.h"
+#include "Memory/PoolAllocator.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+	static constexpr uint32_t locPageSize = 64u << 20;
+	static constexpr uint32_t locFragmentSize = 64u;
+	static constexpr uint32_t locFragmentCount = 4096u;
+	static constexpr uint32_t locAllocationSize = 256u;
+
+	// Leaves locFragmentCount free blocks too small for locAllocationSize in front of the rest of the page
+	dbz::MemoryPage CreateFragmentedPage(dbz::MemoryPage::SelectionMethod aSelectionMethod)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(locPageSize, aSelectionMethod);
+
+		std::vector<uint32_t> offsets;
+		for (uint32_t i = 0; i < 2 * locFragmentCount; ++i)
+			offsets.push_back(page.Allocate(locFragmentSize));
+
+		for (uint32_t i = 0; i < offsets.size(); i += 2)
+			page.Free(offsets[i]);
+
+		return page;
+	}
+
+	static constexpr uint32_t locParticleCount = 10000u;
+
+	struct Particle
+	{
+		Particle(float aLifeTime)
+			: myLifeTime(aLifeTime)
+		{ }
+
+		float myPosition[3] = {};
+		float myVelocity[3] = {};
+		float myLifeTime;
+	};
+
+	static constexpr uint32_t locMaxThreadCount = 16u;
+	static constexpr uint32_t locOperationsPerThread = 200000u;
+	static constexpr uint32_t locLiveAllocationsPerThread = 256u;
+
+	// Each thread keeps a window of live small allocations, replacing one per iteration. One in eight
+	// frees is handed to the next thread, so cross thread frees are part of the measurement.
+	// Returns allocate and free pairs per second
+	template <typename ALLOCATE_FN, typename FREE_FN>
+	double RunThreads(uint32_t aThreadCount, ALLOCATE_FN anAllocateFn, FREE_FN aFreeFn)
+	{
+		std::vector<std::vector<uint32_t>> handedOffsets(aThreadCount);
+		std::vector<std::mutex> handedOffsetMutexes(aThreadCount);
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0u; t < aThreadCount; ++t)
+		{
+			threads.emplace_back([&, t]()
+			{
+				std::vector<uint32_t> offsets(locLiveAllocationsPerThread);
+				uint32_t random = t + 1u;
+				for (uint32_t& offset : offsets)
+					offset = anAllocateFn(t, 16u + (random = random * 1664525u + 1013904223u) % 496u);
+
+				std::vector<uint32_t> received;
+				for (uint32_t i = 0u; i < locOperationsPerThread; ++i)
+				{
+					random = random * 1664525u + 1013904223u;
+					uint32_t& offset = offsets[i % locLiveAllocationsPerThread];
+
+					if ((random >> 29u) == 0u && aThreadCount > 1u)
+					{
+						uint32_t nextThread = (t + 1u) % aThreadCount;
+						std::lock_guard<std::mutex> lock(handedOffsetMutexes[nextThread]);
+						handedOffsets[nextThread].push_back(offset);
+					}
+					else
+					{
+						aFreeFn(t, offset);
+					}
+
+					offset = anAllocateFn(t, 16u + random % 496u);
+
+					if ((i & 1023u) == 0u)
+					{
+						{
+							std::lock_guard<std::mutex> lock(handedOffsetMutexes[t]);
+							received.swap(handedOffsets[t]);
+						}
+						for (uint32_t receivedOffset : received)
+							aFreeFn(t, receivedOffset);
+						received.clear();
+					}
+				}
+
+				for (uint32_t offset : offsets)
+					aFreeFn(t, offset);
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		// Offsets handed over after the last check, not part of the measurement
+		for (uint32_t t = 0u; t < aThreadCount; ++t)
+		{
+			for (uint32_t offset : handedOffsets[t])
+				aFreeFn(t, offset);
+		}
+
+		return aThreadCount * static_cast<double>(locOperationsPerThread) / seconds;
+	}
+}
+
+// Hidden by default, run with [Benchmark]
+TEST_CASE("MemoryPage_AllocateFreeOnFragmentedPage_Benchmark", "[.], [Memory], [MemoryPage], [Benchmark]")
+{
+	dbz::MemoryPage firstFitPage = CreateFragmentedPage(dbz::MemoryPage::SelectionMethod::FIRST_FIT);
+	dbz::MemoryPage bestFitPage = CreateFragmentedPage(dbz::MemoryPage::SelectionMethod::BEST_FIT);
+	dbz::MemoryPage tlsfPage = CreateFragmentedPage(dbz::MemoryPage::SelectionMethod::TLSF);
+	dbz::MemoryPage buddyPage = CreateFragmentedPage(dbz::MemoryPage::SelectionMethod::BUDDY);
+
+	BENCHMARK("FirstFit")
+	{
+		uint32_t offset = firstFitPage.Allocate(locAllocationSize);
+		firstFitPage.Free(offset);
+		return offset;
+	};
+
+	BENCHMARK("BestFit")
+	{
+		uint32_t offset = bestFitPage.Allocate(locAllocationSize);
+		bestFitPage.Free(offset);
+		return offset;
+	};
+
+	BENCHMARK("TLSF")
+	{
+		uint32_t offset = tlsfPage.Allocate(locAllocationSize);
+		tlsfPage.Free(offset);
+		return offset;
+	};
+
+	BENCHMARK("Buddy")
+	{
+		uint32_t offset = buddyPage.Allocate(locAllocationSize);
+		buddyPage.Free(offset);
+		return offset;
+	};
+
+	dbz::MemoryPage::Destroy(firstFitPage);
+	dbz::MemoryPage::Destroy(bestFitPage);
+	dbz::MemoryPage::Destroy(tlsfPage);
+	dbz::MemoryPage::Destroy(buddyPage);
+}
+
+TEST_CASE("MemoryPage_AllocateFreeBatch_Benchmark", "[.], [Memory], [MemoryPage], [Benchmark]")
+{
+	constexpr uint32_t batchSize = 64u;
+	dbz::MemoryPage singlePage = CreateFragmentedPage(dbz::MemoryPage::SelectionMethod::TLSF);
+	dbz::MemoryPage batchPage = CreateFragmentedPage(dbz::MemoryPage::SelectionMethod::TLSF);
+	uint32_t offsets[batchSize];
+
+	BENCHMARK("Single")
+	{
+		for (uint32_t& offset : offsets)
+			offset = singlePage.Allocate(locAllocationSize);
+		for (uint32_t offset : offsets)
+			singlePage.Free(offset);
+		return offsets[0];
+	};
+
+	BENCHMARK("Batch")
+	{
+		batchPage.AllocateBatch(locAllocationSize, batchSize, offsets);
+		batchPage.FreeBatch(offsets, batchSize);
+		return offsets[0];
+	};
+
+	dbz::MemoryPage::Destroy(singlePage);
+	dbz::MemoryPage::Destroy(batchPage);
+}
+
+// Tracking compiled in but disabled should stay close to the untracked page
+TEST_CASE("MemoryPage_AllocationTrackingOverhead_Benchmark", "[.], [Memory], [MemoryPage], [AllocationTracker], [Benchmark]")
+{
+	dbz::AllocationTracker tracker = dbz::AllocationTracker::Create();
+	dbz::MemoryPage untrackedPage = CreateFragmentedPage(dbz::MemoryPage::SelectionMethod::TLSF);
+	dbz::MemoryPage disabledPage = CreateFragmentedPage(dbz::MemoryPage::SelectionMethod::TLSF);
+	disabledPage.SetAllocationTracker(&tracker, "Benchmark");
+
+	BENCHMARK("Untracked")
+	{
+		uint32_t offset = untrackedPage.Allocate(locAllocationSize);
+		untrackedPage.Free(offset);
+		return offset;
+	};
+
+	BENCHMARK("TrackerDisabled")
+	{
+		uint32_t offset = disabledPage.Allocate(locAllocationSize);
+		disabledPage.Free(offset);
+		return offset;
+	};
+
+	tracker.SetEnabled(true);
+	BENCHMARK("TrackerEnabled")
+	{
+		uint32_t offset = disabledPage.Allocate(locAllocationSize);
+		disabledPage.Free(offset);
+		return offset;
+	};
+
+	dbz::MemoryPage::Destroy(untrackedPage);
+	dbz::MemoryPage::Destroy(disabledPage);
+	dbz::AllocationTracker::Destroy(tracker);
+}
+
+TEST_CASE("PoolAllocator_SpawnAndKillParticles_Benchmark", "[.], [Memory], [PoolAllocator], [Benchmark]")
+{
+	dbz::PoolAllocator<Particle> pool = dbz::PoolAllocator<Particle>::Create(1024u);
+	std::vector<Particle*> particles(locParticleCount);
+
+	BENCHMARK("NewDelete")
+	{
+		for (Particle*& particle : particles)
+			particle = new Particle(1.0f);
+
+		for (Particle* particle : particles)
+			delete particle;
+
+		return particles.back();
+	};
+
+	BENCHMARK("PoolAllocator")
+	{
+		for (Particle*& particle : particles)
+			particle = pool.Construct(1.0f);
+
+		for (Particle* particle : particles)
+			pool.Destruct(particle);
+
+		return particles.back();
+	};
+
+	BENCHMARK("PoolAllocatorBatch")
+	{
+		pool.ConstructBatch(particles.data(), locParticleCount, 1.0f);
+		pool.DestructBatch(particles.data(), locParticleCount);
+
+		return particles.back();
+	};
+
+	dbz::PoolAllocator<Particle>::Destroy(pool);
+}
+
+// Not a Catch benchmark, those run on a single thread. Prints throughput per thread count.
+// Scaling up to locMaxThreadCount threads has only been run on a single core machine so far, so it is unverified
+TEST_CASE("ConcurrentMemoryPage_ThreadScaling_Benchmark", "[.], [Memory], [ConcurrentMemoryPage], [Benchmark]")
+{
+	std::cout << std::left << std::setw(10) << "Threads" << std::right << std::setw(20) << "Locked (ops/s)" << std::setw(20) << "Concurrent (ops/s)" << std::setw(12) << "Scaling" << "\n";
+
+	double singleThreadConcurrent = 0.0;
+	for (uint32_t threadCount = 1u; threadCount <= locMaxThreadCount; threadCount *= 2u)
+	{
+		dbz::MemoryPage lockedPage = dbz::MemoryPage::Create(locPageSize, dbz::MemoryPage::SelectionMethod::TLSF);
+		std::mutex lockedPageMutex;
+		double locked = RunThreads(threadCount,
+			[&](uint32_t, uint32_t aSize) { std::lock_guard<std::mutex> lock(lockedPageMutex); return lockedPage.Allocate(aSize); },
+			[&](uint32_t, uint32_t anOffset) { std::lock_guard<std::mutex> lock(lockedPageMutex); lockedPage.Free(anOffset); });
+		dbz::MemoryPage::Destroy(lockedPage);
+
+		dbz::ConcurrentMemoryPage concurrentPage = dbz::ConcurrentMemoryPage::Create(locPageSize);
+		std::vector<dbz::ConcurrentMemoryPage::ThreadCache*> caches(threadCount);
+		for (dbz::ConcurrentMemoryPage::ThreadCache*& cache : caches)
+			cache = concurrentPage.AcquireThreadCache();
+
+		double concurrent = RunThreads(threadCount,
+			[&](uint32_t aThread, uint32_t aSize) { return concurrentPage.Allocate(*caches[aThread], aSize); },
+			[&](uint32_t aThread, uint32_t anOffset) { concurrentPage.Free(*caches[aThread], anOffset); });
+
+		for (dbz::ConcurrentMemoryPage::ThreadCache* cache : caches)
+			concurrentPage.ReleaseThreadCache(*cache);
+		dbz::ConcurrentMemoryPage::Destroy(concurrentPage);
+
+		singleThreadConcurrent = threadCount == 1u ? concurrent : singleThreadConcurrent;
+		std::cout << std::left << std::setw(10) << threadCount << std::right << std::fixed << std::setprecision(0)
+			<< std::setw(20) << locked << std::setw(20) << concurrent << std::setw(11) << std::setprecision(2) << concurrent / singleThreadConcurrent << "x\n";
+	}
+}
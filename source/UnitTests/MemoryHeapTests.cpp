@@ -0,0 +1,187 @@
+#include <catch/catch.hpp>
+
+#include "Memory/MemoryHeap.h"
+
+#define DBZ_KB (1 << 10)
+#define DBZ_MB (1 << 20)
+#define DBZ_GB (1 << 30)
+
+TEST_CASE("MemoryHeap_HeapLifeTimeManagedThroughStaticFunctions", "[Memory], [MemoryHeap]")
+{
+	dbz::MemoryHeap heap = dbz::MemoryHeap::Create(DBZ_MB, 60u);
+	dbz::MemoryHeap::Destroy(heap);
+}
+
+TEST_CASE("MemoryHeap_CreatesPagesOnDemand", "[Memory], [MemoryHeap]")
+{
+	dbz::MemoryHeap heap = dbz::MemoryHeap::Create(4 * DBZ_KB, 60u);
+	REQUIRE(heap.GetPageCount() == 0u);
+
+	dbz::MemoryHeap::Handle handle = heap.Allocate(3 * DBZ_KB);
+	dbz::MemoryHeap::Handle handle2 = heap.Allocate(3 * DBZ_KB);
+	REQUIRE(heap.GetPageCount() == 2u);
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(handle) == 0u);
+	REQUIRE(dbz::MemoryHeap::GetOffset(handle) == 0u);
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(handle2) == 1u);
+	REQUIRE(dbz::MemoryHeap::GetOffset(handle2) == 0u);
+
+	// Invalid requests do not create pages
+	REQUIRE(heap.Allocate(8 * DBZ_KB) == dbz::MemoryHeap::ourInvalidHandle);
+	REQUIRE(heap.Allocate(0u) == dbz::MemoryHeap::ourInvalidHandle);
+	REQUIRE(heap.Allocate(DBZ_KB, 3u) == dbz::MemoryHeap::ourInvalidHandle);
+	REQUIRE(heap.GetPageCount() == 2u);
+
+	REQUIRE(heap.Free(handle));
+	REQUIRE(heap.Free(handle2));
+
+	dbz::MemoryHeap::Destroy(heap);
+}
+
+TEST_CASE("MemoryHeap_GrowsPastASinglePageRange", "[Memory], [MemoryHeap]")
+{
+	dbz::MemoryHeap heap = dbz::MemoryHeap::Create(3u * DBZ_GB, 60u);
+
+	dbz::MemoryHeap::Handle handles[3];
+	for (dbz::MemoryHeap::Handle& handle : handles)
+		handle = heap.Allocate(2u * DBZ_GB);
+
+	REQUIRE(heap.GetPageCount() == 3u);
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		REQUIRE(dbz::MemoryHeap::GetPageIndex(handles[i]) == i);
+		REQUIRE(heap.Free(handles[i]));
+	}
+
+	dbz::MemoryHeap::Destroy(heap);
+}
+
+TEST_CASE("MemoryHeap_AllocatesFromPageWithSmallestFittingBlock", "[Memory], [MemoryHeap]")
+{
+	dbz::MemoryHeap heap = dbz::MemoryHeap::Create(4 * DBZ_KB, 60u, dbz::MemoryPage::SelectionMethod::FIRST_FIT);
+
+	// First page ends up with 1KB free, second one with 2KB
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(heap.Allocate(3 * DBZ_KB)) == 0u);
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(heap.Allocate(2 * DBZ_KB)) == 1u);
+
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(heap.Allocate(DBZ_KB)) == 0u);
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(heap.Allocate(2 * DBZ_KB)) == 1u);
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(heap.Allocate(DBZ_KB)) == 2u);
+
+	dbz::MemoryHeap::Destroy(heap);
+}
+
+TEST_CASE("MemoryHeap_PageAlignedAllocationsReuseEmptyPages", "[Memory], [MemoryHeap]")
+{
+	dbz::MemoryHeap heap = dbz::MemoryHeap::Create(4 * DBZ_KB, 60u);
+
+	dbz::MemoryHeap::Handle handle = heap.Allocate(4 * DBZ_KB, 4 * DBZ_KB);
+	REQUIRE(handle != dbz::MemoryHeap::ourInvalidHandle);
+	REQUIRE(heap.Free(handle));
+
+	// Padding can not exceed the room left in the page
+	handle = heap.Allocate(4 * DBZ_KB, 4 * DBZ_KB);
+	dbz::MemoryHeap::Handle handle2 = heap.Allocate(2 * DBZ_KB, 4 * DBZ_KB);
+	REQUIRE(heap.GetPageCount() == 2u);
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(handle) == 0u);
+	REQUIRE(dbz::MemoryHeap::GetOffset(handle2) == 0u);
+	REQUIRE(heap.Free(handle));
+	REQUIRE(heap.Free(handle2));
+
+	handle = heap.Allocate(3 * DBZ_KB, 2 * DBZ_KB);
+	handle2 = heap.Allocate(3 * DBZ_KB, 2 * DBZ_KB);
+	REQUIRE(heap.GetPageCount() == 2u);
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(handle) != dbz::MemoryHeap::GetPageIndex(handle2));
+	REQUIRE(heap.Free(handle));
+	REQUIRE(heap.Free(handle2));
+
+	dbz::MemoryHeap::Destroy(heap);
+}
+
+TEST_CASE("MemoryHeap_FreeFailsForHandlesNotAllocated", "[Memory], [MemoryHeap]")
+{
+	dbz::MemoryHeap heap = dbz::MemoryHeap::Create(4 * DBZ_KB, 60u);
+
+	REQUIRE(heap.Free(0u) == false);
+	REQUIRE(heap.Free(dbz::MemoryHeap::ourInvalidHandle) == false);
+
+	dbz::MemoryHeap::Handle handle = heap.Allocate(DBZ_KB);
+	REQUIRE(heap.Free(handle + 1u) == false);
+	REQUIRE(heap.Free(handle + (1ull << 32u)) == false);
+	REQUIRE(heap.Free(handle));
+	REQUIRE(heap.Free(handle) == false);
+
+	dbz::MemoryHeap::Destroy(heap);
+}
+
+TEST_CASE("MemoryHeap_EmptyPagesAreReleasedAfterDelay", "[Memory], [MemoryHeap]")
+{
+	dbz::MemoryHeap heap = dbz::MemoryHeap::Create(4 * DBZ_KB, 3u);
+
+	dbz::MemoryHeap::Handle handle = heap.Allocate(3 * DBZ_KB);
+	dbz::MemoryHeap::Handle handle2 = heap.Allocate(3 * DBZ_KB);
+	REQUIRE(heap.Free(handle2));
+
+	heap.Update();
+	heap.Update();
+	REQUIRE(heap.GetPageCount() == 2u);
+
+	// Allocating into an empty page restarts its delay
+	handle2 = heap.Allocate(3 * DBZ_KB);
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(handle2) == 1u);
+	REQUIRE(heap.Free(handle2));
+
+	heap.Update();
+	heap.Update();
+	REQUIRE(heap.GetPageCount() == 2u);
+	heap.Update();
+	REQUIRE(heap.GetPageCount() == 1u);
+	REQUIRE(heap.Free(handle2) == false);
+
+	// Released page index is reused
+	handle2 = heap.Allocate(3 * DBZ_KB);
+	REQUIRE(dbz::MemoryHeap::GetPageIndex(handle2) == 1u);
+	REQUIRE(heap.GetPageCount() == 2u);
+
+	REQUIRE(heap.Free(handle));
+	REQUIRE(heap.Free(handle2));
+
+	dbz::MemoryHeap::Destroy(heap);
+}
+
+TEST_CASE("MemoryHeap_AllocationDeallocation_StressTest", "[Memory], [MemoryHeap], [StressTest]")
+{
+	dbz::MemoryHeap heap = dbz::MemoryHeap::Create(256 * DBZ_KB, 10u);
+
+	std::vector<dbz::MemoryHeap::Handle> handles;
+	for (int i = 0; i < 100000; ++i)
+	{
+		if (handles.empty() || rand() % 2)
+		{
+			uint32_t size = static_cast<uint32_t>(rand()) % (4 * DBZ_KB) + 1u;
+			uint32_t alignment = 1u << (static_cast<uint32_t>(rand()) % 9u);
+			dbz::MemoryHeap::Handle handle = heap.Allocate(size, alignment);
+			REQUIRE(handle != dbz::MemoryHeap::ourInvalidHandle);
+			REQUIRE(dbz::MemoryHeap::GetOffset(handle) % alignment == 0u);
+			handles.push_back(handle);
+		}
+		else
+		{
+			uint32_t index = static_cast<uint32_t>(rand()) % handles.size();
+			REQUIRE(heap.Free(handles[index]));
+			handles[index] = handles.back();
+			handles.pop_back();
+		}
+
+		if (i % 100 == 0)
+			heap.Update();
+	}
+
+	for (dbz::MemoryHeap::Handle handle : handles)
+		REQUIRE(heap.Free(handle));
+
+	for (int i = 0; i < 10; ++i)
+		heap.Update();
+	REQUIRE(heap.GetPageCount() == 0u);
+
+	dbz::MemoryHeap::Destroy(heap);
+}
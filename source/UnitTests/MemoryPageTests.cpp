@@ -2,6 +2,11 @@
 
 #include "Memory/MemoryPage.h"
 
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
 #define DBZ_KB (1 << 10)
 #define DBZ_MB (1 << 20)
 #define DBZ_GB (1 << 30)
@@ -12,6 +17,24 @@ TEST_CASE("MemoryPage_PageLifeTimeManagedThroughStaticFunctions", "[Memory], [Me
 	dbz::MemoryPage::Destroy(page);
 }
 
+TEST_CASE("MemoryPage_EmptyPagesFailAllocations", "[Memory], [MemoryPage]")
+{
+	const dbz::MemoryPage::SelectionMethod selectionMethods[] = { dbz::MemoryPage::SelectionMethod::FIRST_FIT, dbz::MemoryPage::SelectionMethod::BEST_FIT,
+		dbz::MemoryPage::SelectionMethod::TLSF, dbz::MemoryPage::SelectionMethod::BUDDY };
+	for (dbz::MemoryPage::SelectionMethod selectionMethod : selectionMethods)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(0u, selectionMethod);
+		REQUIRE(page.Allocate(1u) == UINT32_MAX);
+		REQUIRE(page.Free(0u) == false);
+
+		dbz::MemoryPageStats stats = page.GetStats();
+		REQUIRE(stats.myFreeBytes == 0u);
+		REQUIRE(stats.myFreeBlockCount == 0u);
+		REQUIRE(stats.myLargestFreeBlockSize == 0u);
+		dbz::MemoryPage::Destroy(page);
+	}
+}
+
 TEST_CASE("MemoryPage_CanAllocateMemory", "[Memory], [MemoryPage]")
 {
 	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
@@ -80,6 +103,56 @@ TEST_CASE("MemoryPage_AdjacedBlocksWhenFreedAreMerged_2", "[Memory], [MemoryPage
 	dbz::MemoryPage::Destroy(page);
 }
 
+TEST_CASE("MemoryPage_FreeFailsForOffsetsNotAllocated", "[Memory], [MemoryPage]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+
+	uint32_t allocationOffset = page.Allocate(DBZ_KB);
+	uint32_t allocationOffset2 = page.Allocate(DBZ_KB);
+
+	REQUIRE(page.Free(allocationOffset + 1u) == false);
+	REQUIRE(page.Free(DBZ_MB) == false);
+	REQUIRE(page.Free(allocationOffset2));
+	REQUIRE(page.Free(allocationOffset2) == false);
+	REQUIRE(page.Free(allocationOffset));
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_AllocationSizeIsKnownFromOffset", "[Memory], [MemoryPage]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+
+	uint32_t allocationOffset = page.Allocate(DBZ_KB);
+	uint32_t allocationOffset2 = page.Allocate(100u, 256u);
+
+	REQUIRE(page.GetAllocationSize(allocationOffset) == DBZ_KB);
+	REQUIRE(page.GetAllocationSize(allocationOffset2) == 100u);
+	REQUIRE(page.GetAllocationSize(allocationOffset + 1u) == 0u);
+
+	REQUIRE(page.Free(allocationOffset));
+	REQUIRE(page.GetAllocationSize(allocationOffset) == 0u);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_FreeInAllocationOrderMergesWholePage", "[Memory], [MemoryPage], [StressTest]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB, dbz::MemoryPage::SelectionMethod::BEST_FIT);
+
+	std::vector<uint32_t> offsets;
+	for (uint32_t i = 0; i < DBZ_MB / 16; ++i)
+		offsets.push_back(page.Allocate(16));
+	REQUIRE(page.Allocate(1) == UINT32_MAX);
+
+	for (uint32_t offset : offsets)
+		REQUIRE(page.Free(offset));
+
+	REQUIRE(page.Allocate(DBZ_MB) == 0u);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
 TEST_CASE("MemoryPage_AllocationDeallocation_StressTest", "[Memory], [MemoryPage], [StressTest]")
 {
 	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_GB);
@@ -149,3 +222,714 @@ TEST_CASE("MemoryPage_BestFitAllocatesFromSmallestAvailableBlock", "[Memory], [M
 
 	dbz::MemoryPage::Destroy(page);
 }
+
+TEST_CASE("MemoryPage_TLSFCanAllocateAndFreeMemory", "[Memory], [MemoryPage]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB, dbz::MemoryPage::SelectionMethod::TLSF);
+
+	uint32_t allocationOffset = page.Allocate(DBZ_KB);
+	uint32_t allocationOffset2 = page.Allocate(DBZ_KB);
+	REQUIRE(allocationOffset == 0u);
+	REQUIRE(allocationOffset2 == DBZ_KB);
+
+	REQUIRE(page.Free(allocationOffset));
+	REQUIRE(page.Free(allocationOffset2));
+	REQUIRE(page.Free(allocationOffset2) == false);
+
+	// Whole page is a single block again
+	allocationOffset = page.Allocate(DBZ_MB);
+	REQUIRE(allocationOffset == 0u);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_TLSFServesBigAlignmentsOutsideTheClassLookup", "[Memory], [MemoryPage]")
+{
+	// Size plus worst case padding is bigger than the page, the block is still found
+	dbz::MemoryPage page = dbz::MemoryPage::Create(64 * DBZ_KB, dbz::MemoryPage::SelectionMethod::TLSF);
+	REQUIRE(page.Allocate(64 * DBZ_KB, 64 * DBZ_KB) == 0u);
+	REQUIRE(page.Free(0u));
+	dbz::MemoryPage::Destroy(page);
+
+	// Holes of a class below the rounded request are not searched for unaligned requests
+	page = dbz::MemoryPage::Create(100u * 1016u + 4u * DBZ_KB, dbz::MemoryPage::SelectionMethod::TLSF);
+	std::vector<uint32_t> offsets;
+	for (uint32_t i = 0; i < 100u; ++i)
+	{
+		offsets.push_back(page.Allocate(1000u));
+		REQUIRE(page.Allocate(16u) != UINT32_MAX);
+	}
+	REQUIRE(page.Allocate(4u * DBZ_KB) != UINT32_MAX);
+
+	for (uint32_t offset : offsets)
+		REQUIRE(page.Free(offset));
+
+	REQUIRE(page.Allocate(1010u) == UINT32_MAX);
+	REQUIRE(page.Allocate(1000u, 8u) == UINT32_MAX);
+	REQUIRE(page.Allocate(900u, 8u) != UINT32_MAX);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_TLSFAdjacedBlocksWhenFreedAreMerged", "[Memory], [MemoryPage]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(4 * DBZ_KB, dbz::MemoryPage::SelectionMethod::TLSF);
+
+	uint32_t allocationOffset = page.Allocate(DBZ_KB);
+	uint32_t allocationOffset2 = page.Allocate(DBZ_KB);
+	uint32_t allocationOffset3 = page.Allocate(DBZ_KB);
+	uint32_t allocationOffset4 = page.Allocate(DBZ_KB);
+	REQUIRE(allocationOffset3 == 2 * DBZ_KB);
+	REQUIRE(page.Allocate(1u) == UINT32_MAX);
+
+	page.Free(allocationOffset);
+	page.Free(allocationOffset3);
+	page.Free(allocationOffset2);
+
+	allocationOffset = page.Allocate(3 * DBZ_KB);
+	REQUIRE(allocationOffset == 0u);
+
+	page.Free(allocationOffset);
+	page.Free(allocationOffset4);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_TLSFReusesFreedBlocksOfTheSameClass", "[Memory], [MemoryPage]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB, dbz::MemoryPage::SelectionMethod::TLSF);
+
+	uint32_t allocationOffsets[8];
+	for (uint32_t& allocationOffset : allocationOffsets)
+		allocationOffset = page.Allocate(DBZ_KB);
+
+	page.Free(allocationOffsets[3]);
+	REQUIRE(page.Allocate(DBZ_KB) == allocationOffsets[3]);
+	REQUIRE(page.Allocate(0u) == UINT32_MAX);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_TLSFAllocationDeallocation_StressTest", "[Memory], [MemoryPage], [StressTest]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_GB, dbz::MemoryPage::SelectionMethod::TLSF);
+
+	std::vector<uint32_t> offsets;
+
+	do
+	{
+		uint32_t size = static_cast<uint32_t>(rand()) % DBZ_KB;
+		offsets.push_back(page.Allocate(size + 1));
+	} while (offsets.back() != UINT32_MAX);
+	offsets.pop_back();
+
+	while (offsets.empty() == false)
+	{
+		uint32_t index = static_cast<uint32_t>(rand()) % offsets.size();
+		REQUIRE(page.Free(offsets[index]));
+		offsets[index] = offsets.back();
+		offsets.pop_back();
+	}
+
+	// Everything got merged back
+	REQUIRE(page.Allocate(DBZ_GB) == 0u);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_BuddyCanAllocateAndFreeMemory", "[Memory], [MemoryPage]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB, dbz::MemoryPage::SelectionMethod::BUDDY);
+
+	uint32_t allocationOffset = page.Allocate(DBZ_KB);
+	uint32_t allocationOffset2 = page.Allocate(DBZ_KB + 1u);
+	REQUIRE(allocationOffset == 0u);
+	REQUIRE(allocationOffset2 == 2 * DBZ_KB);
+
+	REQUIRE(page.Free(allocationOffset));
+	REQUIRE(page.Free(allocationOffset2));
+	REQUIRE(page.Free(allocationOffset2) == false);
+
+	REQUIRE(page.Allocate(DBZ_MB) == 0u);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_CanAllocateAlignedMemory", "[Memory], [MemoryPage]")
+{
+	const dbz::MemoryPage::SelectionMethod selectionMethods[] =
+	{
+		dbz::MemoryPage::SelectionMethod::FIRST_FIT,
+		dbz::MemoryPage::SelectionMethod::BEST_FIT,
+		dbz::MemoryPage::SelectionMethod::TLSF
+	};
+
+	for (dbz::MemoryPage::SelectionMethod selectionMethod : selectionMethods)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB, selectionMethod);
+
+		uint32_t allocationOffset = page.Allocate(1u);
+		uint32_t alignedAllocationOffset = page.Allocate(DBZ_KB, 256u);
+		REQUIRE(allocationOffset == 0u);
+		REQUIRE(alignedAllocationOffset == 256u);
+
+		// Padding went back to the page
+		uint32_t paddingAllocationOffset = page.Allocate(200u);
+		REQUIRE(paddingAllocationOffset == 1u);
+
+		REQUIRE(page.Allocate(DBZ_KB, 3u) == UINT32_MAX);
+		REQUIRE(page.Allocate(DBZ_KB, 0u) == UINT32_MAX);
+
+		page.Free(allocationOffset);
+		page.Free(paddingAllocationOffset);
+		page.Free(alignedAllocationOffset);
+		REQUIRE(page.Allocate(DBZ_MB) == 0u);
+
+		dbz::MemoryPage::Destroy(page);
+	}
+}
+
+TEST_CASE("MemoryPage_AlignedAllocationDeallocation_StressTest", "[Memory], [MemoryPage], [StressTest]")
+{
+	const dbz::MemoryPage::SelectionMethod selectionMethods[] =
+	{
+		dbz::MemoryPage::SelectionMethod::FIRST_FIT,
+		dbz::MemoryPage::SelectionMethod::BEST_FIT,
+		dbz::MemoryPage::SelectionMethod::TLSF
+	};
+
+	for (dbz::MemoryPage::SelectionMethod selectionMethod : selectionMethods)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(4 * DBZ_MB, selectionMethod);
+
+		std::vector<uint32_t> offsets;
+		for (int i = 0; i < 10000; ++i)
+		{
+			uint32_t size = static_cast<uint32_t>(rand()) % DBZ_KB + 1u;
+			uint32_t alignment = 1u << (static_cast<uint32_t>(rand()) % 9u);
+			uint32_t offset = page.Allocate(size, alignment);
+			REQUIRE(offset != UINT32_MAX);
+			REQUIRE(offset % alignment == 0u);
+			offsets.push_back(offset);
+
+			// Keep some churn going so padding blocks get reused
+			if (rand() % 2)
+			{
+				uint32_t index = static_cast<uint32_t>(rand()) % offsets.size();
+				REQUIRE(page.Free(offsets[index]));
+				offsets[index] = offsets.back();
+				offsets.pop_back();
+			}
+		}
+
+		for (uint32_t offset : offsets)
+			REQUIRE(page.Free(offset));
+
+		REQUIRE(page.Allocate(4 * DBZ_MB) == 0u);
+
+		dbz::MemoryPage::Destroy(page);
+	}
+}
+
+TEST_CASE("MemoryPage_DefragmentMovesInUseBlocksToTheStart", "[Memory], [MemoryPage]")
+{
+	const dbz::MemoryPage::SelectionMethod selectionMethods[] =
+	{
+		dbz::MemoryPage::SelectionMethod::FIRST_FIT,
+		dbz::MemoryPage::SelectionMethod::BEST_FIT,
+		dbz::MemoryPage::SelectionMethod::TLSF
+	};
+
+	for (dbz::MemoryPage::SelectionMethod selectionMethod : selectionMethods)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(8 * DBZ_KB, selectionMethod);
+
+		uint32_t offsets[8];
+		for (uint32_t& offset : offsets)
+			offset = page.Allocate(DBZ_KB);
+
+		for (uint32_t i = 0; i < 8; i += 2)
+			REQUIRE(page.Free(offsets[i]));
+
+		// Holes are too small for a bigger allocation
+		REQUIRE(page.Allocate(2 * DBZ_KB) == UINT32_MAX);
+
+		uint32_t moveCount = 0u;
+		REQUIRE(page.Defragment(UINT32_MAX, [&](uint32_t anOldOffset, uint32_t aNewOffset, uint32_t aSize)
+		{
+			REQUIRE(anOldOffset == offsets[2 * moveCount + 1]);
+			REQUIRE(aNewOffset == moveCount * DBZ_KB);
+			REQUIRE(aSize == DBZ_KB);
+			++moveCount;
+		}));
+		REQUIRE(moveCount == 4u);
+
+		REQUIRE(page.Allocate(4 * DBZ_KB) == 4 * DBZ_KB);
+		REQUIRE(page.Free(4 * DBZ_KB));
+
+		// Blocks are found at their new offsets
+		for (uint32_t i = 0; i < 4; ++i)
+			REQUIRE(page.Free(i * DBZ_KB));
+		REQUIRE(page.Free(offsets[7]) == false);
+
+		REQUIRE(page.Allocate(8 * DBZ_KB) == 0u);
+
+		dbz::MemoryPage::Destroy(page);
+	}
+}
+
+TEST_CASE("MemoryPage_DefragmentRunsIncrementally", "[Memory], [MemoryPage]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB, dbz::MemoryPage::SelectionMethod::TLSF);
+
+	uint32_t offsets[16];
+	for (uint32_t& offset : offsets)
+		offset = page.Allocate(DBZ_KB);
+
+	REQUIRE(page.Free(offsets[0]));
+
+	uint32_t moveCount = 0u;
+	auto relocateCallback = [&moveCount](uint32_t, uint32_t, uint32_t) { ++moveCount; };
+
+	// A step moves blocks until the byte budget is used, and at least one block
+	uint32_t stepCount = 0u;
+	while (page.Defragment(2 * DBZ_KB, relocateCallback) == false)
+		++stepCount;
+
+	REQUIRE(moveCount == 15u);
+	REQUIRE(stepCount == 7u);
+
+	moveCount = 0u;
+	REQUIRE(page.Defragment(1u, relocateCallback));
+	REQUIRE(moveCount == 0u);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_DefragmentWithoutBudgetMovesOneBlockPerStep", "[Memory], [MemoryPage]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB, dbz::MemoryPage::SelectionMethod::TLSF);
+
+	uint32_t offsets[16];
+	for (uint32_t& offset : offsets)
+		offset = page.Allocate(DBZ_KB);
+
+	REQUIRE(page.Free(offsets[0]));
+
+	uint32_t moveCount = 0u;
+	auto relocateCallback = [&moveCount](uint32_t, uint32_t, uint32_t) { ++moveCount; };
+
+	uint32_t stepCount = 0u;
+	while (page.Defragment(0u, relocateCallback) == false)
+	{
+		++stepCount;
+		REQUIRE(moveCount == stepCount);
+	}
+
+	REQUIRE(moveCount == 15u);
+	REQUIRE(stepCount == 15u);
+
+	// Page changes restart the compaction from the first block
+	REQUIRE(page.Free(0u));
+	moveCount = 0u;
+	while (page.Defragment(0u, relocateCallback) == false);
+	REQUIRE(moveCount == 14u);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_DefragmentBoundsVisitedBlocksPerStep", "[Memory], [MemoryPage]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+
+	// Holes in front of the aligned blocks are too small to move them
+	const uint32_t pairCount = 1000u;
+	std::vector<uint32_t> offsets;
+	for (uint32_t i = 0; i < pairCount; ++i)
+	{
+		REQUIRE(page.Allocate(64u, 128u) == 128u * i);
+		offsets.push_back(page.Allocate(64u));
+	}
+	uint32_t lastOffset = page.Allocate(64u);
+
+	for (uint32_t offset : offsets)
+		REQUIRE(page.Free(offset));
+
+	uint32_t newOffset = UINT32_MAX;
+	auto relocateCallback = [&newOffset](uint32_t, uint32_t aNewOffset, uint32_t) { newOffset = aNewOffset; };
+
+	// Each step gives up after a bounded number of blocks and the next one carries on from there
+	REQUIRE(page.Defragment(UINT32_MAX, relocateCallback) == false);
+	REQUIRE(newOffset == UINT32_MAX);
+
+	uint32_t stepCount = 1u;
+	while (page.Defragment(UINT32_MAX, relocateCallback) == false)
+		++stepCount;
+
+	REQUIRE(stepCount >= 2u * pairCount / 256u);
+	REQUIRE(stepCount <= 2u * pairCount / 256u + 1u);
+	REQUIRE(newOffset == lastOffset - 64u);
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_DefragmentKeepsBlocksAligned", "[Memory], [MemoryPage]")
+{
+	dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB);
+
+	uint32_t allocationOffset = page.Allocate(100u);
+	uint32_t allocationOffset2 = page.Allocate(300u);
+	uint32_t alignedAllocationOffset = page.Allocate(DBZ_KB, 256u);
+	REQUIRE(alignedAllocationOffset == 512u);
+
+	REQUIRE(page.Free(allocationOffset));
+	REQUIRE(page.Free(allocationOffset2));
+
+	uint32_t newOffset = UINT32_MAX;
+	REQUIRE(page.Defragment(UINT32_MAX, [&newOffset](uint32_t, uint32_t aNewOffset, uint32_t) { newOffset = aNewOffset; }));
+	REQUIRE(newOffset == 0u);
+
+	// Hole in front of the aligned block is too small to move it, following blocks are still compacted
+	REQUIRE(page.Allocate(76u) == DBZ_KB);
+	REQUIRE(page.Allocate(200u, 512u) == 1536u);
+	uint32_t allocationOffset3 = page.Allocate(500u);
+	REQUIRE(page.Allocate(500u) == allocationOffset3 + 500u);
+	REQUIRE(page.Free(allocationOffset3));
+
+	newOffset = UINT32_MAX;
+	REQUIRE(page.Defragment(UINT32_MAX, [&newOffset](uint32_t, uint32_t aNewOffset, uint32_t) { newOffset = aNewOffset; }));
+	REQUIRE(newOffset == allocationOffset3);
+	REQUIRE(page.Free(1536u));
+
+	dbz::MemoryPage::Destroy(page);
+}
+
+TEST_CASE("MemoryPage_DefragmentKeepsContents_StressTest", "[Memory], [MemoryPage], [StressTest]")
+{
+	const dbz::MemoryPage::SelectionMethod selectionMethods[] =
+	{
+		dbz::MemoryPage::SelectionMethod::FIRST_FIT,
+		dbz::MemoryPage::SelectionMethod::BEST_FIT,
+		dbz::MemoryPage::SelectionMethod::TLSF
+	};
+
+	for (dbz::MemoryPage::SelectionMethod selectionMethod : selectionMethods)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(4 * DBZ_MB, selectionMethod);
+		std::vector<uint8_t> memory(4 * DBZ_MB);
+
+		// Allocation contents are filled with a byte derived from their identifier
+		std::unordered_map<uint32_t, uint32_t> identifiers;
+		auto relocateCallback = [&](uint32_t anOldOffset, uint32_t aNewOffset, uint32_t aSize)
+		{
+			std::memmove(&memory[aNewOffset], &memory[anOldOffset], aSize);
+			identifiers.emplace(aNewOffset, identifiers[anOldOffset]);
+			identifiers.erase(anOldOffset);
+		};
+
+		uint32_t nextIdentifier = 0u;
+		for (int i = 0; i < 5000; ++i)
+		{
+			uint32_t size = static_cast<uint32_t>(rand()) % DBZ_KB + 1u;
+			uint32_t alignment = 1u << (static_cast<uint32_t>(rand()) % 9u);
+			uint32_t offset = page.Allocate(size, alignment);
+			REQUIRE(offset != UINT32_MAX);
+			std::memset(&memory[offset], static_cast<uint8_t>(nextIdentifier), size);
+			identifiers.emplace(offset, nextIdentifier++);
+
+			if (rand() % 2)
+			{
+				auto it = std::next(identifiers.begin(), rand() % identifiers.size());
+				REQUIRE(page.Free(it->first));
+				identifiers.erase(it);
+			}
+
+			if (rand() % 100 == 0)
+				page.Defragment(16 * DBZ_KB, relocateCallback);
+		}
+
+		while (page.Defragment(16 * DBZ_KB, relocateCallback) == false);
+
+		for (const auto& identifier : identifiers)
+			REQUIRE(memory[identifier.first] == static_cast<uint8_t>(identifier.second));
+
+		for (const auto& identifier : identifiers)
+			REQUIRE(page.Free(identifier.first));
+
+		REQUIRE(page.Allocate(4 * DBZ_MB) == 0u);
+
+		dbz::MemoryPage::Destroy(page);
+	}
+}
+
+TEST_CASE("MemoryPage_StatsTrackOccupancyAndFragmentation", "[Memory], [MemoryPage]")
+{
+	const dbz::MemoryPage::SelectionMethod selectionMethods[] =
+	{
+		dbz::MemoryPage::SelectionMethod::FIRST_FIT,
+		dbz::MemoryPage::SelectionMethod::BEST_FIT,
+		dbz::MemoryPage::SelectionMethod::TLSF
+	};
+
+	for (dbz::MemoryPage::SelectionMethod selectionMethod : selectionMethods)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB, selectionMethod);
+
+		dbz::MemoryPageStats stats = page.GetStats();
+		REQUIRE(stats.myInUseBytes == 0u);
+		REQUIRE(stats.myFreeBytes == DBZ_MB);
+		REQUIRE(stats.myLargestFreeBlockSize == DBZ_MB);
+		REQUIRE(stats.myFreeBlockCount == 1u);
+		REQUIRE(stats.myFreeBlockSizeHistogram[20] == 1u);
+
+		uint32_t offsets[4];
+		for (uint32_t& offset : offsets)
+			offset = page.Allocate(DBZ_KB);
+		REQUIRE(page.Free(offsets[0]));
+		REQUIRE(page.Free(offsets[2]));
+		REQUIRE(page.Free(offsets[2]) == false);
+		REQUIRE(page.Allocate(0u) == UINT32_MAX);
+		REQUIRE(page.Allocate(2 * DBZ_MB) == UINT32_MAX);
+
+		stats = page.GetStats();
+		REQUIRE(stats.myInUseBytes == 2 * DBZ_KB);
+		REQUIRE(stats.myFreeBytes == DBZ_MB - 2 * DBZ_KB);
+		REQUIRE(stats.myFreeBlockCount == 3u);
+		REQUIRE(stats.myFreeBlockSizeHistogram[10] == 2u);
+		REQUIRE(stats.myFreeBlockSizeHistogram[19] == 1u);
+		// Rounded down to the size class of the last block
+		REQUIRE(stats.myLargestFreeBlockSize <= DBZ_MB - 4 * DBZ_KB);
+		REQUIRE(stats.myLargestFreeBlockSize >= (DBZ_MB - 4 * DBZ_KB) / 16u * 15u);
+		REQUIRE(stats.myAllocationCount == 4u);
+		REQUIRE(stats.myFailedAllocationCount == 2u);
+		REQUIRE(stats.myFreeCount == 2u);
+		REQUIRE(stats.myFailedFreeCount == 1u);
+
+		REQUIRE(page.Free(offsets[1]));
+		REQUIRE(page.Free(offsets[3]));
+
+		stats = page.GetStats();
+		REQUIRE(stats.myInUseBytes == 0u);
+		REQUIRE(stats.myFreeBytes == DBZ_MB);
+		REQUIRE(stats.myLargestFreeBlockSize == DBZ_MB);
+		REQUIRE(stats.myFreeBlockCount == 1u);
+
+		dbz::MemoryPage::Destroy(page);
+	}
+}
+
+TEST_CASE("MemoryPage_StatsStayConsistent_StressTest", "[Memory], [MemoryPage], [StressTest]")
+{
+	const dbz::MemoryPage::SelectionMethod selectionMethods[] =
+	{
+		dbz::MemoryPage::SelectionMethod::FIRST_FIT,
+		dbz::MemoryPage::SelectionMethod::BEST_FIT,
+		dbz::MemoryPage::SelectionMethod::TLSF,
+		dbz::MemoryPage::SelectionMethod::BUDDY
+	};
+
+	for (dbz::MemoryPage::SelectionMethod selectionMethod : selectionMethods)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(8 * DBZ_MB, selectionMethod);
+
+		std::vector<uint32_t> offsets;
+		for (int i = 0; i < 10000; ++i)
+		{
+			uint32_t size = static_cast<uint32_t>(rand()) % DBZ_KB + 1u;
+			uint32_t alignment = 1u << (static_cast<uint32_t>(rand()) % 9u);
+			offsets.push_back(page.Allocate(size, alignment));
+
+			if (rand() % 2)
+			{
+				uint32_t index = static_cast<uint32_t>(rand()) % offsets.size();
+				page.Free(offsets[index]);
+				offsets[index] = offsets.back();
+				offsets.pop_back();
+			}
+
+			if (i % 1000 == 0 && selectionMethod != dbz::MemoryPage::SelectionMethod::BUDDY)
+				page.Defragment(16 * DBZ_KB, [&offsets](uint32_t anOldOffset, uint32_t aNewOffset, uint32_t)
+				{
+					*std::find(offsets.begin(), offsets.end(), anOldOffset) = aNewOffset;
+				});
+		}
+
+		dbz::MemoryPageStats stats = page.GetStats();
+		REQUIRE(stats.myInUseBytes + stats.myFreeBytes == 8 * DBZ_MB);
+		REQUIRE(stats.myAllocationCount == 10000u);
+		REQUIRE(stats.myAllocationCount - stats.myFreeCount == offsets.size());
+
+		uint32_t histogramBlockCount = 0u;
+		for (uint32_t count : stats.myFreeBlockSizeHistogram)
+			histogramBlockCount += count;
+		REQUIRE(histogramBlockCount == stats.myFreeBlockCount);
+
+		for (uint32_t offset : offsets)
+			REQUIRE(page.Free(offset));
+
+		stats = page.GetStats();
+		REQUIRE(stats.myInUseBytes == 0u);
+		REQUIRE(stats.myFreeBlockCount == 1u);
+		REQUIRE(stats.myLargestFreeBlockSize == 8 * DBZ_MB);
+
+		dbz::MemoryPage::Destroy(page);
+	}
+}
+
+TEST_CASE("MemoryPage_CanAllocateAndFreeInBatches", "[Memory], [MemoryPage]")
+{
+	const dbz::MemoryPage::SelectionMethod selectionMethods[] =
+	{
+		dbz::MemoryPage::SelectionMethod::FIRST_FIT,
+		dbz::MemoryPage::SelectionMethod::BEST_FIT,
+		dbz::MemoryPage::SelectionMethod::TLSF,
+		dbz::MemoryPage::SelectionMethod::BUDDY
+	};
+
+	for (dbz::MemoryPage::SelectionMethod selectionMethod : selectionMethods)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(DBZ_MB, selectionMethod);
+
+		uint32_t offsets[256];
+		REQUIRE(page.AllocateBatch(DBZ_KB, 256u, offsets) == 256u);
+		for (uint32_t i = 0u; i < 256u; ++i)
+			REQUIRE(page.GetAllocationSize(offsets[i]) == DBZ_KB);
+
+		std::sort(std::begin(offsets), std::end(offsets));
+		for (uint32_t i = 1u; i < 256u; ++i)
+			REQUIRE(offsets[i] >= offsets[i - 1u] + DBZ_KB);
+
+		// Freed out of order, the batch sorts them
+		std::reverse(std::begin(offsets), std::end(offsets));
+		REQUIRE(page.FreeBatch(offsets, 256u) == 256u);
+		REQUIRE(page.FreeBatch(offsets, 256u) == 0u);
+
+		dbz::MemoryPageStats stats = page.GetStats();
+		REQUIRE(stats.myInUseBytes == 0u);
+		REQUIRE(stats.myFreeBlockCount == 1u);
+		REQUIRE(stats.myLargestFreeBlockSize == DBZ_MB);
+		REQUIRE(stats.myAllocationCount == 256u);
+		REQUIRE(stats.myFreeCount == 256u);
+		REQUIRE(stats.myFailedFreeCount == 256u);
+
+		dbz::MemoryPage::Destroy(page);
+	}
+}
+
+TEST_CASE("MemoryPage_AllocateBatchCarvesFreeBlocks", "[Memory], [MemoryPage]")
+{
+	const dbz::MemoryPage::SelectionMethod selectionMethods[] =
+	{
+		dbz::MemoryPage::SelectionMethod::FIRST_FIT,
+		dbz::MemoryPage::SelectionMethod::BEST_FIT,
+		dbz::MemoryPage::SelectionMethod::TLSF
+	};
+
+	for (dbz::MemoryPage::SelectionMethod selectionMethod : selectionMethods)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(16 * DBZ_KB, selectionMethod);
+
+		// Holes of 3 KB and 5 KB, the rest of the page is in use
+		uint32_t first = page.Allocate(3 * DBZ_KB);
+		uint32_t second = page.Allocate(DBZ_KB);
+		uint32_t third = page.Allocate(5 * DBZ_KB);
+		REQUIRE(page.Allocate(7 * DBZ_KB) != UINT32_MAX);
+		REQUIRE(page.Free(first));
+		REQUIRE(page.Free(third));
+
+		// Aligned allocations leave padding in the holes, which stays free
+		uint32_t offsets[16];
+		uint32_t allocatedCount = page.AllocateBatch(1000u, 16u, offsets, 256u);
+		REQUIRE(allocatedCount == 8u);
+		for (uint32_t i = 0u; i < allocatedCount; ++i)
+		{
+			REQUIRE(offsets[i] % 256u == 0u);
+			REQUIRE(((offsets[i] >= first && offsets[i] + 1000u <= first + 3 * DBZ_KB) || (offsets[i] >= third && offsets[i] + 1000u <= third + 5 * DBZ_KB)));
+		}
+
+		dbz::MemoryPageStats stats = page.GetStats();
+		REQUIRE(stats.myInUseBytes == 8 * DBZ_KB + 8000u);
+		REQUIRE(stats.myFailedAllocationCount == 8u);
+		REQUIRE(stats.myInUseBytes + stats.myFreeBytes == 16 * DBZ_KB);
+
+		REQUIRE(page.FreeBatch(offsets, allocatedCount) == allocatedCount);
+		REQUIRE(page.Free(second));
+		REQUIRE(page.Allocate(9 * DBZ_KB) == 0u);
+
+		dbz::MemoryPage::Destroy(page);
+	}
+}
+
+TEST_CASE("MemoryPage_BatchesMatchSingleCalls_StressTest", "[Memory], [MemoryPage], [StressTest]")
+{
+	const dbz::MemoryPage::SelectionMethod selectionMethods[] =
+	{
+		dbz::MemoryPage::SelectionMethod::FIRST_FIT,
+		dbz::MemoryPage::SelectionMethod::BEST_FIT,
+		dbz::MemoryPage::SelectionMethod::TLSF,
+		dbz::MemoryPage::SelectionMethod::BUDDY
+	};
+
+	for (dbz::MemoryPage::SelectionMethod selectionMethod : selectionMethods)
+	{
+		dbz::MemoryPage page = dbz::MemoryPage::Create(8 * DBZ_MB, selectionMethod);
+		std::vector<uint8_t> memory(8 * DBZ_MB);
+
+		std::vector<std::pair<uint32_t, uint32_t>> allocations;
+		uint32_t batchOffsets[64];
+		for (int i = 0; i < 2000; ++i)
+		{
+			uint32_t size = static_cast<uint32_t>(rand()) % DBZ_KB + 1u;
+			uint32_t alignment = 1u << (static_cast<uint32_t>(rand()) % 7u);
+			uint32_t count = static_cast<uint32_t>(rand()) % 64u + 1u;
+
+			uint32_t allocatedCount = page.AllocateBatch(size, count, batchOffsets, alignment);
+			for (uint32_t j = 0u; j < allocatedCount; ++j)
+			{
+				REQUIRE(batchOffsets[j] % alignment == 0u);
+				std::memset(memory.data() + batchOffsets[j], i & 0xFF, size);
+				allocations.emplace_back(batchOffsets[j], static_cast<uint32_t>(i));
+			}
+
+			// Free a random batch, mixing single frees in
+			uint32_t freeCount = std::min<uint32_t>(static_cast<uint32_t>(rand()) % 64u, static_cast<uint32_t>(allocations.size()));
+			for (uint32_t j = 0u; j < freeCount; ++j)
+			{
+				uint32_t index = static_cast<uint32_t>(rand()) % allocations.size();
+				REQUIRE(memory[allocations[index].first] == static_cast<uint8_t>(allocations[index].second));
+				batchOffsets[j] = allocations[index].first;
+				allocations[index] = allocations.back();
+				allocations.pop_back();
+			}
+
+			if (rand() % 4 == 0)
+			{
+				for (uint32_t j = 0u; j < freeCount; ++j)
+					REQUIRE(page.Free(batchOffsets[j]));
+			}
+			else
+			{
+				REQUIRE(page.FreeBatch(batchOffsets, freeCount) == freeCount);
+			}
+		}
+
+		dbz::MemoryPageStats stats = page.GetStats();
+		REQUIRE(stats.myInUseBytes + stats.myFreeBytes == 8 * DBZ_MB);
+		REQUIRE(stats.myAllocationCount - stats.myFreeCount == allocations.size());
+
+		std::vector<uint32_t> offsets;
+		for (const auto& allocation : allocations)
+		{
+			REQUIRE(memory[allocation.first] == static_cast<uint8_t>(allocation.second));
+			offsets.push_back(allocation.first);
+		}
+		REQUIRE(page.FreeBatch(offsets.data(), static_cast<uint32_t>(offsets.size())) == offsets.size());
+
+		stats = page.GetStats();
+		REQUIRE(stats.myInUseBytes == 0u);
+		REQUIRE(stats.myFreeBlockCount == 1u);
+		REQUIRE(stats.myLargestFreeBlockSize == 8 * DBZ_MB);
+
+		dbz::MemoryPage::Destroy(page);
+	}
+}
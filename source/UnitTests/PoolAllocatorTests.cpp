@@ -0,0 +1,161 @@
+#include <catch/catch.hpp>
+
+#include "Memory/PoolAllocator.h"
+
+namespace
+{
+	struct TestObject
+	{
+		TestObject(int aValue)
+			: myValue(aValue)
+		{
+			++ourLiveCount;
+		}
+
+		~TestObject() { --ourLiveCount; }
+
+		int myValue;
+		float myPadding[3];
+
+		static int ourLiveCount;
+	};
+
+	int TestObject::ourLiveCount = 0;
+}
+
+TEST_CASE("PoolAllocator_PoolLifeTimeManagedThroughStaticFunctions", "[Memory], [PoolAllocator]")
+{
+	dbz::PoolAllocator<TestObject> pool = dbz::PoolAllocator<TestObject>::Create(64u);
+	dbz::PoolAllocator<TestObject>::Destroy(pool);
+}
+
+TEST_CASE("PoolAllocator_CanConstructAndDestructObjects", "[Memory], [PoolAllocator]")
+{
+	dbz::PoolAllocator<TestObject> pool = dbz::PoolAllocator<TestObject>::Create(64u);
+
+	TestObject* object = pool.Construct(7);
+	REQUIRE(object != nullptr);
+	REQUIRE(object->myValue == 7);
+	REQUIRE(TestObject::ourLiveCount == 1);
+	REQUIRE(pool.GetStats().myLiveObjectCount == 1u);
+
+	pool.Destruct(object);
+	REQUIRE(TestObject::ourLiveCount == 0);
+	REQUIRE(pool.GetStats().myLiveObjectCount == 0u);
+
+	// Freed slot is reused
+	REQUIRE(pool.Construct(8) == object);
+	pool.Destruct(object);
+
+	dbz::PoolAllocator<TestObject>::Destroy(pool);
+}
+
+TEST_CASE("PoolAllocator_SlabsAreCacheLineAligned", "[Memory], [PoolAllocator]")
+{
+	dbz::PoolAllocator<TestObject> pool = dbz::PoolAllocator<TestObject>::Create(3u);
+
+	TestObject* objects[7];
+	for (TestObject*& object : objects)
+		object = pool.Construct(0);
+
+	REQUIRE(reinterpret_cast<uintptr_t>(objects[0]) % dbz::CACHE_LINE_SIZE == 0u);
+	REQUIRE(reinterpret_cast<uintptr_t>(objects[3]) % dbz::CACHE_LINE_SIZE == 0u);
+	REQUIRE(reinterpret_cast<uintptr_t>(objects[6]) % dbz::CACHE_LINE_SIZE == 0u);
+
+	for (TestObject* object : objects)
+		pool.Destruct(object);
+
+	dbz::PoolAllocator<TestObject>::Destroy(pool);
+}
+
+TEST_CASE("PoolAllocator_EmptySlabsHoldOneObject", "[Memory], [PoolAllocator]")
+{
+	dbz::PoolAllocator<TestObject> pool = dbz::PoolAllocator<TestObject>::Create(0u);
+
+	TestObject* object = pool.Construct(1);
+	TestObject* objects[3];
+	REQUIRE(pool.ConstructBatch(objects, 3u, 2) == 3u);
+	REQUIRE(object->myValue == 1);
+	REQUIRE(pool.GetStats().mySlabCount == 4u);
+	REQUIRE(pool.GetStats().myCapacity == 4u);
+
+	pool.DestructBatch(objects, 3u);
+	pool.Destruct(object);
+	dbz::PoolAllocator<TestObject>::Destroy(pool);
+}
+
+TEST_CASE("PoolAllocator_GrowingDoesNotMoveLiveObjects", "[Memory], [PoolAllocator]")
+{
+	dbz::PoolAllocator<TestObject> pool = dbz::PoolAllocator<TestObject>::Create(4u);
+
+	TestObject* first = pool.Construct(42);
+	std::vector<TestObject*> objects;
+	for (int i = 0; i < 100; ++i)
+		objects.push_back(pool.Construct(i));
+
+	REQUIRE(first->myValue == 42);
+	for (int i = 0; i < 100; ++i)
+		REQUIRE(objects[i]->myValue == i);
+
+	const dbz::PoolAllocator<TestObject>::Stats& stats = pool.GetStats();
+	REQUIRE(stats.mySlabCount == 26u);
+	REQUIRE(stats.myCapacity == 104u);
+	REQUIRE(stats.myLiveObjectCount == 101u);
+
+	pool.Destruct(first);
+	for (TestObject* object : objects)
+		pool.Destruct(object);
+
+	REQUIRE(stats.myLiveObjectCount == 0u);
+	REQUIRE(stats.myPeakLiveObjectCount == 101u);
+
+	dbz::PoolAllocator<TestObject>::Destroy(pool);
+}
+
+TEST_CASE("PoolAllocator_CanConstructAndDestructInBatches", "[Memory], [PoolAllocator]")
+{
+	dbz::PoolAllocator<TestObject> pool = dbz::PoolAllocator<TestObject>::Create(16u);
+
+	TestObject* objects[100];
+	REQUIRE(pool.ConstructBatch(objects, 100u, 5) == 100u);
+	REQUIRE(TestObject::ourLiveCount == 100);
+	REQUIRE(pool.GetStats().mySlabCount == 7u);
+	for (TestObject* object : objects)
+		REQUIRE(object->myValue == 5);
+
+	pool.DestructBatch(objects, 100u);
+	REQUIRE(TestObject::ourLiveCount == 0);
+	REQUIRE(pool.GetStats().myLiveObjectCount == 0u);
+
+	dbz::PoolAllocator<TestObject>::Destroy(pool);
+}
+
+TEST_CASE("PoolAllocator_ConstructionDestruction_StressTest", "[Memory], [PoolAllocator], [StressTest]")
+{
+	dbz::PoolAllocator<TestObject> pool = dbz::PoolAllocator<TestObject>::Create(256u);
+
+	std::vector<TestObject*> objects;
+	for (int i = 0; i < 100000; ++i)
+	{
+		if (objects.empty() || rand() % 3)
+		{
+			objects.push_back(pool.Construct(i));
+		}
+		else
+		{
+			uint32_t index = static_cast<uint32_t>(rand()) % objects.size();
+			pool.Destruct(objects[index]);
+			objects[index] = objects.back();
+			objects.pop_back();
+		}
+	}
+
+	REQUIRE(pool.GetStats().myLiveObjectCount == objects.size());
+
+	for (TestObject* object : objects)
+		pool.Destruct(object);
+
+	REQUIRE(TestObject::ourLiveCount == 0);
+
+	dbz::PoolAllocator<TestObject>::Destroy(pool);
+}
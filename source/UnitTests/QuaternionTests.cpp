@@ -2,6 +2,103 @@
 
 #include "Math/Quaternion.h"
 
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	// Odd so the batches have a tail
+	static constexpr uint32_t locBatchCount = 1027u;
+
+	float RandomFloat()
+	{
+		return static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0f - 1.0f;
+	}
+
+	Quaternion CreateRandomQuaternion()
+	{
+		Vector3 axis{ RandomFloat(), RandomFloat(), RandomFloat() + 2.0f };
+		return Quaternion{ axis, Math::Radian(RandomFloat() * 2.0f * Math::PI) };
+	}
+
+	struct Streams
+	{
+		explicit Streams(uint32_t aCount)
+			: myX(aCount), myY(aCount), myZ(aCount), myW(aCount)
+		{ }
+
+		Quaternion::Stream GetStream() { return Quaternion::Stream{ myX.data(), myY.data(), myZ.data(), myW.data() }; }
+
+		void Set(uint32_t anIndex, const Quaternion& aQuaternion)
+		{
+			myX[anIndex] = aQuaternion.myAxis.x;
+			myY[anIndex] = aQuaternion.myAxis.y;
+			myZ[anIndex] = aQuaternion.myAxis.z;
+			myW[anIndex] = aQuaternion.myValue;
+		}
+
+		void RequireEqual(uint32_t anIndex, const double someExpected[4], double aMargin) const
+		{
+			REQUIRE(myX[anIndex] == Approx(someExpected[0]).margin(aMargin));
+			REQUIRE(myY[anIndex] == Approx(someExpected[1]).margin(aMargin));
+			REQUIRE(myZ[anIndex] == Approx(someExpected[2]).margin(aMargin));
+			REQUIRE(myW[anIndex] == Approx(someExpected[3]).margin(aMargin));
+		}
+
+		void RequireEqual(uint32_t anIndex, const Quaternion& anExpected, double aMargin) const
+		{
+			const double expected[4] = { anExpected.myAxis.x, anExpected.myAxis.y, anExpected.myAxis.z, anExpected.myValue };
+			RequireEqual(anIndex, expected, aMargin);
+		}
+
+		std::vector<float> myX;
+		std::vector<float> myY;
+		std::vector<float> myZ;
+		std::vector<float> myW;
+	};
+
+	void GetElements(const Quaternion& aQuaternion, double someElementsOut[4])
+	{
+		someElementsOut[0] = aQuaternion.myAxis.x;
+		someElementsOut[1] = aQuaternion.myAxis.y;
+		someElementsOut[2] = aQuaternion.myAxis.z;
+		someElementsOut[3] = aQuaternion.myValue;
+	}
+
+	void RequireReferenceMatrix(const Quaternion& aQuaternion, const Matrix44& aMatrix)
+	{
+		double x = aQuaternion.myAxis.x, y = aQuaternion.myAxis.y, z = aQuaternion.myAxis.z, w = aQuaternion.myValue;
+		const double expected[4][4] = {
+			{ 1.0 - 2.0 * (y * y + z * z), 2.0 * (x * y + w * z), 2.0 * (x * z - w * y), 0.0 },
+			{ 2.0 * (x * y - w * z), 1.0 - 2.0 * (x * x + z * z), 2.0 * (y * z + w * x), 0.0 },
+			{ 2.0 * (x * z + w * y), 2.0 * (y * z - w * x), 1.0 - 2.0 * (x * x + y * y), 0.0 },
+			{ 0.0, 0.0, 0.0, 1.0 } };
+
+		for (unsigned int i = 0u; i < 4u; ++i)
+		{
+			for (unsigned int j = 0u; j < 4u; ++j)
+				REQUIRE(aMatrix[i][j] == Approx(expected[i][j]).margin(2e-7));
+		}
+	}
+
+	// Double precision slerp along the shortest arc
+	void ComputeReferenceSlerp(const Quaternion& aFrom, const Quaternion& aTo, double aFactor, double someResultOut[4])
+	{
+		double from[4], to[4];
+		GetElements(aFrom, from);
+		GetElements(aTo, to);
+
+		double cosAngle = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+		double toSign = cosAngle < 0.0 ? -1.0 : 1.0;
+		double angle = std::acos(std::fmin(cosAngle * toSign, 1.0));
+		double sinAngle = std::sin(angle);
+		double fromFactor = sinAngle > 1e-12 ? std::sin((1.0 - aFactor) * angle) / sinAngle : 1.0 - aFactor;
+		double toFactor = (sinAngle > 1e-12 ? std::sin(aFactor * angle) / sinAngle : aFactor) * toSign;
+		for (unsigned int i = 0u; i < 4u; ++i)
+			someResultOut[i] = from[i] * fromFactor + to[i] * toFactor;
+	}
+}
+
 TEST_CASE("Quaternion_CanBeDefaultConstructed", "[Math], [Quaternion]")
 {
 	Quaternion quaternion;
@@ -11,3 +108,146 @@ TEST_CASE("Quaternion_CanBeDefaultConstructed", "[Math], [Quaternion]")
 	REQUIRE(quaternion.myAxis.z == Approx(0.0f));
 	REQUIRE(quaternion.myValue == 1.0f);
 }
+
+TEST_CASE("Quaternion_MultiplicationMatchesHamiltonProduct_StressTest", "[Math], [Quaternion], [StressTest]")
+{
+	for (int i = 0; i < 10000; ++i)
+	{
+		Vector3 axis0{ static_cast<float>(rand()) / RAND_MAX - 0.5f, static_cast<float>(rand()) / RAND_MAX - 0.5f, static_cast<float>(rand()) / RAND_MAX + 0.1f };
+		Vector3 axis1{ static_cast<float>(rand()) / RAND_MAX + 0.1f, static_cast<float>(rand()) / RAND_MAX - 0.5f, static_cast<float>(rand()) / RAND_MAX - 0.5f };
+		Quaternion quaternion0{ axis0, Math::Radian(static_cast<float>(rand()) / RAND_MAX * 2.0f * Math::PI) };
+		Quaternion quaternion1{ axis1, Math::Radian(static_cast<float>(rand()) / RAND_MAX * 2.0f * Math::PI) };
+
+		Quaternion result = quaternion0 * quaternion1;
+
+		const Vector3& a = quaternion0.myAxis;
+		const Vector3& b = quaternion1.myAxis;
+		float aw = quaternion0.myValue;
+		float bw = quaternion1.myValue;
+		Vector3 expectedAxis = a.Cross(b) + b * aw + a * bw;
+		float expectedValue = aw * bw - a.Dot(b);
+
+		REQUIRE(result.myAxis.x == Approx(expectedAxis.x).margin(1e-6f));
+		REQUIRE(result.myAxis.y == Approx(expectedAxis.y).margin(1e-6f));
+		REQUIRE(result.myAxis.z == Approx(expectedAxis.z).margin(1e-6f));
+		REQUIRE(result.myValue == Approx(expectedValue).margin(1e-6f));
+	}
+}
+
+TEST_CASE("Quaternion_CanBeConjugatedAndNormalized", "[Math], [Quaternion]")
+{
+	Quaternion quaternion{ Vector3{ 1.0f, 2.0f, 3.0f }, Math::Degree(90.0f) };
+	Quaternion conjugate = quaternion.Conjugate();
+
+	REQUIRE(conjugate.myAxis.x == -quaternion.myAxis.x);
+	REQUIRE(conjugate.myAxis.y == -quaternion.myAxis.y);
+	REQUIRE(conjugate.myAxis.z == -quaternion.myAxis.z);
+	REQUIRE(conjugate.myValue == quaternion.myValue);
+
+	// Rotation times its conjugate is the identity
+	Quaternion identity = quaternion * conjugate;
+	REQUIRE(identity.myAxis.x == Approx(0.0f).margin(1e-6f));
+	REQUIRE(identity.myAxis.y == Approx(0.0f).margin(1e-6f));
+	REQUIRE(identity.myAxis.z == Approx(0.0f).margin(1e-6f));
+	REQUIRE(identity.myValue == Approx(1.0f));
+
+	Quaternion scaled = quaternion * Quaternion{ Vector3{ 0.0f, 0.0f, 1.0f }, Math::Degree(0.0f) };
+	REQUIRE(scaled.Dot(scaled) == Approx(1.0f));
+	Quaternion normalized = (quaternion * quaternion * quaternion).Normalize();
+	REQUIRE(normalized.Dot(normalized) == Approx(1.0f).epsilon(1e-6f));
+}
+
+TEST_CASE("Quaternion_MatricesMatchReference_StressTest", "[Math], [Quaternion], [StressTest]")
+{
+	std::vector<Quaternion> quaternions(locBatchCount);
+	std::vector<Matrix44> matrices(locBatchCount);
+	for (uint32_t i = 0u; i < locBatchCount; ++i)
+		quaternions[i] = CreateRandomQuaternion();
+
+	Quaternion::ToMatrices(quaternions.data(), matrices.data(), locBatchCount);
+	for (uint32_t i = 0u; i < locBatchCount; ++i)
+	{
+		RequireReferenceMatrix(quaternions[i], quaternions[i].GetMatrix());
+		RequireReferenceMatrix(quaternions[i], matrices[i]);
+	}
+}
+
+TEST_CASE("Quaternion_CanNormalizeInBatches", "[Math], [Quaternion]")
+{
+	Streams quaternions{ locBatchCount };
+	for (uint32_t i = 0u; i < locBatchCount; ++i)
+	{
+		quaternions.myX[i] = RandomFloat() * 10.0f;
+		quaternions.myY[i] = RandomFloat() * 10.0f;
+		quaternions.myZ[i] = RandomFloat() * 10.0f;
+		quaternions.myW[i] = RandomFloat() * 10.0f + 11.0f;
+	}
+
+	Streams results{ locBatchCount };
+	Quaternion::NormalizeBatch(quaternions.GetStream(), results.GetStream(), locBatchCount);
+	for (uint32_t i = 0u; i < locBatchCount; ++i)
+	{
+		double x = quaternions.myX[i], y = quaternions.myY[i], z = quaternions.myZ[i], w = quaternions.myW[i];
+		double length = std::sqrt(x * x + y * y + z * z + w * w);
+		const double expected[4] = { x / length, y / length, z / length, w / length };
+		results.RequireEqual(i, expected, 3e-7);
+	}
+
+	// Written over the input
+	Quaternion::NormalizeBatch(quaternions.GetStream(), quaternions.GetStream(), locBatchCount);
+	REQUIRE(quaternions.myX == results.myX);
+	REQUIRE(quaternions.myW == results.myW);
+}
+
+TEST_CASE("Quaternion_CanInterpolateInBatches", "[Math], [Quaternion]")
+{
+	std::vector<Quaternion> from(locBatchCount);
+	std::vector<Quaternion> to(locBatchCount);
+	Streams fromStreams{ locBatchCount };
+	Streams toStreams{ locBatchCount };
+	for (uint32_t i = 0u; i < locBatchCount; ++i)
+	{
+		from[i] = CreateRandomQuaternion();
+		to[i] = CreateRandomQuaternion();
+		fromStreams.Set(i, from[i]);
+		toStreams.Set(i, to[i]);
+	}
+
+	Streams results{ locBatchCount };
+	for (float factor : { 0.0f, 0.1f, 0.25f, 0.5f, 0.75f, 0.9f, 1.0f })
+	{
+		Quaternion::NlerpBatch(fromStreams.GetStream(), toStreams.GetStream(), factor, results.GetStream(), locBatchCount);
+		for (uint32_t i = 0u; i < locBatchCount; ++i)
+		{
+			double fromElements[4], toElements[4], expected[4];
+			GetElements(from[i], fromElements);
+			GetElements(to[i], toElements);
+			double toSign = from[i].Dot(to[i]) < 0.0f ? -1.0 : 1.0;
+			double lengthSquare = 0.0;
+			for (unsigned int j = 0u; j < 4u; ++j)
+			{
+				expected[j] = fromElements[j] * (1.0 - factor) + toElements[j] * factor * toSign;
+				lengthSquare += expected[j] * expected[j];
+			}
+			for (unsigned int j = 0u; j < 4u; ++j)
+				expected[j] /= std::sqrt(lengthSquare);
+
+			results.RequireEqual(i, expected, 3e-7);
+			results.RequireEqual(i, Quaternion::Nlerp(from[i], to[i], factor), 3e-7);
+		}
+
+		Quaternion::SlerpBatch(fromStreams.GetStream(), toStreams.GetStream(), factor, results.GetStream(), locBatchCount);
+		for (uint32_t i = 0u; i < locBatchCount; ++i)
+		{
+			double expected[4];
+			ComputeReferenceSlerp(from[i], to[i], factor, expected);
+			results.RequireEqual(i, expected, 1.5e-6);
+			results.RequireEqual(i, Quaternion::Slerp(from[i], to[i], factor), 1.5e-6);
+		}
+	}
+
+	// Interpolating a rotation with itself gives it back
+	Quaternion::SlerpBatch(fromStreams.GetStream(), fromStreams.GetStream(), 0.3f, results.GetStream(), locBatchCount);
+	for (uint32_t i = 0u; i < locBatchCount; ++i)
+		results.RequireEqual(i, from[i], 1.5e-6);
+}
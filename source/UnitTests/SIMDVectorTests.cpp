@@ -346,3 +346,153 @@ TEST_CASE("SIMDVector_CanBeShuffled", "[Common], [SIMDVector]")
 	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(result, 2) == SIMD_VECTOR_INDEX_OPERATOR(vector1, 1));
 	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(result, 3) == SIMD_VECTOR_INDEX_OPERATOR(vector1, 3));
 }
+
+TEST_CASE("SIMDVector_CanWriteElements", "[Common], [SIMDVector]")
+{
+	SIMD::Vector vector = SIMD::Load(1.0f, 2.0f, 3.0f, 4.0f);
+	SIMD_VECTOR_INDEX_OPERATOR(vector, 2) = 5.0f;
+
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(vector, 0) == 1.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(vector, 1) == 2.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(vector, 2) == 5.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(vector, 3) == 4.0f);
+}
+
+TEST_CASE("SIMDVector_CompiledInstructionSetIsSupported", "[Common], [SIMDVector]")
+{
+	// Running the tests at all means the CPU supports what they were compiled for
+	REQUIRE(static_cast<int>(SIMD::GetSupportedInstructionSet()) >= static_cast<int>(SIMD::ourCompiledInstructionSet));
+	REQUIRE(SIMD::GetSupportedInstructionSet() == SIMD::GetSupportedInstructionSet());
+
+#if defined(__SSE2__) && !defined(DBZ_SIMD_SCALAR)
+	// x86-64 compilers always have SSE2, so vectors never fall back to scalar code there
+	REQUIRE(SIMD::ourCompiledInstructionSet != SIMD::InstructionSet::SCALAR);
+#endif // __SSE2__ && !DBZ_SIMD_SCALAR
+}
+
+TEST_CASE("SIMDVector_CanComputeDotProducts", "[Common], [SIMDVector]")
+{
+	SIMD::Vector vector0 = SIMD::Load(1.0f, 2.0f, 3.0f, 4.0f);
+	SIMD::Vector vector1 = SIMD::Load(4.0f, 3.0f, 2.0f, 1.0f);
+	SIMD::Vector dot = SIMD::Dot(vector0, vector1);
+	SIMD::Vector dot3 = SIMD::Dot3(vector0, vector1);
+
+	for (unsigned int i = 0u; i < 4u; ++i)
+	{
+		REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(dot, i) == Approx(20.0f));
+		REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(dot3, i) == Approx(16.0f));
+	}
+	REQUIRE(SIMD::GetX(dot) == Approx(20.0f));
+}
+
+TEST_CASE("SIMDVector_CanComputeMinMaxAndAbs", "[Common], [SIMDVector]")
+{
+	SIMD::Vector vector0 = SIMD::Load(1.0f, -2.0f, 3.0f, -4.0f);
+	SIMD::Vector vector1 = SIMD::Load(-1.0f, 2.0f, 5.0f, -5.0f);
+	SIMD::Vector minimum = SIMD::Min(vector0, vector1);
+	SIMD::Vector maximum = SIMD::Max(vector0, vector1);
+	SIMD::Vector absolute = SIMD::Abs(vector0);
+	SIMD::Vector negated = SIMD::Negate(vector0);
+
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(minimum, 0) == -1.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(minimum, 1) == -2.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(minimum, 2) == 3.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(minimum, 3) == -5.0f);
+
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(maximum, 0) == 1.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(maximum, 1) == 2.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(maximum, 2) == 5.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(maximum, 3) == -4.0f);
+
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(absolute, 0) == 1.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(absolute, 1) == 2.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(absolute, 2) == 3.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(absolute, 3) == 4.0f);
+
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(negated, 0) == -1.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(negated, 1) == 2.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(negated, 2) == -3.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(negated, 3) == 4.0f);
+}
+
+TEST_CASE("SIMDVector_CanCompareAndSelect", "[Common], [SIMDVector]")
+{
+	SIMD::Vector vector0 = SIMD::Load(1.0f, 2.0f, 3.0f, 4.0f);
+	SIMD::Vector vector1 = SIMD::Load(4.0f, 2.0f, 2.0f, 1.0f);
+
+	REQUIRE(SIMD::GetMask(SIMD::CompareEqual(vector0, vector1)) == 0x2);
+	REQUIRE(SIMD::GetMask(SIMD::CompareLess(vector0, vector1)) == 0x1);
+	REQUIRE(SIMD::GetMask(SIMD::CompareLessEqual(vector0, vector1)) == 0x3);
+	REQUIRE(SIMD::GetMask(SIMD::CompareGreater(vector0, vector1)) == 0xC);
+	REQUIRE(SIMD::GetMask(SIMD::CompareGreaterEqual(vector0, vector1)) == 0xE);
+
+	SIMD::Vector lessEqual = SIMD::CompareLessEqual(vector0, vector1);
+	SIMD::Vector greaterEqual = SIMD::CompareGreaterEqual(vector0, vector1);
+	REQUIRE(SIMD::GetMask(SIMD::And(lessEqual, greaterEqual)) == 0x2);
+	REQUIRE(SIMD::GetMask(SIMD::Or(lessEqual, greaterEqual)) == 0xF);
+
+	SIMD::Vector selected = SIMD::Select(vector0, vector1, SIMD::CompareLess(vector0, vector1));
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(selected, 0) == 4.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(selected, 1) == 2.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(selected, 2) == 3.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(selected, 3) == 4.0f);
+}
+
+TEST_CASE("SIMDVector_CanLoadAndStoreArrays", "[Common], [SIMDVector]")
+{
+	alignas(16) float values[8] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
+	SIMD::Vector aligned = SIMD::Load(values);
+	SIMD::Vector unaligned = SIMD::LoadUnaligned(values + 1);
+
+	SIMD::Store(values + 4, aligned);
+	SIMD::StoreUnaligned(values + 3, unaligned);
+
+	const float expected[8] = { 1.0f, 2.0f, 3.0f, 2.0f, 3.0f, 4.0f, 5.0f, 4.0f };
+	for (unsigned int i = 0u; i < 8u; ++i)
+		REQUIRE(values[i] == expected[i]);
+}
+
+TEST_CASE("SIMDVector_SqrtAndReciprocalSqrtAreAccurate_StressTest", "[Common], [SIMDVector], [StressTest]")
+{
+	for (int i = 0; i < locStressTestCount; ++i)
+	{
+		float x = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 1000.0f + 1e-3f;
+		float y = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) + 1e-3f;
+		float z = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 1e6f + 1e-3f;
+		float w = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 1e-3f + 1e-6f;
+
+		SIMD::Vector vector = SIMD::Load(x, y, z, w);
+		SIMD::Vector squareRoot = SIMD::Sqrt(vector);
+		SIMD::Vector reciprocalSquareRoot = SIMD::ReciprocalSqrt(vector);
+
+		const float values[4] = { x, y, z, w };
+		for (unsigned int j = 0u; j < 4u; ++j)
+		{
+			REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(squareRoot, j) == sqrtf(values[j]));
+			// One Newton-Raphson step on the hardware estimate
+			double expected = 1.0 / sqrt(static_cast<double>(values[j]));
+			REQUIRE(fabs(SIMD_VECTOR_INDEX_OPERATOR(reciprocalSquareRoot, j) - expected) <= expected * 2.5e-7);
+		}
+	}
+
+	SIMD::Vector reciprocalOfZero = SIMD::ReciprocalSqrt(SIMD::Load(0.0f));
+	REQUIRE(std::isinf(SIMD::GetX(reciprocalOfZero)));
+}
+
+TEST_CASE("SIMDVector_CanRound", "[Common], [SIMDVector]")
+{
+	SIMD::Vector rounded = SIMD::Round(SIMD::Load(-1.7f, 0.4f, 2.5f, 3.5f));
+
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(rounded, 0) == -2.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(rounded, 1) == 0.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(rounded, 2) == 2.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(rounded, 3) == 4.0f);
+
+	// Values past 2^23 have no fraction bits and are kept as they are
+	rounded = SIMD::Round(SIMD::Load(-2.5f, -0.5f, 16777215.0f, -1.0e30f));
+
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(rounded, 0) == -2.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(rounded, 1) == 0.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(rounded, 2) == 16777215.0f);
+	REQUIRE(SIMD_VECTOR_INDEX_OPERATOR(rounded, 3) == -1.0e30f);
+}
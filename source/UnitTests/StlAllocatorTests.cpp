@@ -0,0 +1,155 @@
+#include <catch/catch.hpp>
+
+#include "Memory/StlAllocator.h"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <vector>
+
+#define DBZ_KB (1 << 10)
+#define DBZ_MB (1 << 20)
+
+namespace
+{
+	// Allocator using the default traits, counts live allocations
+	struct CountingAllocator
+	{
+		void* Allocate(size_t aSize, size_t anAlignment)
+		{
+			++myLiveAllocationCount;
+			return dbz::AllocateAligned(aSize, anAlignment);
+		}
+
+		void Free(void* aPointer)
+		{
+			--myLiveAllocationCount;
+			dbz::FreeAligned(aPointer);
+		}
+
+		int myLiveAllocationCount = 0;
+	};
+
+	template <typename T>
+	using CountingVector = std::vector<T, dbz::StlAllocator<T, CountingAllocator>>;
+}
+
+TEST_CASE("StlAllocator_VectorAllocatesFromFrameArena", "[Memory], [StlAllocator]")
+{
+	dbz::FrameArena arena = dbz::FrameArena::Create(DBZ_MB);
+
+	{
+		dbz::StlAllocator<int, dbz::FrameArena> allocator{ arena };
+		std::vector<int, dbz::StlAllocator<int, dbz::FrameArena>> values{ allocator };
+		for (int i = 0; i < 1000; ++i)
+			values.push_back(i);
+
+		REQUIRE(arena.GetUsedSize() >= 1000u * sizeof(int));
+		for (int i = 0; i < 1000; ++i)
+			REQUIRE(values[i] == i);
+	}
+
+	dbz::FrameArena::Destroy(arena);
+}
+
+TEST_CASE("StlAllocator_ListNodesComeFromPool", "[Memory], [StlAllocator]")
+{
+	// Slots big enough for the list nodes of the standard libraries we use
+	using Slot = std::aligned_storage<4 * sizeof(void*), alignof(void*)>::type;
+	dbz::PoolAllocator<Slot> pool = dbz::PoolAllocator<Slot>::Create(64u);
+
+	{
+		dbz::StlAllocator<int, dbz::PoolAllocator<Slot>> allocator{ pool };
+		std::list<int, dbz::StlAllocator<int, dbz::PoolAllocator<Slot>>> values{ allocator };
+		for (int i = 0; i < 100; ++i)
+			values.push_back(i);
+
+		REQUIRE(pool.GetStats().myLiveObjectCount >= 100u);
+
+		values.clear();
+		REQUIRE(pool.GetStats().myLiveObjectCount < 100u);
+	}
+
+	REQUIRE(pool.GetStats().myLiveObjectCount == 0u);
+	dbz::PoolAllocator<Slot>::Destroy(pool);
+}
+
+TEST_CASE("StlAllocator_MapAllocatesFromVirtualMemoryPage", "[Memory], [StlAllocator]")
+{
+	dbz::VirtualMemoryPage page = dbz::VirtualMemoryPage::Create(16 * DBZ_MB, 1u);
+
+	{
+		using Allocator = dbz::StlAllocator<std::pair<const int, int>, dbz::VirtualMemoryPage>;
+		std::map<int, int, std::less<int>, Allocator> values{ Allocator{ page } };
+		for (int i = 0; i < 1000; ++i)
+			values[i] = i * 2;
+
+		REQUIRE(page.GetPage().GetStats().myAllocationCount >= 1000u);
+		REQUIRE(values[500] == 1000);
+	}
+
+	REQUIRE(page.GetPage().GetStats().myInUseBytes == 0u);
+	dbz::VirtualMemoryPage::Destroy(page);
+}
+
+TEST_CASE("StlAllocator_AllocatorPropagatesOnMove", "[Memory], [StlAllocator]")
+{
+	CountingAllocator countingAllocator;
+	CountingAllocator countingAllocator2;
+
+	{
+		CountingVector<int> values{ dbz::StlAllocator<int, CountingAllocator>{ countingAllocator } };
+		values.resize(100u, 1);
+
+		// Move construction takes the memory along with the allocator
+		CountingVector<int> movedValues{ std::move(values) };
+		REQUIRE(movedValues.get_allocator().GetAllocator() == &countingAllocator);
+		REQUIRE(countingAllocator.myLiveAllocationCount == 1);
+
+		// Move assignment too, the old memory is released through the allocator that made it
+		CountingVector<int> values2{ dbz::StlAllocator<int, CountingAllocator>{ countingAllocator2 } };
+		values2.resize(10u, 2);
+		values2 = std::move(movedValues);
+		REQUIRE(values2.get_allocator().GetAllocator() == &countingAllocator);
+		REQUIRE(values2.size() == 100u);
+		REQUIRE(countingAllocator2.myLiveAllocationCount == 0);
+
+		// Copy assignment keeps the allocator of the destination
+		CountingVector<int> values3{ dbz::StlAllocator<int, CountingAllocator>{ countingAllocator2 } };
+		values3 = values2;
+		REQUIRE(values3.get_allocator().GetAllocator() == &countingAllocator2);
+		REQUIRE(countingAllocator2.myLiveAllocationCount == 1);
+
+		// Swap exchanges allocators
+		std::swap(values2, values3);
+		REQUIRE(values2.get_allocator().GetAllocator() == &countingAllocator2);
+		REQUIRE(values3.get_allocator().GetAllocator() == &countingAllocator);
+	}
+
+	REQUIRE(countingAllocator.myLiveAllocationCount == 0);
+	REQUIRE(countingAllocator2.myLiveAllocationCount == 0);
+}
+
+TEST_CASE("StlAllocator_AllocatorsCompareByEngineAllocator", "[Memory], [StlAllocator]")
+{
+	CountingAllocator countingAllocator;
+	CountingAllocator countingAllocator2;
+
+	dbz::StlAllocator<int, CountingAllocator> allocator{ countingAllocator };
+	dbz::StlAllocator<double, CountingAllocator> reboundAllocator{ allocator };
+	dbz::StlAllocator<int, CountingAllocator> allocator2{ countingAllocator2 };
+
+	REQUIRE(allocator == reboundAllocator);
+	REQUIRE(allocator != allocator2);
+}
+
+TEST_CASE("StlAllocator_ThrowsWhenEngineAllocatorRunsOut", "[Memory], [StlAllocator]")
+{
+	dbz::FrameArena arena = dbz::FrameArena::Create(DBZ_KB);
+
+	std::vector<int, dbz::StlAllocator<int, dbz::FrameArena>> values{ dbz::StlAllocator<int, dbz::FrameArena>{ arena } };
+	REQUIRE_THROWS_AS(values.reserve(DBZ_KB), std::bad_alloc);
+	REQUIRE(values.empty());
+
+	dbz::FrameArena::Destroy(arena);
+}
@@ -1,2 +1,3 @@
 #define CATCH_CONFIG_MAIN
-#include <catch/catch.hpp>
\ No newline at end of file
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch/catch.hpp>
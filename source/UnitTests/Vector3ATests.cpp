@@ -0,0 +1,79 @@
+#include <catch/catch.hpp>
+
+#include "Math/Quaternion.h"
+#include "Math/Vector3A.h"
+
+namespace
+{
+	static constexpr int locStressTestCount = 10000;
+
+	float RandomFloat()
+	{
+		return static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5f;
+	}
+
+	Vector3 CreateRandomVector3()
+	{
+		return Vector3{ RandomFloat(), RandomFloat(), RandomFloat() };
+	}
+
+	void RequireEqual(const Vector3A& aVector, const Vector3& anExpected, float aMargin)
+	{
+		REQUIRE(aVector.x == Approx(anExpected.x).margin(aMargin));
+		REQUIRE(aVector.y == Approx(anExpected.y).margin(aMargin));
+		REQUIRE(aVector.z == Approx(anExpected.z).margin(aMargin));
+	}
+}
+
+TEST_CASE("Vector3A_CanBeConverted", "[Math], [Vector3A]")
+{
+	Vector3A vector{ Vector3{ 1.0f, 2.0f, 3.0f } };
+	Vector3 vector3 = vector.ToVector3();
+	REQUIRE(vector3.x == 1.0f);
+	REQUIRE(vector3.y == 2.0f);
+	REQUIRE(vector3.z == 3.0f);
+
+	Vector4 vector4 = vector.ToVector4(4.0f);
+	REQUIRE(vector4.x == 1.0f);
+	REQUIRE(vector4.y == 2.0f);
+	REQUIRE(vector4.z == 3.0f);
+	REQUIRE(vector4.w == 4.0f);
+
+	// w is ignored, not only by the conversion but by every operation
+	Vector3A fromVector4{ Vector4{ 1.0f, 2.0f, 3.0f, 100.0f } };
+	REQUIRE(fromVector4.Dot(vector) == Approx(14.0f));
+	REQUIRE(fromVector4.ToVector4(0.0f).w == 0.0f);
+}
+
+TEST_CASE("Vector3A_MatchesVector3_StressTest", "[Math], [Vector3A], [StressTest]")
+{
+	for (int i = 0; i < locStressTestCount; ++i)
+	{
+		Vector3 left = CreateRandomVector3();
+		Vector3 right = CreateRandomVector3() + Vector3{ 0.0f, 0.0f, 1.0f }; // Never 0 so it can be normalized
+		Vector3A leftA{ left };
+		Vector3A rightA{ right };
+
+		RequireEqual(leftA + rightA, left + right, 1e-6f);
+		RequireEqual(leftA - rightA, left - right, 1e-6f);
+		RequireEqual(leftA * 3.0f, left * 3.0f, 1e-6f);
+		RequireEqual(-leftA, -left, 0.0f);
+		RequireEqual(leftA.Cross(rightA), left.Cross(right), 1e-6f);
+		RequireEqual(rightA.Normalize(), right.Normalize(), 1e-6f);
+		REQUIRE(leftA.Dot(rightA) == Approx(left.Dot(right)).margin(1e-6f));
+		REQUIRE(rightA.Length() == Approx(right.Length()));
+	}
+}
+
+TEST_CASE("Vector3A_QuaternionRotationMatchesMatrix_StressTest", "[Math], [Vector3A], [Quaternion], [StressTest]")
+{
+	for (int i = 0; i < locStressTestCount; ++i)
+	{
+		Vector3 axis = CreateRandomVector3() + Vector3{ 0.0f, 0.0f, 1.0f };
+		Quaternion rotation{ axis, Math::Radian(RandomFloat() * 2.0f * Math::PI) };
+		Vector3 vector = CreateRandomVector3() * 10.0f;
+
+		Vector4 expected = rotation.GetMatrix() * Vector4{ vector.x, vector.y, vector.z, 0.0f };
+		RequireEqual(rotation.Rotate(Vector3A{ vector }), Vector3{ expected.x, expected.y, expected.z }, 1e-5f);
+	}
+}
@@ -0,0 +1,39 @@
+#include <catch/catch.hpp>
+
+#include "Math/Vector4.h"
+
+namespace
+{
+	static constexpr int locStressTestCount = 10000;
+}
+
+TEST_CASE("Vector4_CanComputeDotProduct", "[Math], [Vector4]")
+{
+	Vector4 vector0{ 1.0f, 2.0f, 3.0f, 4.0f };
+	Vector4 vector1{ 4.0f, 3.0f, 2.0f, 1.0f };
+
+	REQUIRE(vector0.Dot(vector1) == Approx(20.0f));
+	REQUIRE(vector0.LengthSquare() == Approx(30.0f));
+	REQUIRE(vector0.Length() == Approx(sqrtf(30.0f)));
+}
+
+TEST_CASE("Vector4_CanBeNormalized_StressTest", "[Math], [Vector4], [StressTest]")
+{
+	for (int i = 0; i < locStressTestCount; ++i)
+	{
+		float x = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5f;
+		float y = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5f;
+		float z = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5f;
+		float w = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) + 0.1f; // +0.1 so the length is never 0
+
+		Vector4 vector{ x, y, z, w };
+		Vector4 normalized = vector.Normalize();
+		float length = sqrtf(x * x + y * y + z * z + w * w);
+
+		REQUIRE(normalized.x == Approx(x / length).margin(1e-6f));
+		REQUIRE(normalized.y == Approx(y / length).margin(1e-6f));
+		REQUIRE(normalized.z == Approx(z / length).margin(1e-6f));
+		REQUIRE(normalized.w == Approx(w / length).margin(1e-6f));
+		REQUIRE(normalized.Length() == Approx(1.0f));
+	}
+}
@@ -0,0 +1,182 @@
+#include <catch/catch.hpp>
+
+#include "Memory/VirtualMemoryPage.h"
+
+#include <cstring>
+
+#define DBZ_KB (1 << 10)
+#define DBZ_MB (1 << 20)
+#define DBZ_GB (1 << 30)
+
+TEST_CASE("VirtualMemoryPage_PageLifeTimeManagedThroughStaticFunctions", "[Memory], [VirtualMemoryPage]")
+{
+	dbz::VirtualMemoryPage page = dbz::VirtualMemoryPage::Create(DBZ_MB, 60u);
+	REQUIRE(page.GetMemory() != nullptr);
+	REQUIRE(page.GetReservedSize() == DBZ_MB);
+	REQUIRE(page.GetCommittedSize() == 0u);
+	dbz::VirtualMemoryPage::Destroy(page);
+}
+
+TEST_CASE("VirtualMemoryPage_CommitsMemoryAsAllocationsNeedIt", "[Memory], [VirtualMemoryPage]")
+{
+	dbz::VirtualMemoryPage page = dbz::VirtualMemoryPage::Create(DBZ_MB, 60u, dbz::MemoryPage::SelectionMethod::FIRST_FIT);
+
+	uint8_t* allocation = static_cast<uint8_t*>(page.Allocate(DBZ_KB));
+	REQUIRE(allocation == page.GetMemory());
+	REQUIRE(page.GetCommittedSize() == dbz::VirtualMemoryPage::ourDefaultCommitGranularity);
+	std::memset(allocation, 0xAB, DBZ_KB);
+
+	// Same granule, nothing new to commit
+	uint8_t* allocation2 = static_cast<uint8_t*>(page.Allocate(DBZ_KB));
+	REQUIRE(page.GetCommittedSize() == dbz::VirtualMemoryPage::ourDefaultCommitGranularity);
+
+	// Spans the rest of the first granule and two more
+	uint8_t* allocation3 = static_cast<uint8_t*>(page.Allocate(2 * dbz::VirtualMemoryPage::ourDefaultCommitGranularity));
+	REQUIRE(page.GetCommittedSize() == 3u * dbz::VirtualMemoryPage::ourDefaultCommitGranularity);
+	std::memset(allocation3, 0xCD, 2 * dbz::VirtualMemoryPage::ourDefaultCommitGranularity);
+	REQUIRE(allocation[DBZ_KB - 1] == 0xAB);
+
+	REQUIRE(page.Allocate(2 * DBZ_MB) == nullptr);
+	REQUIRE(page.Allocate(0u) == nullptr);
+
+	REQUIRE(page.Free(allocation));
+	REQUIRE(page.Free(allocation2));
+	REQUIRE(page.Free(allocation3));
+
+	dbz::VirtualMemoryPage::Destroy(page);
+}
+
+TEST_CASE("VirtualMemoryPage_EmptyGranulesAreDecommittedAfterDelay", "[Memory], [VirtualMemoryPage]")
+{
+	constexpr uint32_t granularity = dbz::VirtualMemoryPage::ourDefaultCommitGranularity;
+	dbz::VirtualMemoryPage page = dbz::VirtualMemoryPage::Create(DBZ_MB, 2u, dbz::MemoryPage::SelectionMethod::FIRST_FIT);
+
+	// First allocation shares its last granule with the second one
+	void* allocation = page.Allocate(granularity + DBZ_KB);
+	void* allocation2 = page.Allocate(DBZ_KB);
+	REQUIRE(page.GetCommittedSize() == 2u * granularity);
+
+	REQUIRE(page.Free(allocation));
+	page.Update();
+	REQUIRE(page.GetCommittedSize() == 2u * granularity);
+	page.Update();
+	REQUIRE(page.GetCommittedSize() == granularity);
+
+	// Allocating into an empty granule keeps it committed
+	REQUIRE(page.Free(allocation2));
+	page.Update();
+	allocation2 = page.Allocate(DBZ_KB);
+	page.Update();
+	page.Update();
+	REQUIRE(page.GetCommittedSize() == granularity);
+
+	// Decommitted memory is committed again and usable
+	allocation = page.Allocate(granularity);
+	REQUIRE(page.GetCommittedSize() == 2u * granularity);
+	std::memset(allocation, 0xEF, granularity);
+
+	REQUIRE(page.Free(allocation));
+	REQUIRE(page.Free(allocation2));
+	page.Update();
+	page.Update();
+	REQUIRE(page.GetCommittedSize() == 0u);
+
+	dbz::VirtualMemoryPage::Destroy(page);
+}
+
+TEST_CASE("VirtualMemoryPage_FreeFailsForPointersNotAllocated", "[Memory], [VirtualMemoryPage]")
+{
+	dbz::VirtualMemoryPage page = dbz::VirtualMemoryPage::Create(DBZ_MB, 60u);
+
+	int value = 0;
+	REQUIRE(page.Free(&value) == false);
+	REQUIRE(page.Free(nullptr) == false);
+
+	uint8_t* allocation = static_cast<uint8_t*>(page.Allocate(DBZ_KB));
+	REQUIRE(page.Free(allocation + 1) == false);
+	REQUIRE(page.Free(allocation));
+	REQUIRE(page.Free(allocation) == false);
+
+	dbz::VirtualMemoryPage::Destroy(page);
+}
+
+TEST_CASE("VirtualMemoryPage_BuddyBlocksAreCommittedWhole", "[Memory], [VirtualMemoryPage]")
+{
+	constexpr uint32_t granularity = dbz::VirtualMemoryPage::ourDefaultCommitGranularity;
+	dbz::VirtualMemoryPage page = dbz::VirtualMemoryPage::Create(DBZ_MB, 1u, dbz::MemoryPage::SelectionMethod::BUDDY);
+
+	// Rounded up to a block of two granules
+	uint8_t* allocation = static_cast<uint8_t*>(page.Allocate(granularity + 1u));
+	REQUIRE(page.GetCommittedSize() == 2u * granularity);
+	std::memset(allocation, 0x12, 2u * granularity);
+
+	REQUIRE(page.Free(allocation));
+	page.Update();
+	REQUIRE(page.GetCommittedSize() == 0u);
+
+	dbz::VirtualMemoryPage::Destroy(page);
+}
+
+TEST_CASE("VirtualMemoryPage_LargeSparsePageOnlyCommitsLiveData", "[Memory], [VirtualMemoryPage]")
+{
+	dbz::VirtualMemoryPage page = dbz::VirtualMemoryPage::Create(2u * DBZ_GB, 1u, dbz::MemoryPage::SelectionMethod::TLSF);
+	REQUIRE(page.GetMemory() != nullptr);
+
+	std::vector<void*> allocations;
+	for (int i = 0; i < 64; ++i)
+	{
+		allocations.push_back(page.Allocate(16 * DBZ_MB));
+		REQUIRE(allocations.back() != nullptr);
+	}
+
+	// Touch a single byte of each allocation, the rest of the range is never backed by the OS
+	for (void* allocation : allocations)
+		*static_cast<uint8_t*>(allocation) = 1u;
+
+	for (void* allocation : allocations)
+		REQUIRE(page.Free(allocation));
+
+	page.Update();
+	REQUIRE(page.GetCommittedSize() == 0u);
+
+	dbz::VirtualMemoryPage::Destroy(page);
+}
+
+TEST_CASE("VirtualMemoryPage_AllocationDeallocation_StressTest", "[Memory], [VirtualMemoryPage], [StressTest]")
+{
+	dbz::VirtualMemoryPage page = dbz::VirtualMemoryPage::Create(64 * DBZ_MB, 4u, dbz::MemoryPage::SelectionMethod::TLSF, 4 * DBZ_KB);
+
+	std::vector<std::pair<uint8_t*, uint32_t>> allocations;
+	for (int i = 0; i < 100000; ++i)
+	{
+		if (allocations.empty() || rand() % 2)
+		{
+			uint32_t size = static_cast<uint32_t>(rand()) % (64 * DBZ_KB) + 1u;
+			uint8_t* allocation = static_cast<uint8_t*>(page.Allocate(size, 16u));
+			REQUIRE(allocation != nullptr);
+
+			// Writing the whole allocation faults if any of its memory is not committed
+			std::memset(allocation, i & 0xFF, size);
+			allocations.emplace_back(allocation, size);
+		}
+		else
+		{
+			uint32_t index = static_cast<uint32_t>(rand()) % allocations.size();
+			REQUIRE(page.Free(allocations[index].first));
+			allocations[index] = allocations.back();
+			allocations.pop_back();
+		}
+
+		if (i % 100 == 0)
+			page.Update();
+	}
+
+	for (const std::pair<uint8_t*, uint32_t>& allocation : allocations)
+		REQUIRE(page.Free(allocation.first));
+
+	for (int i = 0; i < 4; ++i)
+		page.Update();
+	REQUIRE(page.GetCommittedSize() == 0u);
+
+	dbz::VirtualMemoryPage::Destroy(page);
+}